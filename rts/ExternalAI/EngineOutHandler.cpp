@@ -19,17 +19,31 @@
 #include "Sim/Units/CommandAI/Command.h"
 #include "Sim/Weapons/WeaponDef.h"
 #include "Net/Protocol/NetProtocol.h"
+#include "System/Config/ConfigHandler.h"
 #include "System/Log/ILog.h"
+#include "System/Threading/ThreadPool.h"
 #include "System/TimeProfiler.h"
 #include "System/SafeUtil.h"
 
 
+CONFIG(bool, AsyncSkirmishAIs).defaultValue(false).description("Run native skirmish AIs on a worker thread between sim frames; their events are batched per frame and delivered together with the Update event.");
+
 CR_BIND(CEngineOutHandler, )
 CR_REG_METADATA(CEngineOutHandler, (
 	CR_IGNORED(hostSkirmishAIs),
 	CR_IGNORED(teamSkirmishAIs),
 	CR_IGNORED(activeSkirmishAIs),
 
+	CR_IGNORED(asyncSkirmishAIs),
+	CR_IGNORED(asyncUpdateTask),
+	CR_IGNORED(asyncMutex),
+	CR_IGNORED(asyncCond),
+	CR_IGNORED(asyncRequest),
+	CR_IGNORED(asyncRequestResult),
+	CR_IGNORED(asyncUpdates),
+	CR_IGNORED(asyncUpdateDone),
+	CR_IGNORED(servingAsyncRequest),
+
 	CR_POSTLOAD(PostLoad)
 ))
 
@@ -47,6 +61,8 @@ static inline bool IsUnitInLosOrRadarOfAllyTeam(const CUnit& unit, const int all
 static CEngineOutHandler singleton;
 static unsigned int numInstances = 0;
 
+static thread_local bool asyncUpdateThread = false;
+
 CEngineOutHandler* CEngineOutHandler::GetInstance() {
 	// if more than one instance, some code called eoh->func()
 	// and created another after Destroy was already executed
@@ -65,6 +81,13 @@ void CEngineOutHandler::Create() {
 	numInstances += 1;
 }
 
+void CEngineOutHandler::Init() {
+	activeSkirmishAIs.reserve(16);
+
+	asyncUpdates = configHandler->GetBool("AsyncSkirmishAIs") && ThreadPool::HasThreads();
+	asyncUpdateDone = false;
+}
+
 void CEngineOutHandler::Destroy() {
 	if (numInstances != 1)
 		return;
@@ -91,11 +114,13 @@ void CEngineOutHandler::Destroy() {
 void CEngineOutHandler::PostLoad()
 {
 	AI_SCOPED_TIMER();
+	FinishAsyncUpdate();
 	DO_FOR_SKIRMISH_AIS(PostLoad())
 }
 
 void CEngineOutHandler::PreDestroy() {
 	AI_SCOPED_TIMER();
+	FinishAsyncUpdate();
 	DO_FOR_SKIRMISH_AIS(PreDestroy())
 }
 
@@ -109,6 +134,7 @@ void CEngineOutHandler::Load(std::istream* s, const uint8_t skirmishAIId) {
 	if (!ai.Active())
 		return;
 
+	FinishAsyncUpdate();
 	ai.Load(s);
 }
 
@@ -121,16 +147,127 @@ void CEngineOutHandler::Save(std::ostream* s, const uint8_t skirmishAIId) {
 	if (!ai.Active())
 		return;
 
+	FinishAsyncUpdate();
 	ai.Save(s);
 }
 
 
 void CEngineOutHandler::Update() {
 	AI_SCOPED_TIMER();
+
+	// asynchronous AIs get their Update event with the batch sent by LaunchAsyncUpdate
+	if (asyncUpdates)
+		return;
+
 	DO_FOR_SKIRMISH_AIS(Update(gs->frameNum))
 }
 
 
+void CEngineOutHandler::LaunchAsyncUpdate(bool sendUpdate) {
+	if (!asyncUpdates || activeSkirmishAIs.empty())
+		return;
+
+	FinishAsyncUpdate();
+	SCOPED_TIMER("AI");
+
+	for (uint8_t aiID: activeSkirmishAIs) {
+		if (sendUpdate)
+			hostSkirmishAIs[aiID].Update(gs->frameNum);
+
+		hostSkirmishAIs[aiID].SwapEventQueues();
+	}
+
+	asyncSkirmishAIs = activeSkirmishAIs;
+	asyncUpdateDone = false;
+	asyncUpdateTask = ThreadPool::Enqueue([this]() { RunAsyncUpdate(); });
+}
+
+void CEngineOutHandler::RunAsyncUpdate() {
+	// AI callbacks run QuadField queries (GetUnitsExact, etc) which use the
+	// per-thread caches and stamps of whichever pool worker this task landed
+	// on; borrow the reserved slot instead so synced for_mt jobs executing on
+	// that same worker index in the meantime keep theirs to themselves
+	const int poolThreadNum = ThreadPool::GetThreadNum();
+
+	ThreadPool::SetThreadNum(ThreadPool::RESERVED_THREAD_NUM);
+	asyncUpdateThread = true;
+
+	for (uint8_t aiID: asyncSkirmishAIs) {
+		hostSkirmishAIs[aiID].DispatchEvents();
+	}
+
+	asyncUpdateThread = false;
+	ThreadPool::SetThreadNum(poolThreadNum);
+
+	std::lock_guard<spring::mutex> lock(asyncMutex);
+	asyncUpdateDone = true;
+	asyncCond.notify_all();
+}
+
+void CEngineOutHandler::FinishAsyncUpdate() {
+	if (asyncUpdateTask == nullptr)
+		return;
+	// reentered from a deferred command (e.g. Lua answering an AI with a
+	// message of its own); the AI thread is blocked, same as synchronous
+	if (servingAsyncRequest)
+		return;
+
+	SCOPED_TIMER("AI");
+
+	{
+		std::unique_lock<spring::mutex> lock(asyncMutex);
+
+		while (!asyncUpdateDone) {
+			asyncCond.wait(lock, [this]() { return (asyncUpdateDone || asyncRequest != nullptr); });
+			ServeAsyncRequest(lock);
+		}
+	}
+
+	asyncUpdateTask->get();
+	asyncUpdateTask.reset();
+}
+
+void CEngineOutHandler::ServeAsyncRequests() {
+	if (asyncUpdateTask == nullptr)
+		return;
+
+	std::unique_lock<spring::mutex> lock(asyncMutex);
+	ServeAsyncRequest(lock);
+}
+
+void CEngineOutHandler::ServeAsyncRequest(std::unique_lock<spring::mutex>& lock) {
+	if (asyncRequest == nullptr || servingAsyncRequest)
+		return;
+
+	servingAsyncRequest = true;
+	lock.unlock();
+
+	const int result = (*asyncRequest)();
+
+	lock.lock();
+	servingAsyncRequest = false;
+
+	asyncRequestResult = result;
+	asyncRequest = nullptr;
+	asyncCond.notify_all();
+}
+
+bool CEngineOutHandler::IsAsyncUpdateThread() { return asyncUpdateThread; }
+
+int CEngineOutHandler::RunOnMainThread(const std::function<int()>& func) {
+	std::unique_lock<spring::mutex> lock(asyncMutex);
+
+	assert(asyncUpdateThread);
+	assert(asyncRequest == nullptr);
+
+	asyncRequest = &func;
+	asyncCond.notify_all();
+	asyncCond.wait(lock, [this]() { return (asyncRequest == nullptr); });
+
+	return asyncRequestResult;
+}
+
+
 
 // Do only if the unit is not allied, in which case we know
 // everything about it anyway, and do not need to be informed
@@ -487,6 +624,8 @@ bool CEngineOutHandler::SendLuaMessages(int aiTeam, const char* inData, std::vec
 	if (activeSkirmishAIs.empty())
 		return false;
 
+	FinishAsyncUpdate();
+
 	unsigned int n = 0;
 
 	if (aiTeam != -1) {
@@ -536,6 +675,7 @@ void CEngineOutHandler::CreateSkirmishAI(const uint8_t skirmishAIId, bool savedG
 		return;
 	}
 
+	FinishAsyncUpdate();
 	aiInst.PreInit(skirmishAIId);
 
 	teamSkirmishAIs[ aiInst.GetTeamId() ].push_back(skirmishAIId);
@@ -554,6 +694,9 @@ void CEngineOutHandler::CreateSkirmishAI(const uint8_t skirmishAIId, bool savedG
 	if (!savedGame)
 		aiInst.PostLoad();
 
+	// everything from here on is batched, see LaunchAsyncUpdate
+	aiInst.SetQueueEvents(asyncUpdates);
+
 	clientNet->Send(CBaseNetProtocol::Get().SendAIStateChanged(gu->myPlayerNum, skirmishAIId, SKIRMAISTATE_ALIVE));
 }
 
@@ -563,6 +706,7 @@ void CEngineOutHandler::PostLoadSkirmishAI(const uint8_t skirmishAIId) {
 	if (aiInst.IsLoadSupported())
 		return;
 
+	FinishAsyncUpdate();
 	aiInst.PostLoad();
 }
 
@@ -570,6 +714,8 @@ void CEngineOutHandler::DestroySkirmishAI(const uint8_t skirmishAIId) {
 	SCOPED_TIMER("AI");
 	LOG_L(L_INFO, "[EOH::%s(id=%u)]", __func__, skirmishAIId);
 
+	FinishAsyncUpdate();
+
 	const int teamID = hostSkirmishAIs[skirmishAIId].GetTeamId();
 
 	const auto it = std::find(teamSkirmishAIs[teamID].begin(), teamSkirmishAIs[teamID].end(), skirmishAIId);
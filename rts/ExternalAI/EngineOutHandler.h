@@ -5,9 +5,13 @@
 
 #include "SkirmishAIWrapper.h"
 #include "System/Object.h"
+#include "System/Threading/SpringThreading.h"
 #include "Sim/Misc/GlobalConstants.h"
 
 #include <array>
+#include <functional>
+#include <future>
+#include <memory>
 #include <vector>
 #include <string>
 
@@ -31,8 +35,9 @@ public:
 	static void Create();
 	static void Destroy();
 
-	void Init() { activeSkirmishAIs.reserve(16); }
+	void Init();
 	void Kill() {
+		FinishAsyncUpdate();
 		PreDestroy();
 
 		// release leftover active AI's
@@ -49,6 +54,25 @@ public:
 
 	void Update();
 
+	/**
+	 * Asynchronous mode only (see AsyncSkirmishAIs): appends the Update
+	 * event (if <sendUpdate>) to the events recorded during this sim frame
+	 * and delivers the batch to every AI on a worker thread. Must be called
+	 * after every simulated frame, including skipped ones so the recorded
+	 * events do not pile up; the sim state may not change again until the
+	 * next FinishAsyncUpdate, which is what makes it safe for AIs to read.
+	 */
+	void LaunchAsyncUpdate(bool sendUpdate);
+	/// blocks until the batch started by LaunchAsyncUpdate is done, serving deferred AI commands meanwhile
+	void FinishAsyncUpdate();
+	/// runs AI commands deferred by RunOnMainThread without waiting for the batch to finish
+	void ServeAsyncRequests();
+
+	/// true on the worker thread that is delivering an asynchronous batch
+	static bool IsAsyncUpdateThread();
+	/// executes <func> on the main thread; the calling AI thread blocks until it has run
+	int RunOnMainThread(const std::function<int()>& func);
+
 	/** Group should return false if it doenst want the unit for some reason. */
 	bool UnitAddedToGroup(const CUnit& unit, const CGroup& group);
 	/** No way to refuse giving up a unit. */
@@ -106,6 +130,10 @@ public:
 	void Load(std::istream* s, const uint8_t skirmishAIId);
 	void Save(std::ostream* s, const uint8_t skirmishAIId);
 
+private:
+	void RunAsyncUpdate();
+	void ServeAsyncRequest(std::unique_lock<spring::mutex>& lock);
+
 private:
 	/// Contains all local Skirmish AIs, indexed by their ID
 	std::array<CSkirmishAIWrapper, MAX_AIS > hostSkirmishAIs;
@@ -117,6 +145,22 @@ private:
 	std::array<std::vector<uint8_t>, MAX_TEAMS> teamSkirmishAIs;
 
 	std::vector<uint8_t> activeSkirmishAIs;
+
+	// asynchronous mode state; <asyncSkirmishAIs> is the set of AIs the
+	// current batch was launched for, <asyncRequest> a command an AI has
+	// deferred to the main thread (at most one, there is one AI thread)
+	std::vector<uint8_t> asyncSkirmishAIs;
+	std::shared_ptr<std::future<void>> asyncUpdateTask;
+
+	spring::mutex asyncMutex;
+	spring::condition_variable_any asyncCond;
+
+	const std::function<int()>* asyncRequest = nullptr;
+	int asyncRequestResult = 0;
+
+	bool asyncUpdates = false;
+	bool asyncUpdateDone = false;
+	bool servingAsyncRequest = false;
 };
 
 #define eoh CEngineOutHandler::GetInstance()
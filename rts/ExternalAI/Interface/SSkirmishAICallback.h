@@ -2256,6 +2256,22 @@ struct SSkirmishAICallback {
 
 	bool              (CALLING_CONV *Debug_GraphDrawer_isEnabled)(int skirmishAIId);
 
+	/**
+	 * Bulk variant of Unit_getPos, Unit_getVel, Unit_getHealth and Unit_getDef,
+	 * applying the same LOS and cheat rules to each of the first
+	 * unitIds_sizeMax units in unitIds.
+	 * For every unit, 9 values are written to states:
+	 * position (x, y, z), velocity (x, y, z), health, unit-def id and the LOS
+	 * bits this team's ally-team has on it (1: in LOS, 2: in radar,
+	 * 4: previously in LOS, 8: continuously in radar), all of them for allied
+	 * units or with cheats enabled.
+	 * Units that are dead or do not exist yield the same values as enemy units
+	 * that were never seen, including 0 LOS bits.
+	 * @return the number of values written to states, or the number required
+	 *         if states is NULL
+	 */
+	int               (CALLING_CONV *getUnitStates)(int skirmishAIId, const int* unitIds, int unitIds_sizeMax, float* states, int states_sizeMax); //$ ARRAY:states
+
 };
 
 #if	defined(__cplusplus)
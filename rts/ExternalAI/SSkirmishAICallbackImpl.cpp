@@ -3,6 +3,7 @@
 #include "ExternalAI/AICallback.h"
 #include "ExternalAI/AICheats.h"
 #include "ExternalAI/AILibraryManager.h"
+#include "ExternalAI/EngineOutHandler.h"
 #include "ExternalAI/SSkirmishAICallbackImpl.h"
 #include "ExternalAI/SkirmishAILibraryInfo.h"
 #include "ExternalAI/SkirmishAIWrapper.h"
@@ -638,6 +639,13 @@ EXPORT(int) skirmishAiCallback_Engine_executeCommand(
 	return ret;
 }
 
+static int HandleEngineCommand(int skirmishAIId, int commandId, int commandTopic, void* commandData);
+
+static inline bool IsUnitOrderCommand(int commandTopic) {
+	// all of these end up in CAICallback::GiveOrder, which only sends a network message
+	return ((commandTopic >= COMMAND_UNIT_BUILD && commandTopic <= COMMAND_UNIT_CUSTOM) || commandTopic == COMMAND_UNIT_RECLAIM_FEATURE);
+}
+
 EXPORT(int) skirmishAiCallback_Engine_handleCommand(
 	int skirmishAIId,
 	int /*toId*/,
@@ -645,6 +653,15 @@ EXPORT(int) skirmishAiCallback_Engine_handleCommand(
 	int commandTopic,
 	void* commandData
 ) {
+	// other commands (cheats, paths, drawing, Lua calls, ...) touch state the
+	// main thread owns, so an AI updating asynchronously has to defer them
+	if (!IsUnitOrderCommand(commandTopic) && CEngineOutHandler::IsAsyncUpdateThread())
+		return eoh->RunOnMainThread([&]() { return HandleEngineCommand(skirmishAIId, commandId, commandTopic, commandData); });
+
+	return HandleEngineCommand(skirmishAIId, commandId, commandTopic, commandData);
+}
+
+static int HandleEngineCommand(int skirmishAIId, int commandId, int commandTopic, void* commandData) {
 	int ret = 0;
 
 	CAICallback* clb = GetCallBack(skirmishAIId);
@@ -3750,6 +3767,70 @@ EXPORT(void) skirmishAiCallback_Unit_getVel(int skirmishAIId, int unitId, float*
 	GetCallBack(skirmishAIId)->GetUnitVelocity(unitId).copyInto(return_posF3_out);
 }
 
+EXPORT(int) skirmishAiCallback_getUnitStates(
+	int skirmishAIId,
+	const int* unitIds,
+	int unitIds_sizeMax,
+	float* states,
+	int states_sizeMax
+) {
+	// pos(3), vel(3), health, unitDefId, losBits
+	constexpr int UNIT_STATE_SIZE = 9;
+	constexpr int allLosBits = LOS_INLOS | LOS_INRADAR | LOS_PREVLOS | LOS_CONTRADAR;
+
+	const int statesRealSize = std::max(unitIds_sizeMax, 0) * UNIT_STATE_SIZE;
+
+	if (states == nullptr)
+		return statesRealSize;
+
+	// only ever write whole records
+	const int numUnits = std::min(statesRealSize, states_sizeMax) / UNIT_STATE_SIZE;
+
+	// same rules as the single-unit getters, but the cheat and
+	// ally-team lookups are done once instead of once per call
+	CAICallback* clb = GetCallBack(skirmishAIId);
+	CAICheats* clbCheat = skirmishAiCallback_Cheats_isEnabled(skirmishAIId)? GetCheatCallBack(skirmishAIId): nullptr;
+
+	const int teamId = AI_TEAM_IDS[skirmishAIId];
+	const int allyId = teamHandler.AllyTeam(teamId);
+
+	for (int i = 0; i < numUnits; i++) {
+		const int unitId = unitIds[i];
+		const CUnit* unit = getUnit(unitId);
+
+		float* state = &states[i * UNIT_STATE_SIZE];
+
+		// unknown ids must be indistinguishable from enemies never seen
+		int losBits = 0;
+
+		if (unit != nullptr) {
+			losBits = unit->losStatus[allyId] & allLosBits;
+
+			if (clbCheat != nullptr || teamHandler.AlliedTeams(unit->team, teamId))
+				losBits = allLosBits;
+		}
+
+		const UnitDef* unitDef = nullptr;
+
+		if (clbCheat != nullptr) {
+			clbCheat->GetUnitPos(unitId).copyInto(&state[0]);
+			clbCheat->GetUnitVelocity(unitId).copyInto(&state[3]);
+			state[6] = clbCheat->GetUnitHealth(unitId);
+			unitDef = clbCheat->GetUnitDef(unitId);
+		} else {
+			clb->GetUnitPos(unitId).copyInto(&state[0]);
+			clb->GetUnitVelocity(unitId).copyInto(&state[3]);
+			state[6] = clb->GetUnitHealth(unitId);
+			unitDef = clb->GetUnitDef(unitId);
+		}
+
+		state[7] = (unitDef != nullptr)? unitDef->id: -1;
+		state[8] = losBits;
+	}
+
+	return (numUnits * UNIT_STATE_SIZE);
+}
+
 
 //EXPORT(int) skirmishAiCallback_Unit_0MULTI1SIZE0ResourceInfo(int skirmishAIId, int unitId) {
 //	return skirmishAiCallback_0MULTI1SIZE0Resource(skirmishAIId);
@@ -5628,6 +5709,7 @@ static void skirmishAiCallback_init(SSkirmishAICallback* callback) {
 	callback->Unit_Weapon_isShieldEnabled = &skirmishAiCallback_Unit_Weapon_isShieldEnabled;
 	callback->Unit_Weapon_getShieldPower = &skirmishAiCallback_Unit_Weapon_getShieldPower;
 	callback->Debug_GraphDrawer_isEnabled = &skirmishAiCallback_Debug_GraphDrawer_isEnabled;
+	callback->getUnitStates = &skirmishAiCallback_getUnitStates;
 }
 
 SSkirmishAICallback* skirmishAiCallback_GetInstance(CSkirmishAIWrapper* ai)
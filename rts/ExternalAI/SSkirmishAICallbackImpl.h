@@ -1263,6 +1263,8 @@ EXPORT(float            ) skirmishAiCallback_Unit_Weapon_getShieldPower(int skir
 
 EXPORT(bool             ) skirmishAiCallback_Debug_GraphDrawer_isEnabled(int skirmishAIId);
 
+EXPORT(int              ) skirmishAiCallback_getUnitStates(int skirmishAIId, const int* unitIds, int unitIds_sizeMax, float* states, int states_sizeMax);
+
 #if	defined(__cplusplus)
 } // extern "C"
 #endif
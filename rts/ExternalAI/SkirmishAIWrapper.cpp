@@ -25,6 +25,7 @@
 #include "System/TimeProfiler.h"
 #include "System/StringUtil.h"
 
+#include <cstring>
 #include <string>
 #include <sstream>
 #include <iostream>
@@ -51,6 +52,8 @@ CR_REG_METADATA(CSkirmishAIWrapper, (
 
 	CR_MEMBER(cheatEvents),
 	CR_MEMBER(blockEvents),
+	CR_IGNORED(queueEvents),
+	CR_IGNORED(eventQueues),
 
 	CR_SERIALIZER(Serialize),
 	CR_POSTLOAD(PostLoad)
@@ -74,6 +77,7 @@ void CSkirmishAIWrapper::PreInit(int aiID)
 
 		cheatEvents = false;
 		blockEvents = false;
+		queueEvents = false;
 	}
 	{
 		const std::string& kn = key.GetShortName();
@@ -172,6 +176,12 @@ void CSkirmishAIWrapper::Kill()
 		skirmishAIId = -1;
 		teamId = -1;
 	}
+	{
+		// undelivered events refer to a game the AI is no longer part of
+		eventQueues[0].Clear();
+		eventQueues[1].Clear();
+		queueEvents = false;
+	}
 }
 
 void CSkirmishAIWrapper::Release(int reason)
@@ -305,23 +315,19 @@ void CSkirmishAIWrapper::Save(std::ostream* saveStream)
 
 
 void CSkirmishAIWrapper::UnitIdle(int unitId) {
-	const SUnitIdleEvent evtData = {unitId};
-	HandleEvent(EVENT_UNIT_IDLE, &evtData);
+	PushEvent({EVENT_UNIT_IDLE, {unitId}});
 }
 
 void CSkirmishAIWrapper::UnitCreated(int unitId, int builderId) {
-	const SUnitCreatedEvent evtData = {unitId, builderId};
-	HandleEvent(EVENT_UNIT_CREATED, &evtData);
+	PushEvent({EVENT_UNIT_CREATED, {unitId, builderId}});
 }
 
 void CSkirmishAIWrapper::UnitFinished(int unitId) {
-	const SUnitFinishedEvent evtData = {unitId};
-	HandleEvent(EVENT_UNIT_FINISHED, &evtData);
+	PushEvent({EVENT_UNIT_FINISHED, {unitId}});
 }
 
 void CSkirmishAIWrapper::UnitDestroyed(int unitId, int attackerUnitId) {
-	const SUnitDestroyedEvent evtData = {unitId, attackerUnitId};
-	HandleEvent(EVENT_UNIT_DESTROYED, &evtData);
+	PushEvent({EVENT_UNIT_DESTROYED, {unitId, attackerUnitId}});
 }
 
 void CSkirmishAIWrapper::UnitDamaged(
@@ -332,61 +338,48 @@ void CSkirmishAIWrapper::UnitDamaged(
 	int weaponDefId,
 	bool paralyzer
 ) {
-	float3 cpyDir = dir;
-	const SUnitDamagedEvent evtData = {unitId, attackerUnitId, damage, &cpyDir[0], weaponDefId, paralyzer};
-
-	HandleEvent(EVENT_UNIT_DAMAGED, &evtData);
+	PushEvent({EVENT_UNIT_DAMAGED, {unitId, attackerUnitId, weaponDefId}, {damage, dir.x, dir.y, dir.z}, paralyzer});
 }
 
 void CSkirmishAIWrapper::UnitMoveFailed(int unitId) {
-	const SUnitMoveFailedEvent evtData = {unitId};
-	HandleEvent(EVENT_UNIT_MOVE_FAILED, &evtData);
+	PushEvent({EVENT_UNIT_MOVE_FAILED, {unitId}});
 }
 
 void CSkirmishAIWrapper::UnitGiven(int unitId, int oldTeam, int newTeam) {
-	const SUnitGivenEvent evtData = {unitId, oldTeam, newTeam};
-	HandleEvent(EVENT_UNIT_GIVEN, &evtData);
+	PushEvent({EVENT_UNIT_GIVEN, {unitId, oldTeam, newTeam}});
 }
 
 void CSkirmishAIWrapper::UnitCaptured(int unitId, int oldTeam, int newTeam) {
-	const SUnitCapturedEvent evtData = {unitId, oldTeam, newTeam};
-	HandleEvent(EVENT_UNIT_CAPTURED, &evtData);
+	PushEvent({EVENT_UNIT_CAPTURED, {unitId, oldTeam, newTeam}});
 }
 
 
 void CSkirmishAIWrapper::EnemyCreated(int unitId) {
-	const SEnemyCreatedEvent evtData = {unitId};
-	HandleEvent(EVENT_ENEMY_CREATED, &evtData);
+	PushEvent({EVENT_ENEMY_CREATED, {unitId}});
 }
 
 void CSkirmishAIWrapper::EnemyFinished(int unitId) {
-	const SEnemyFinishedEvent evtData = {unitId};
-	HandleEvent(EVENT_ENEMY_FINISHED, &evtData);
+	PushEvent({EVENT_ENEMY_FINISHED, {unitId}});
 }
 
 void CSkirmishAIWrapper::EnemyEnterLOS(int unitId) {
-	const SEnemyEnterLOSEvent evtData = {unitId};
-	HandleEvent(EVENT_ENEMY_ENTER_LOS, &evtData);
+	PushEvent({EVENT_ENEMY_ENTER_LOS, {unitId}});
 }
 
 void CSkirmishAIWrapper::EnemyLeaveLOS(int unitId) {
-	const SEnemyLeaveLOSEvent evtData = {unitId};
-	HandleEvent(EVENT_ENEMY_LEAVE_LOS, &evtData);
+	PushEvent({EVENT_ENEMY_LEAVE_LOS, {unitId}});
 }
 
 void CSkirmishAIWrapper::EnemyEnterRadar(int unitId) {
-	const SEnemyEnterRadarEvent evtData = {unitId};
-	HandleEvent(EVENT_ENEMY_ENTER_RADAR, &evtData);
+	PushEvent({EVENT_ENEMY_ENTER_RADAR, {unitId}});
 }
 
 void CSkirmishAIWrapper::EnemyLeaveRadar(int unitId) {
-	const SEnemyLeaveRadarEvent evtData = {unitId};
-	HandleEvent(EVENT_ENEMY_LEAVE_RADAR, &evtData);
+	PushEvent({EVENT_ENEMY_LEAVE_RADAR, {unitId}});
 }
 
 void CSkirmishAIWrapper::EnemyDestroyed(int enemyUnitId, int attackerUnitId) {
-	const SEnemyDestroyedEvent evtData = {enemyUnitId, attackerUnitId};
-	HandleEvent(EVENT_ENEMY_DESTROYED, &evtData);
+	PushEvent({EVENT_ENEMY_DESTROYED, {enemyUnitId, attackerUnitId}});
 }
 
 void CSkirmishAIWrapper::EnemyDamaged(
@@ -397,20 +390,15 @@ void CSkirmishAIWrapper::EnemyDamaged(
 	int weaponDefId,
 	bool paralyzer
 ) {
-	float3 cpyDir = dir;
-	const SEnemyDamagedEvent evtData = {enemyUnitId, attackerUnitId, damage, &cpyDir[0], weaponDefId, paralyzer};
-
-	HandleEvent(EVENT_ENEMY_DAMAGED, &evtData);
+	PushEvent({EVENT_ENEMY_DAMAGED, {enemyUnitId, attackerUnitId, weaponDefId}, {damage, dir.x, dir.y, dir.z}, paralyzer});
 }
 
 void CSkirmishAIWrapper::Update(int frame) {
-	const SUpdateEvent evtData = {frame};
-	HandleEvent(EVENT_UPDATE, &evtData);
+	PushEvent({EVENT_UPDATE, {frame}});
 }
 
 void CSkirmishAIWrapper::SendChatMessage(const char* msg, int fromPlayerId) {
-	const SMessageEvent evtData = {fromPlayerId, msg};
-	HandleEvent(EVENT_MESSAGE, &evtData);
+	PushEvent({EVENT_MESSAGE, {fromPlayerId}}, nullptr, msg);
 }
 
 void CSkirmishAIWrapper::SendLuaMessage(const char* inData, const char** outData) {
@@ -419,8 +407,7 @@ void CSkirmishAIWrapper::SendLuaMessage(const char* inData, const char** outData
 }
 
 void CSkirmishAIWrapper::WeaponFired(int unitId, int weaponDefId) {
-	const SWeaponFiredEvent evtData = {unitId, weaponDefId};
-	HandleEvent(EVENT_WEAPON_FIRED, &evtData);
+	PushEvent({EVENT_WEAPON_FIRED, {unitId, weaponDefId}});
 }
 
 void CSkirmishAIWrapper::PlayerCommandGiven(
@@ -431,14 +418,13 @@ void CSkirmishAIWrapper::PlayerCommandGiven(
 	std::vector<int> unitIds = playerSelectedUnits;
 
 	const int cCommandId = extractAICommandTopic(&c, unitHandler.MaxUnits());
-	const SPlayerCommandEvent evtData = {&unitIds[0], static_cast<int>(playerSelectedUnits.size()), cCommandId, playerId};
+	const int numUnitIds = static_cast<int>(unitIds.size());
 
-	HandleEvent(EVENT_PLAYER_COMMAND, &evtData);
+	PushEvent({EVENT_PLAYER_COMMAND, {playerId, cCommandId, numUnitIds}}, unitIds.data());
 }
 
 void CSkirmishAIWrapper::CommandFinished(int unitId, int commandId, int commandTopicId) {
-	const SCommandFinishedEvent evtData = {unitId, commandId, commandTopicId};
-	HandleEvent(EVENT_COMMAND_FINISHED, &evtData);
+	PushEvent({EVENT_COMMAND_FINISHED, {unitId, commandId, commandTopicId}});
 }
 
 void CSkirmishAIWrapper::SeismicPing(
@@ -447,20 +433,170 @@ void CSkirmishAIWrapper::SeismicPing(
 	const float3& pos,
 	float strength
 ) {
-	/*const*/ float3 cpyPos = pos;
-	const SSeismicPingEvent evtData = {&cpyPos[0], strength};
+	PushEvent({EVENT_SEISMIC_PING, {allyTeam, unitId}, {pos.x, pos.y, pos.z, strength}});
+}
+
+
 
-	HandleEvent(EVENT_SEISMIC_PING, &evtData);
+void CSkirmishAIWrapper::PushEvent(const QueuedEvent& evt, int* unitIds, const char* text) {
+	if (!queueEvents) {
+		DispatchEvent(evt, unitIds, text);
+		return;
+	}
+
+	EventQueue& queue = eventQueues[0];
+	QueuedEvent& qEvt = queue.events.emplace_back(evt);
+
+	// payloads are appended to shared buffers, the event keeps their offset
+	if (unitIds != nullptr) {
+		qEvt.args[3] = static_cast<int>(queue.unitIds.size());
+		queue.unitIds.insert(queue.unitIds.end(), unitIds, unitIds + evt.args[2]);
+	}
+	if (text != nullptr) {
+		qEvt.args[3] = static_cast<int>(queue.text.size());
+		queue.text.insert(queue.text.end(), text, text + strlen(text) + 1);
+	}
+}
+
+void CSkirmishAIWrapper::SwapEventQueues() {
+	std::swap(eventQueues[0], eventQueues[1]);
+	eventQueues[0].Clear();
+}
+
+void CSkirmishAIWrapper::DispatchEvents() {
+	EventQueue& queue = eventQueues[1];
+
+	for (const QueuedEvent& evt: queue.events) {
+		switch (evt.topic) {
+			case EVENT_PLAYER_COMMAND: { DispatchEvent(evt, queue.unitIds.data() + evt.args[3], nullptr); } break;
+			case EVENT_MESSAGE       : { DispatchEvent(evt, nullptr, queue.text.data() + evt.args[3]); } break;
+			default                  : { DispatchEvent(evt, nullptr, nullptr); } break;
+		}
+	}
+}
+
+void CSkirmishAIWrapper::DispatchEvent(const QueuedEvent& evt, int* unitIds, const char* text) const {
+	const int* args = &evt.args[0];
+	const float* vals = &evt.vals[0];
+
+	switch (evt.topic) {
+		case EVENT_UNIT_IDLE: {
+			const SUnitIdleEvent evtData = {args[0]};
+			HandleEvent(evt.topic, &evtData);
+		} break;
+		case EVENT_UNIT_CREATED: {
+			const SUnitCreatedEvent evtData = {args[0], args[1]};
+			HandleEvent(evt.topic, &evtData);
+		} break;
+		case EVENT_UNIT_FINISHED: {
+			const SUnitFinishedEvent evtData = {args[0]};
+			HandleEvent(evt.topic, &evtData);
+		} break;
+		case EVENT_UNIT_DESTROYED: {
+			const SUnitDestroyedEvent evtData = {args[0], args[1]};
+			HandleEvent(evt.topic, &evtData);
+		} break;
+		case EVENT_UNIT_DAMAGED: {
+			float3 cpyDir = {vals[1], vals[2], vals[3]};
+			const SUnitDamagedEvent evtData = {args[0], args[1], vals[0], &cpyDir[0], args[2], evt.flag};
+			HandleEvent(evt.topic, &evtData);
+		} break;
+		case EVENT_UNIT_MOVE_FAILED: {
+			const SUnitMoveFailedEvent evtData = {args[0]};
+			HandleEvent(evt.topic, &evtData);
+		} break;
+		case EVENT_UNIT_GIVEN: {
+			const SUnitGivenEvent evtData = {args[0], args[1], args[2]};
+			HandleEvent(evt.topic, &evtData);
+		} break;
+		case EVENT_UNIT_CAPTURED: {
+			const SUnitCapturedEvent evtData = {args[0], args[1], args[2]};
+			HandleEvent(evt.topic, &evtData);
+		} break;
+
+		case EVENT_ENEMY_CREATED: {
+			const SEnemyCreatedEvent evtData = {args[0]};
+			HandleEvent(evt.topic, &evtData);
+		} break;
+		case EVENT_ENEMY_FINISHED: {
+			const SEnemyFinishedEvent evtData = {args[0]};
+			HandleEvent(evt.topic, &evtData);
+		} break;
+		case EVENT_ENEMY_ENTER_LOS: {
+			const SEnemyEnterLOSEvent evtData = {args[0]};
+			HandleEvent(evt.topic, &evtData);
+		} break;
+		case EVENT_ENEMY_LEAVE_LOS: {
+			const SEnemyLeaveLOSEvent evtData = {args[0]};
+			HandleEvent(evt.topic, &evtData);
+		} break;
+		case EVENT_ENEMY_ENTER_RADAR: {
+			const SEnemyEnterRadarEvent evtData = {args[0]};
+			HandleEvent(evt.topic, &evtData);
+		} break;
+		case EVENT_ENEMY_LEAVE_RADAR: {
+			const SEnemyLeaveRadarEvent evtData = {args[0]};
+			HandleEvent(evt.topic, &evtData);
+		} break;
+		case EVENT_ENEMY_DESTROYED: {
+			const SEnemyDestroyedEvent evtData = {args[0], args[1]};
+			HandleEvent(evt.topic, &evtData);
+		} break;
+		case EVENT_ENEMY_DAMAGED: {
+			float3 cpyDir = {vals[1], vals[2], vals[3]};
+			const SEnemyDamagedEvent evtData = {args[0], args[1], vals[0], &cpyDir[0], args[2], evt.flag};
+			HandleEvent(evt.topic, &evtData);
+		} break;
+
+		case EVENT_UPDATE: {
+			const SUpdateEvent evtData = {args[0]};
+			HandleEvent(evt.topic, &evtData);
+		} break;
+		case EVENT_MESSAGE: {
+			const SMessageEvent evtData = {args[0], text};
+			HandleEvent(evt.topic, &evtData);
+		} break;
+		case EVENT_WEAPON_FIRED: {
+			const SWeaponFiredEvent evtData = {args[0], args[1]};
+			HandleEvent(evt.topic, &evtData);
+		} break;
+		case EVENT_PLAYER_COMMAND: {
+			const SPlayerCommandEvent evtData = {unitIds, args[2], args[1], args[0]};
+			HandleEvent(evt.topic, &evtData);
+		} break;
+		case EVENT_COMMAND_FINISHED: {
+			const SCommandFinishedEvent evtData = {args[0], args[1], args[2]};
+			HandleEvent(evt.topic, &evtData);
+		} break;
+		case EVENT_SEISMIC_PING: {
+			/*const*/ float3 cpyPos = {vals[0], vals[1], vals[2]};
+			const SSeismicPingEvent evtData = {&cpyPos[0], vals[3]};
+			HandleEvent(evt.topic, &evtData);
+		} break;
+
+		default: {
+			assert(false);
+		} break;
+	}
 }
 
 
 int CSkirmishAIWrapper::HandleEvent(int topic, const void* data) const {
+	// queued events are delivered off the main thread, where the
+	// regular (non-reentrant) profiler timers must not be touched
+	if (queueEvents) {
+		ScopedMtTimer timer(GetTimerNameHash());
+		return DeliverEvent(topic, data);
+	}
+
 	ScopedTimer timer(GetTimerNameHash());
+	return DeliverEvent(topic, data);
+}
 
+int CSkirmishAIWrapper::DeliverEvent(int topic, const void* data) const {
 	if (!blockEvents || (topic == EVENT_RELEASE))
 		return library->HandleEvent(skirmishAIId, topic, data);
 
 	// to prevent log error spam, signal: OK
 	return 0;
 }
-
@@ -5,6 +5,8 @@
 
 #include "SkirmishAIKey.h"
 
+#include <vector>
+
 class CSkirmishAILibrary;
 struct SSkirmishAICallback;
 
@@ -95,6 +97,17 @@ public:
 
 	bool CheatEventsEnabled() const { return cheatEvents; }
 
+	/**
+	 * While enabled, events are recorded instead of being passed to the
+	 * AI library immediately; see SwapEventQueues and DispatchEvents.
+	 * Init, Release, Load, Save and Lua messages are never queued.
+	 */
+	void SetQueueEvents(bool enable) { queueEvents = enable; }
+	/// hands all recorded events over to DispatchEvents (main thread only)
+	void SwapEventQueues();
+	/// delivers the events handed over by SwapEventQueues in order, may run on any thread
+	void DispatchEvents();
+
 	bool Active() const { return (skirmishAIId != -1); }
 
 	bool IsLoadSupported() const;
@@ -106,10 +119,38 @@ private:
 	void SendInitEvent(bool savedGame);
 	void SendUnitEvents();
 
+	/**
+	 * Plain-data record of an engine event, converted to the matching
+	 * S*Event struct on delivery; the meaning of args and vals depends
+	 * on the topic (see DispatchEvent).
+	 */
+	struct QueuedEvent {
+		int topic;
+		int args[4];
+		float vals[4];
+		bool flag;
+	};
+	struct EventQueue {
+		void Clear() {
+			events.clear();
+			unitIds.clear();
+			text.clear();
+		}
+
+		std::vector<QueuedEvent> events;
+		// variable-length payloads of PlayerCommandGiven and SendChatMessage
+		std::vector<int> unitIds;
+		std::vector<char> text;
+	};
+
+	void PushEvent(const QueuedEvent& evt, int* unitIds = nullptr, const char* text = nullptr);
+	void DispatchEvent(const QueuedEvent& evt, int* unitIds, const char* text) const;
+
 	/**
 	 * CAUTION: takes C AI Interface events, not engine C++ ones!
 	 */
 	int HandleEvent(int topic, const void* data) const;
+	int DeliverEvent(int topic, const void* data) const;
 
 	uint32_t GetTimerNameHash() const { return *reinterpret_cast<const uint32_t*>(&timerName[0]); }
 
@@ -134,6 +175,10 @@ private:
 	bool libraryInit = false; // CSkirmishAILibrary::Init retval
 	bool cheatEvents = false;
 	bool blockEvents = false;
+	bool queueEvents = false;
+
+	// [0] is recorded into by the main thread, [1] is being dispatched
+	EventQueue eventQueues[2];
 };
 
 #endif // SKIRMISH_AI_WRAPPER_H
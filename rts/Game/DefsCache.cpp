@@ -0,0 +1,188 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "DefsCache.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <fstream>
+
+#include "GameSetup.h"
+#include "GameVersion.h"
+#include "Lua/LuaParser.h"
+#include "Map/MapInfo.h"
+#include "Sim/Misc/ModInfo.h"
+#include "System/Config/ConfigHandler.h"
+#include "System/FileSystem/ArchiveScanner.h"
+#include "System/FileSystem/DataDirsAccess.h"
+#include "System/FileSystem/FileQueryFlags.h"
+#include "System/FileSystem/FileSystem.h"
+#include "System/Log/ILog.h"
+
+CONFIG(bool, DefsCache)
+	.defaultValue(true)
+	.description("Cache the gamedata definitions returned by defs.lua on disk, so later games with the same game, map and options can skip executing them.");
+
+
+static constexpr char CACHE_MAGIC[4] = {'S', 'D', 'E', 'F'};
+static constexpr std::uint32_t CACHE_VERSION = 2;
+
+static void AppendKeyString(sha512::msg_vector& msg, const std::string& str)
+{
+	// include the terminator so adjacent strings can not alias
+	msg.insert(msg.end(), str.begin(), str.end());
+	msg.push_back(0);
+}
+
+static void AppendKeyOptions(sha512::msg_vector& msg, const spring::unordered_map<std::string, std::string>& options)
+{
+	std::vector< std::pair<std::string, std::string> > pairs(options.begin(), options.end());
+	std::sort(pairs.begin(), pairs.end());
+
+	for (const auto& pair: pairs) {
+		AppendKeyString(msg, pair.first);
+		AppendKeyString(msg, pair.second);
+	}
+
+	msg.push_back(0);
+}
+
+
+CDefsCache::CDefsCache(LuaParser* _parser): parser(_parser)
+{
+	if (!(enabled = configHandler->GetBool("DefsCache")))
+		return;
+
+	// one file per game archive, entries for other maps or options overwrite it
+	fileName = modInfo.filename;
+
+	std::replace_if(fileName.begin(), fileName.end(), [](char c) { return (!std::isalnum(static_cast<unsigned char>(c)) && c != '.' && c != '-'); }, '_');
+	fileName = FileSystem::GetCacheDir() + "/defs/" + fileName + ".sdef";
+
+	sha512::msg_vector keyData;
+	keyData.reserve(4096);
+
+	AppendKeyString(keyData, SpringVersion::GetFull());
+
+	{
+		const sha512::raw_digest& modChecksum = archiveScanner->GetArchiveCompleteChecksumBytes(modInfo.filename);
+		const sha512::raw_digest& mapChecksum = archiveScanner->GetArchiveCompleteChecksumBytes(mapInfo->map.name);
+
+		keyData.insert(keyData.end(), modChecksum.begin(), modChecksum.end());
+		keyData.insert(keyData.end(), mapChecksum.begin(), mapChecksum.end());
+	}
+
+	AppendKeyOptions(keyData, CGameSetup::GetModOptions());
+	AppendKeyOptions(keyData, CGameSetup::GetMapOptions());
+
+	// covers everything else defs.lua can observe about the current setup
+	enabled &= parser->SerializeGlobal("Game", keyData);
+
+	sha512::calc_digest(keyData, cacheKey);
+}
+
+
+bool CDefsCache::Load()
+{
+	if (!enabled)
+		return false;
+
+	std::vector<std::uint8_t> data;
+
+	if (!ReadFile(data))
+		return false;
+
+	if (!parser->DeserializeRoot(data)) {
+		LOG_L(L_WARNING, "[DefsCache::%s] discarding corrupt cache-file \"%s\"", __func__, fileName.c_str());
+		FileSystem::Remove(fileName);
+		return false;
+	}
+
+	LOG("[DefsCache::%s] loaded gamedata definitions from \"%s\" (%u bytes)", __func__, fileName.c_str(), uint32_t(data.size()));
+	return true;
+}
+
+void CDefsCache::Store()
+{
+	// results that depend on the random seed can not be reused, and any
+	// cache-hit would not advance the synced RNG the same way
+	if (!enabled || parser->UsedSyncedRandom())
+		return;
+
+	std::vector<std::uint8_t> data;
+
+	// the table can not be snapshotted (e.g. if it is nested too deeply);
+	// keep it as-is, which is equally deterministic since every client
+	// executes
+	if (!parser->SerializeRoot(data))
+		return;
+
+	// canonicalize what gets cached, so this client walks the same table
+	// as those loading it later (which strips functions and userdata, no
+	// def-parser reads them anyway)
+	if (!parser->DeserializeRoot(data))
+		return;
+
+	if (!WriteFile(data))
+		LOG_L(L_WARNING, "[DefsCache::%s] could not write cache-file \"%s\"", __func__, fileName.c_str());
+}
+
+
+bool CDefsCache::ReadFile(std::vector<std::uint8_t>& data) const
+{
+	std::ifstream ifs(dataDirsAccess.LocateFile(fileName), std::ios::in | std::ios::binary);
+
+	if (!ifs.good())
+		return false;
+
+	char magic[sizeof(CACHE_MAGIC)] = {0};
+	std::uint32_t version = 0;
+	std::uint64_t size = 0;
+	sha512::raw_digest key;
+
+	ifs.read(magic, sizeof(magic));
+	ifs.read(reinterpret_cast<char*>(&version), sizeof(version));
+	ifs.read(reinterpret_cast<char*>(key.data()), key.size());
+	ifs.read(reinterpret_cast<char*>(&size), sizeof(size));
+
+	if (!ifs.good() || std::memcmp(magic, CACHE_MAGIC, sizeof(magic)) != 0 || version != CACHE_VERSION)
+		return false;
+	// stale entry, will be overwritten by Store
+	if (key != cacheKey)
+		return false;
+
+	const std::streamoff dataPos = ifs.tellg();
+
+	ifs.seekg(0, std::ios::end);
+
+	// never trust the size field with an allocation; a truncated or corrupt
+	// file is just a miss, and will be overwritten by Store
+	if (!ifs.good() || dataPos < 0 || size != std::uint64_t(std::streamoff(ifs.tellg()) - dataPos))
+		return false;
+
+	ifs.seekg(dataPos);
+
+	data.resize(size);
+	ifs.read(reinterpret_cast<char*>(data.data()), size);
+
+	return (ifs.gcount() == std::streamsize(size));
+}
+
+bool CDefsCache::WriteFile(const std::vector<std::uint8_t>& data) const
+{
+	const std::string filePath = dataDirsAccess.LocateFile(fileName, FileQueryFlags::WRITE | FileQueryFlags::CREATE_DIRS);
+	const std::uint64_t size = data.size();
+
+	std::ofstream ofs(filePath, std::ios::out | std::ios::binary | std::ios::trunc);
+
+	if (!ofs.good())
+		return false;
+
+	ofs.write(CACHE_MAGIC, sizeof(CACHE_MAGIC));
+	ofs.write(reinterpret_cast<const char*>(&CACHE_VERSION), sizeof(CACHE_VERSION));
+	ofs.write(reinterpret_cast<const char*>(cacheKey.data()), cacheKey.size());
+	ofs.write(reinterpret_cast<const char*>(&size), sizeof(size));
+	ofs.write(reinterpret_cast<const char*>(data.data()), size);
+
+	return ofs.good();
+}
@@ -0,0 +1,51 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef DEFS_CACHE_H
+#define DEFS_CACHE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "System/Sync/SHA512.hpp"
+
+class LuaParser;
+
+/**
+ * On-disk cache of the table returned by gamedata/defs.lua, keyed by the
+ * engine version, mod- and map-archive checksums, {mod,map}options and the
+ * Game constants visible to defs.lua. A hit replaces executing the defs
+ * (including all of their post-processing) by rebuilding the table from a
+ * binary snapshot.
+ *
+ * Since a rebuilt table is not guaranteed to iterate in the same order as
+ * the one it was taken from, executed defs that get written to the cache are
+ * round-tripped through their snapshot first, so the writer sees the exact
+ * same table as later hits do. Defs that are not cached (including all defs
+ * while the cache is disabled) are used as executed.
+ */
+class CDefsCache
+{
+public:
+	// <parser> must have its environment set up, but not be executed yet
+	CDefsCache(LuaParser* parser);
+
+	// true if the parser's root was replaced by a cached snapshot
+	bool Load();
+	// writes the executed root to the cache (normalizing it) if possible
+	void Store();
+
+private:
+	bool ReadFile(std::vector<std::uint8_t>& data) const;
+	bool WriteFile(const std::vector<std::uint8_t>& data) const;
+
+private:
+	LuaParser* parser;
+
+	std::string fileName;
+	sha512::raw_digest cacheKey;
+
+	bool enabled = false;
+};
+
+#endif
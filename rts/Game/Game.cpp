@@ -7,6 +7,7 @@
 #include "CameraHandler.h"
 #include "ChatMessage.h"
 #include "CommandMessage.h"
+#include "DefsCache.h"
 #include "ConsoleHistory.h"
 #include "GameHelper.h"
 #include "GameSetup.h"
@@ -78,9 +79,11 @@
 #include "Sim/Misc/SideParser.h"
 #include "Sim/Misc/SmoothHeightMesh.h"
 #include "Sim/Misc/TeamHandler.h"
+#include "Sim/Misc/UnitBroadphase.h"
 #include "Sim/Misc/Wind.h"
 #include "Sim/Misc/ResourceHandler.h"
 #include "Sim/MoveTypes/MoveDefHandler.h"
+#include "Sim/MoveTypes/MoveMath/MoveMath.h"
 #include "Sim/MoveTypes/MoveTypeFactory.h"
 #include "Sim/Path/IPathManager.h"
 #include "Sim/Projectiles/ExplosionGenerator.h"
@@ -123,6 +126,7 @@
 #include "System/Sound/ISound.h"
 #include "System/Sound/ISoundChannels.h"
 #include "System/Sync/DumpState.h"
+#include "System/Threading/ThreadPool.h"
 #include "System/TimeProfiler.h"
 #include "System/LoadLock.h"
 
@@ -535,13 +539,11 @@ void CGame::LoadMap(const std::string& mapFileName)
 }
 
 
-void CGame::LoadDefs(LuaParser* defsParser)
+// NOTE: runs on a ThreadPool worker, must not touch the loadscreen or GL
+void CGame::ParseDefs(LuaParser* defsParser)
 {
-	ENTER_SYNCED_CODE();
-
 	{
-		SCOPED_ONCE_TIMER("Game::LoadDefs (GameData)");
-		loadscreen->SetLoadMessage("Loading GameData Definitions");
+		SCOPED_ONCE_TIMER("Game::ParseDefs (GameData)");
 
 		defsParser->SetupLua(true, true);
 		// customize the defs environment; LuaParser has no access to LuaSyncedRead
@@ -550,9 +552,15 @@ void CGame::LoadDefs(LuaParser* defsParser)
 		defsParser->AddFunc("GetMapOptions", LuaSyncedRead::GetMapOptions);
 		defsParser->EndTable();
 
-		// run the parser
-		if (!defsParser->Execute())
-			throw content_error("Defs-Parser: " + defsParser->GetErrorLog());
+		CDefsCache defsCache(defsParser);
+
+		// run the parser unless an up-to-date snapshot of its result exists
+		if (!defsCache.Load()) {
+			if (!defsParser->Execute())
+				throw content_error("Defs-Parser: " + defsParser->GetErrorLog());
+
+			defsCache.Store();
+		}
 
 		const LuaTable& root = defsParser->GetRoot();
 
@@ -577,7 +585,33 @@ void CGame::LoadDefs(LuaParser* defsParser)
 			throw content_error("Error loading MoveDefs");
 
 	}
+}
+
+void CGame::LoadDefs(LuaParser* defsParser)
+{
+	ENTER_SYNCED_CODE();
+
+	// defs.lua sees the map (via its Game table) but nothing loaded below,
+	// let a worker execute it while icons and sounds are being loaded here
+	// (the parse-task must not outlive the parser if the latter throw)
+	loadscreen->SetLoadMessage("Loading GameData Definitions");
+	const auto parseDefsTask = ThreadPool::Enqueue([this, defsParser]() { ParseDefs(defsParser); });
+
+	try {
+		LoadDefsUnsynced();
+	} catch (...) {
+		parseDefsTask->wait();
+		throw;
+	}
 
+	// rethrows any content_error raised by ParseDefs
+	parseDefsTask->get();
+
+	LEAVE_SYNCED_CODE();
+}
+
+void CGame::LoadDefsUnsynced()
+{
 	{
 		loadscreen->SetLoadMessage("Loading Radar Icons");
 		auto lock = CLoadLock::GetUniqueLock();
@@ -596,8 +630,6 @@ void CGame::LoadDefs(LuaParser* defsParser)
 		sound->LoadSoundDefs(&soundDefsParser);
 		chatSound = sound->GetDefSoundId("IncomingChat");
 	}
-
-	LEAVE_SYNCED_CODE();
 }
 
 
@@ -606,14 +638,23 @@ void CGame::PreLoadSimulation(LuaParser* defsParser)
 	ZoneScoped;
 	ENTER_SYNCED_CODE();
 
-	loadscreen->SetLoadMessage("Creating Smooth Height Mesh");
-	smoothGround.Init(int2(mapDims.mapx, mapDims.mapy), 2, 40);
+	// the smooth mesh only reads the heightmap, none of the components
+	// initialized below depend on it (or vice versa) so build it on a
+	// worker in the meantime
+	loadscreen->SetLoadMessage("Creating Smooth Height Mesh, QuadField & CEGs");
+	const auto smoothMeshTask = ThreadPool::Enqueue([]() { smoothGround.Init(int2(mapDims.mapx, mapDims.mapy), 2, 40); });
 
-	loadscreen->SetLoadMessage("Creating QuadField & CEGs");
-	moveDefHandler.Init(defsParser);
-	quadField.Init(int2(mapDims.mapx, mapDims.mapy), modInfo.quadFieldQuadSizeInElmos);
-	damageArrayHandler.Init(defsParser);
-	explGenHandler.Init();
+	try {
+		moveDefHandler.Init(defsParser);
+		quadField.Init(int2(mapDims.mapx, mapDims.mapy), modInfo.quadFieldQuadSizeInElmos);
+		damageArrayHandler.Init(defsParser);
+		explGenHandler.Init();
+	} catch (...) {
+		smoothMeshTask->wait();
+		throw;
+	}
+
+	smoothMeshTask->get();
 }
 
 void CGame::PostLoadSimulation(LuaParser* defsParser)
@@ -1003,6 +1044,8 @@ void CGame::KillSimulation()
 
 	CLosHandler::KillStatic(gu->globalReload);
 	quadField.Kill();
+	unitBroadphase.Kill();
+	CMoveMath::KillSpeedModRasters();
 	moveDefHandler.Kill();
 	unitDefHandler->Kill();
 	featureDefHandler->Kill();
@@ -1161,6 +1204,9 @@ bool CGame::Update()
 	if (playing && gameServer != nullptr && videoCapturing->AllowRecord())
 		gameServer->CreateNewFrame(false, true);
 
+	// asynchronous AIs read sim state, which the network messages below can change
+	eoh->FinishAsyncUpdate();
+
 	ENTER_SYNCED_CODE();
 	SendClientProcUsage();
 	ClientReadNet(); // issues new SimFrame()s
@@ -1221,6 +1267,9 @@ bool CGame::UpdateUnsynced(const spring_time currentTime)
 		updateDeltaSeconds = modGameDeltaTimeSecs;
 	}
 
+	// unblock an asynchronous AI waiting on a command deferred to this thread
+	eoh->ServeAsyncRequests();
+
 	{
 		// update sim-FPS counter once per second
 		static int lsf = gs->frameNum;
@@ -1661,6 +1710,9 @@ void CGame::SimFrame() {
 
 	FrameMarkStart(tracingSimFrameName);
 
+	// several frames can be simulated per ClientReadNet
+	eoh->FinishAsyncUpdate();
+
 	// note: starts at -1, first actual frame is 0
 	gs->frameNum += 1;
 	lastFrameTime = spring_gettime(); 
@@ -1751,6 +1803,10 @@ void CGame::SimFrame() {
 		playerHandler.GameFrame(gs->frameNum);
 	}
 
+	// skipped frames still hand over their events (as synchronous AIs get
+	// them immediately) but withhold the Update event, same as eoh->Update
+	eoh->LaunchAsyncUpdate(!skipping);
+
 	lastSimFrameTime = spring_gettime();
 	gu->avgSimFrameTime = mix(gu->avgSimFrameTime, (lastSimFrameTime - lastFrameTime).toMilliSecsf(), 0.05f);
 	gu->avgSimFrameTime = std::max(gu->avgSimFrameTime, 0.01f);
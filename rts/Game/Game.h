@@ -57,7 +57,9 @@ private:
 	void AddTimedJobs();
 
 	void LoadMap(const std::string& mapName);
+	void ParseDefs(LuaParser* defsParser);
 	void LoadDefs(LuaParser* defsParser);
+	void LoadDefsUnsynced();
 	void PreLoadSimulation(LuaParser* defsParser);
 	void PostLoadSimulation(LuaParser* defsParser);
 	void PreLoadRendering();
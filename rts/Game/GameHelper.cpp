@@ -367,20 +367,22 @@ static inline void QueryUnits(TFilter filter, TQuery& query)
 {
 	QuadFieldQuery qfQuery;
 	quadField.GetQuads(qfQuery, query.pos, query.radius);
-	const int tempNum = gs->GetTempNum();
+
+	const int curThread = qfQuery.threadOwner;
+	const int tempNum = gs->GetMtTempNum(curThread);
 
 	for (int t = 0; t < teamHandler.ActiveAllyTeams(); ++t) { //FIXME
 		if (!filter.Team(t))
 			continue;
 
 		for (const int qi: *qfQuery.quads) {
-			const auto& allyTeamUnits = quadField.GetQuad(qi).teamUnits[t];
+			const auto allyTeamUnits = quadField.GetQuad(qi).GetTeamUnits(t);
 
 			for (CUnit* u: allyTeamUnits) {
-				if (u->tempNum == tempNum)
+				if (u->mtTempNum[curThread] == tempNum)
 					continue;
 
-				u->tempNum = tempNum;
+				u->mtTempNum[curThread] = tempNum;
 
 				if (!filter.Unit(u))
 					continue;
@@ -680,92 +682,102 @@ size_t CGameHelper::GenerateWeaponTargets(const CWeapon* weapon, const CUnit* av
 	targets.clear();
 	targets.reserve(32);
 
-	const int tempNum = gs->GetTempNum();
+	{
+		const int curThread = qfQuery.threadOwner;
+		const int tempNum = gs->GetMtTempNum(curThread);
 
-	for (int t = 0; t < teamHandler.ActiveAllyTeams(); ++t) {
-		if (teamHandler.Ally(weaponOwner->allyteam, t))
-			continue;
+		// gather the unique candidates first; AllowWeaponTarget may run Lua
+		// area queries which restamp units with the same per-thread number
+		for (int t = 0; t < teamHandler.ActiveAllyTeams(); ++t) {
+			if (teamHandler.Ally(weaponOwner->allyteam, t))
+				continue;
 
-		for (const int qi: *qfQuery.quads) {
-			const std::vector<CUnit*>& allyTeamUnits = quadField.GetQuad(qi).teamUnits[t];
+			for (const int qi: *qfQuery.quads) {
+				for (CUnit* targetUnit: quadField.GetQuad(qi).GetTeamUnits(t)) {
+					if (targetUnit->mtTempNum[curThread] == tempNum)
+						continue;
 
-			for (CUnit* targetUnit: allyTeamUnits) {
-				if (targetUnit->tempNum == tempNum)
-					continue;
+					targetUnit->mtTempNum[curThread] = tempNum;
+					targets.emplace_back(0.0f, targetUnit);
+				}
+			}
+		}
+	}
 
-				targetUnit->tempNum = tempNum;
+	{
+		// candidates are compacted in place, preserving their order
+		size_t numTargets = 0;
 
-				if (!weapon->TestTarget(testPos, SWeaponTarget(targetUnit)))
-					continue;
+		for (size_t i = 0, n = targets.size(); i < n; i++) {
+			CUnit* targetUnit = targets[i].second;
 
-				const unsigned short targetLOSState = targetUnit->losStatus[weaponOwner->allyteam];
+			if (!weapon->TestTarget(testPos, SWeaponTarget(targetUnit)))
+				continue;
 
-				float targetPriority = tgtPriorityMults[(targetUnit == avoidUnit) * 1];
-				float3 targetPos;
+			const unsigned short targetLOSState = targetUnit->losStatus[weaponOwner->allyteam];
 
-				if (targetLOSState & LOS_INLOS) {
-					targetPos = targetUnit->aimPos;
-				} else if (targetLOSState & LOS_INRADAR) {
-					targetPos = weapon->GetUnitPositionWithError(targetUnit);
-					targetPriority *= tgtPriorityMults[1];
-				} else {
-					continue;
-				}
+			float targetPriority = tgtPriorityMults[(targetUnit == avoidUnit) * 1];
+			float3 targetPos;
 
-				const float modRange = weapon->GetRange2D(rangeBoost, (targetPos.y - aimPosHeight) * heightMod);
-				const float sqDist2D = ownerPos.SqDistance2D(targetPos);
+			if (targetLOSState & LOS_INLOS) {
+				targetPos = targetUnit->aimPos;
+			} else if (targetLOSState & LOS_INRADAR) {
+				targetPos = weapon->GetUnitPositionWithError(targetUnit);
+				targetPriority *= tgtPriorityMults[1];
+			} else {
+				continue;
+			}
 
-				if (sqDist2D > Square(modRange))
-					continue;
+			const float modRange = weapon->GetRange2D(rangeBoost, (targetPos.y - aimPosHeight) * heightMod);
+			const float sqDist2D = ownerPos.SqDistance2D(targetPos);
 
-				const float3 worldTargetDir = (targetPos - ownerPos).SafeNormalize();
-				const float angleOffset =  (1.f - worldMainDir.dot(worldTargetDir));
-				const float angleMod = angleOffset * weaponAimAdjustPriority + 1.f;
+			if (sqDist2D > Square(modRange))
+				continue;
 
-				// Strengthen focus towards the front, desire should weaken quadratically rather
-				// than linearly otherwise target distance can too easily cause units to choose a
-				// target that requires turning around to fire at.
-				const float angleMul = angleMod*angleMod;
+			const float3 worldTargetDir = (targetPos - ownerPos).SafeNormalize();
+			const float angleOffset =  (1.f - worldMainDir.dot(worldTargetDir));
+			const float angleMod = angleOffset * weaponAimAdjustPriority + 1.f;
 
-				const float dist2D = math::sqrt(sqDist2D);
-				const float rangeMul = (dist2D * weaponDef->proximityPriority + modRange * 0.4f + 100.0f);
-				const float damageMul = std::max(0.0001f, weaponDmg->Get(targetUnit->armorType) * targetUnit->curArmorMultiple);
+			// Strengthen focus towards the front, desire should weaken quadratically rather
+			// than linearly otherwise target distance can too easily cause units to choose a
+			// target that requires turning around to fire at.
+			const float angleMul = angleMod*angleMod;
 
-				targetPriority *= angleMul;
-				targetPriority *= rangeMul;
-				targetPriority *= tgtPriorityMults[(dist2D > baseRange) * 6];
+			const float dist2D = math::sqrt(sqDist2D);
+			const float rangeMul = (dist2D * weaponDef->proximityPriority + modRange * 0.4f + 100.0f);
+			const float damageMul = std::max(0.0001f, weaponDmg->Get(targetUnit->armorType) * targetUnit->curArmorMultiple);
 
-				if (targetLOSState & LOS_INLOS) {
-					targetPriority *= (secDamage + targetUnit->health);
+			targetPriority *= angleMul;
+			targetPriority *= rangeMul;
+			targetPriority *= tgtPriorityMults[(dist2D > baseRange) * 6];
 
-					if (paralyzer && targetUnit->paralyzeDamage > (modInfo.paralyzeOnMaxHealth? targetUnit->maxHealth: targetUnit->health))
-						targetPriority *= tgtPriorityMults[5];
+			if (targetLOSState & LOS_INLOS) {
+				targetPriority *= (secDamage + targetUnit->health);
 
-					if (weapon->hasTargetWeight)
-						targetPriority *= weapon->TargetWeight(targetUnit);
+				if (paralyzer && targetUnit->paralyzeDamage > (modInfo.paralyzeOnMaxHealth? targetUnit->maxHealth: targetUnit->health))
+					targetPriority *= tgtPriorityMults[5];
 
-				} else {
-					targetPriority *= (secDamage + 10000.0f);
-				}
+				if (weapon->hasTargetWeight)
+					targetPriority *= weapon->TargetWeight(targetUnit);
 
-				if (targetLOSState & LOS_PREVLOS) {
-					targetPriority /= (damageMul * targetUnit->power * (0.7f + gsRNG.NextFloat() * 0.6f));
-					targetPriority *= tgtPriorityMults[((targetUnit->category & weapon->badTargetCategory) != 0) * 2];
-					targetPriority *= tgtPriorityMults[(targetUnit->IsCrashing()) * 3];
-					targetPriority *= tgtPriorityMults[(targetUnit == lastAttacker) * 4];
-				}
-
-				const bool allowTarget = eventHandler.AllowWeaponTarget(weaponOwner->id, targetUnit->id, weapon->weaponNum, weaponDef->id, &targetPriority);
+			} else {
+				targetPriority *= (secDamage + 10000.0f);
+			}
 
-				// Lua call may have changed tempNum, so needs to be set again
-				targetUnit->tempNum = tempNum;
+			if (targetLOSState & LOS_PREVLOS) {
+				targetPriority /= (damageMul * targetUnit->power * (0.7f + gsRNG.NextFloat() * 0.6f));
+				targetPriority *= tgtPriorityMults[((targetUnit->category & weapon->badTargetCategory) != 0) * 2];
+				targetPriority *= tgtPriorityMults[(targetUnit->IsCrashing()) * 3];
+				targetPriority *= tgtPriorityMults[(targetUnit == lastAttacker) * 4];
+			}
 
-				if (!allowTarget)
-					continue;
+			if (!eventHandler.AllowWeaponTarget(weaponOwner->id, targetUnit->id, weapon->weaponNum, weaponDef->id, &targetPriority))
+				continue;
 
-				targets.emplace_back(targetPriority, targetUnit);
-			}
+			targets[numTargets++] = {targetPriority, targetUnit};
 		}
+
+		targets.resize(numTargets);
 	}
 
 	std::stable_sort(targets.begin(), targets.end(), [](const std::pair<float, CUnit*>& a, const std::pair<float, CUnit*>& b) { return (a.first < b.first); });
@@ -10,6 +10,7 @@
 #include "Sim/Misc/CollisionHandler.h"
 #include "Sim/Misc/CollisionVolume.h"
 #include "Sim/Misc/GeometricObjects.h"
+#include "Sim/Misc/GlobalSynced.h"
 #include "Sim/Misc/LosHandler.h"
 #include "Sim/Misc/QuadField.h"
 #include "Sim/Misc/TeamHandler.h"
@@ -19,8 +20,11 @@
 #include "Sim/Weapons/PlasmaRepulser.h"
 #include "Sim/Weapons/WeaponDef.h"
 #include "System/SpringMath.h"
+#include "System/Threading/ThreadPool.h"
 
 #include <algorithm>
+#include <array>
+#include <cstdint>
 #include <vector>
 
 //////////////////////////////////////////////////////////////////////
@@ -158,6 +162,159 @@ inline static bool TestTrajectoryConeHelper(
 
 
 
+/**
+ * objects that Test*Cone might hit, gathered (once each) from all quads
+ * along the ray and stored as SoA so that the cheap bounding-sphere test
+ * in MarkConeCandidates runs as a single vectorizable loop; only objects
+ * it does not rule out need the exact (per-volume-type, matrix-inverting)
+ * surface-distance tests in Test*ConeHelper
+ */
+struct ConeCandidates {
+	void Clear() {
+		objects.clear();
+		posx.clear();
+		posy.clear();
+		posz.clear();
+		radii.clear();
+		masks.clear();
+	}
+
+	void Add(const CSolidObject* obj) {
+		const CollisionVolume& cv = obj->collisionVolume;
+		const float3 cvPos = cv.GetWorldSpacePos(obj);
+
+		objects.push_back(obj);
+		posx.push_back(cvPos.x);
+		posy.push_back(cvPos.y);
+		posz.push_back(cvPos.z);
+		radii.push_back(cv.GetBoundingRadius());
+	}
+
+	size_t size() const { return objects.size(); }
+
+	std::vector<const CSolidObject*> objects;
+
+	std::vector<float> posx;
+	std::vector<float> posy;
+	std::vector<float> posz;
+	std::vector<float> radii;
+
+	std::vector<std::uint8_t> masks;
+};
+
+static std::array<ConeCandidates, ThreadPool::MAX_THREADS> coneCandidates;
+
+
+static void GatherConeCandidates(
+	ConeCandidates& candidates,
+	const std::vector<int>& quads,
+	int allyteam,
+	int traceFlags,
+	const CUnit* owner
+) {
+	const bool scanForAllies   = ((traceFlags & Collision::NOFRIENDLIES) == 0);
+	const bool scanForNeutrals = ((traceFlags & Collision::NONEUTRALS  ) == 0);
+	const bool scanForFeatures = ((traceFlags & Collision::NOFEATURES  ) == 0);
+
+	const int curThread = ThreadPool::GetThreadNum();
+	const int tempNum = gs->GetMtTempNum(curThread);
+
+	// objects can overlap several quads, the stamps make sure each is tested once
+	const auto AddCandidate = [&](CSolidObject* obj) {
+		if (obj->mtTempNum[curThread] == tempNum)
+			return;
+		if (!obj->HasCollidableStateBit(CSolidObject::CSTATE_BIT_QUADMAPRAYS))
+			return;
+
+		obj->mtTempNum[curThread] = tempNum;
+		candidates.Add(obj);
+	};
+
+	candidates.Clear();
+
+	for (const int quadIdx: quads) {
+		const CQuadField::Quad& quad = quadField.GetQuad(quadIdx);
+
+		if (scanForAllies) {
+			for (CUnit* u: quad.GetTeamUnits(allyteam)) {
+				if (u == owner)
+					continue;
+
+				AddCandidate(u);
+			}
+		}
+
+		if (scanForNeutrals) {
+			for (CUnit* u: quad.units) {
+				if (!u->IsNeutral())
+					continue;
+				if (u == owner)
+					continue;
+
+				AddCandidate(u);
+			}
+		}
+
+		if (scanForFeatures) {
+			for (CFeature* f: quad.features) {
+				AddCandidate(f);
+			}
+		}
+	}
+}
+
+/**
+ * sets masks[i] for every candidate whose bounding sphere comes within the
+ * cone (or trajectory) radius of either point tested by Test*ConeHelper;
+ * the surface distance to a point is never less than its distance to the
+ * volume center minus the bounding radius, so unmarked candidates cannot
+ * pass the exact test (a small slack absorbs rounding differences between
+ * GetWorldSpacePos and the transform-matrix path taken by the exact test)
+ */
+static void MarkConeCandidates(
+	ConeCandidates& candidates,
+	const float3& tstPos,
+	const float3& tstDir,
+	float length,
+	float linear,
+	float quadratic,
+	float spread,
+	float baseSize
+) {
+	const size_t numCandidates = candidates.size();
+
+	candidates.masks.resize(numCandidates);
+
+	const float* posx = candidates.posx.data();
+	const float* posy = candidates.posy.data();
+	const float* posz = candidates.posz.data();
+	const float* radii = candidates.radii.data();
+
+	std::uint8_t* masks = candidates.masks.data();
+
+	for (size_t i = 0; i < numCandidates; i++) {
+		const float relx = posx[i] - tstPos.x;
+		const float rely = posy[i] - tstPos.y;
+		const float relz = posz[i] - tstPos.z;
+
+		const float relDst = std::min(std::max(relx * tstDir.x + rely * tstDir.y + relz * tstDir.z, 0.0f), length);
+		const float maxDst = radii[i] + relDst * spread + baseSize + 1.0f;
+
+		// offsets between the volume center and the theoretical impact position
+		const float hitx = relx - tstDir.x * relDst;
+		const float hity = rely - tstDir.y * relDst - (quadratic * relDst * relDst + linear * relDst);
+		const float hitz = relz - tstDir.z * relDst;
+
+		const float tstDstSq = relx * relx + rely * rely + relz * relz;
+		const float hitDstSq = hitx * hitx + hity * hity + hitz * hitz;
+
+		masks[i] = (tstDstSq <= (maxDst * maxDst)) | (hitDstSq <= (maxDst * maxDst));
+	}
+}
+
+
+
+
 //////////////////////////////////////////////////////////////////////
 // Raytracing
 //////////////////////////////////////////////////////////////////////
@@ -491,48 +648,17 @@ bool TestCone(
 	if (qfQuery.quads->empty())
 		return true;
 
-	const bool scanForAllies   = ((traceFlags & Collision::NOFRIENDLIES) == 0);
-	const bool scanForNeutrals = ((traceFlags & Collision::NONEUTRALS  ) == 0);
-	const bool scanForFeatures = ((traceFlags & Collision::NOFEATURES  ) == 0);
-
-	for (const int quadIdx: *qfQuery.quads) {
-		const CQuadField::Quad& quad = quadField.GetQuad(quadIdx);
-
-		if (scanForAllies) {
-			for (const CUnit* u: quad.teamUnits[allyteam]) {
-				if (u == owner)
-					continue;
-				if (!u->HasCollidableStateBit(CSolidObject::CSTATE_BIT_QUADMAPRAYS))
-					continue;
-
-				if (TestConeHelper(from, dir, length, spread, u))
-					return true;
-			}
-		}
+	ConeCandidates& candidates = coneCandidates[qfQuery.threadOwner];
 
-		if (scanForNeutrals) {
-			for (const CUnit* u: quad.units) {
-				if (!u->IsNeutral())
-					continue;
-				if (u == owner)
-					continue;
-				if (!u->HasCollidableStateBit(CSolidObject::CSTATE_BIT_QUADMAPRAYS))
-					continue;
+	GatherConeCandidates(candidates, *qfQuery.quads, allyteam, traceFlags, owner);
+	MarkConeCandidates(candidates, from, dir, length, 0.0f, 0.0f, spread, 1.0f);
 
-				if (TestConeHelper(from, dir, length, spread, u))
-					return true;
-			}
-		}
+	for (size_t i = 0, n = candidates.size(); i < n; i++) {
+		if (!candidates.masks[i])
+			continue;
 
-		if (scanForFeatures) {
-			for (const CFeature* f: quad.features) {
-				if (!f->HasCollidableStateBit(CSolidObject::CSTATE_BIT_QUADMAPRAYS))
-					continue;
-
-				if (TestConeHelper(from, dir, length, spread, f))
-					return true;
-			}
-		}
+		if (TestConeHelper(from, dir, length, spread, candidates.objects[i]))
+			return true;
 	}
 
 	return false;
@@ -557,52 +683,18 @@ bool TestTrajectoryCone(
 	if (qfQuery.quads->empty())
 		return true;
 
-	const bool scanForAllies   = ((traceFlags & Collision::NOFRIENDLIES) == 0);
-	const bool scanForNeutrals = ((traceFlags & Collision::NONEUTRALS  ) == 0);
-	const bool scanForFeatures = ((traceFlags & Collision::NOFEATURES  ) == 0);
-
-	for (const int quadIdx: *qfQuery.quads) {
-		const CQuadField::Quad& quad = quadField.GetQuad(quadIdx);
-
-		// friendly units in this quad
-		if (scanForAllies) {
-			for (const CUnit* u: quad.teamUnits[allyteam]) {
-				if (u == owner)
-					continue;
-				if (!u->HasCollidableStateBit(CSolidObject::CSTATE_BIT_QUADMAPRAYS))
-					continue;
+	ConeCandidates& candidates = coneCandidates[qfQuery.threadOwner];
 
-				if (TestTrajectoryConeHelper(from, dir, length, linear, quadratic, spread, 0.0f, u))
-					return true;
+	// friendly and neutral units plus features along the ray
+	GatherConeCandidates(candidates, *qfQuery.quads, allyteam, traceFlags, owner);
+	MarkConeCandidates(candidates, from, dir, length, linear, quadratic, spread, 0.0f);
 
-			}
-		}
+	for (size_t i = 0, n = candidates.size(); i < n; i++) {
+		if (!candidates.masks[i])
+			continue;
 
-		// neutral units in this quad
-		if (scanForNeutrals) {
-			for (const CUnit* u: quad.units) {
-				if (!u->IsNeutral())
-					continue;
-				if (u == owner)
-					continue;
-				if (!u->HasCollidableStateBit(CSolidObject::CSTATE_BIT_QUADMAPRAYS))
-					continue;
-
-				if (TestTrajectoryConeHelper(from, dir, length, linear, quadratic, spread, 0.0f, u))
-					return true;
-			}
-		}
-
-		// features in this quad
-		if (scanForFeatures) {
-			for (const CFeature* f: quad.features) {
-				if (!f->HasCollidableStateBit(CSolidObject::CSTATE_BIT_QUADMAPRAYS))
-					continue;
-
-				if (TestTrajectoryConeHelper(from, dir, length, linear, quadratic, spread, 0.0f, f))
-					return true;
-			}
-		}
+		if (TestTrajectoryConeHelper(from, dir, length, linear, quadratic, spread, 0.0f, candidates.objects[i]))
+			return true;
 	}
 
 	return false;
@@ -480,7 +480,7 @@ static void DrawInfoText(TypedRenderBuffer<VA_TYPE_C   >& rb)
 	constexpr const char* avgFmtStr = "[3] {Sim,Update,Draw}FrameTime={%s%2.1f, %s%2.1f, %s%2.1f (GL=%2.1f)}ms";
 	constexpr const char* spdFmtStr = "[4] {Current,Wanted}SimSpeedMul={%2.2f, %2.2f}x";
 	constexpr const char* sfxFmtStr = "[5] {Synced,Unsynced}Projectiles={%u,%u} Particles=%u Saturation=%.1f";
-	constexpr const char* pfsFmtStr = "[6] (%s)PFS-updates queued: {%i, %i}";
+	constexpr const char* pfsFmtStr = "[6] (%s)PFS-updates queued: {%i, %i} oldest: {%i, %i} frames";
 	constexpr const char* luaFmtStr = "[7] Lua-allocated memory: %.1fMB (%.1fK allocs : %.5u usecs : %.1u states)";
 	constexpr const char* gpuFmtStr = "[8] GPU-allocated memory: %.1fMB / %.1fMB";
 	constexpr const char* sopFmtStr = "[9] SOP-allocated memory: {U,F,P,W}={%.1f/%.1f, %.1f/%.1f, %.1f/%.1f, %.1f/%.1f}KB";
@@ -504,16 +504,17 @@ static void DrawInfoText(TypedRenderBuffer<VA_TYPE_C   >& rb)
 
 	{
 		const int2 pfsUpdates = pm->GetNumQueuedUpdates();
+		const int2 pfsAges = pm->GetMaxQueuedUpdateAge();
 
 		switch (pm->GetPathFinderType()) {
 			case NOPFS_TYPE: {
-				font->glFormat(0.01f, 0.12f, 0.5f, DBG_FONT_FLAGS | FONT_BUFFERED, pfsFmtStr, "NO", pfsUpdates.x, pfsUpdates.y);
+				font->glFormat(0.01f, 0.12f, 0.5f, DBG_FONT_FLAGS | FONT_BUFFERED, pfsFmtStr, "NO", pfsUpdates.x, pfsUpdates.y, pfsAges.x, pfsAges.y);
 			} break;
 			case HAPFS_TYPE: {
-				font->glFormat(0.01f, 0.12f, 0.5f, DBG_FONT_FLAGS | FONT_BUFFERED, pfsFmtStr, "HA", pfsUpdates.x, pfsUpdates.y);
+				font->glFormat(0.01f, 0.12f, 0.5f, DBG_FONT_FLAGS | FONT_BUFFERED, pfsFmtStr, "HA", pfsUpdates.x, pfsUpdates.y, pfsAges.x, pfsAges.y);
 			} break;
 			case QTPFS_TYPE: {
-				font->glFormat(0.01f, 0.12f, 0.5f, DBG_FONT_FLAGS | FONT_BUFFERED, pfsFmtStr, "QT", pfsUpdates.x, pfsUpdates.y);
+				font->glFormat(0.01f, 0.12f, 0.5f, DBG_FONT_FLAGS | FONT_BUFFERED, pfsFmtStr, "QT", pfsUpdates.x, pfsUpdates.y, pfsAges.x, pfsAges.y);
 			} break;
 			default: {
 			} break;
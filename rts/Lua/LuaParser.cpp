@@ -5,6 +5,7 @@
 
 #include <algorithm>
 #include <climits>
+#include <cstring>
 
 #include "lib/streflop/streflop_cond.h"
 
@@ -23,6 +24,7 @@
 #include "System/FileSystem/FileHandler.h"
 #include "System/Misc/SpringTime.h"
 #include "System/ContainerUtil.h"
+#include "System/UnorderedMap.hpp"
 #include "System/TimeProfiler.h"
 #include "System/ScopedFPUSettings.h"
 #include "System/StringUtil.h"
@@ -292,6 +294,319 @@ bool LuaParser::Execute()
 }
 
 
+/******************************************************************************/
+//
+//  Table snapshots
+//
+
+enum SnapshotTag {
+	SNAPSHOT_TAG_END      = 0,
+	SNAPSHOT_TAG_NUMBER   = 1,
+	SNAPSHOT_TAG_STRING   = 2,
+	SNAPSHOT_TAG_BOOLEAN  = 3,
+	SNAPSHOT_TAG_TABLE    = 4,
+	SNAPSHOT_TAG_TABLEREF = 5,
+};
+
+// bounds the recursion (and Lua stack) depth of both directions
+static constexpr int MAX_SNAPSHOT_DEPTH = 32;
+
+// tables get ids in the order they are first reached, any later occurrence
+// (shared subtables as well as cycles) is written as a reference to its id
+using SnapshotTableIds = spring::unsynced_map<const void*, std::uint32_t>;
+
+// table holding the rebuilt tables by id (plus one) on the Lua stack
+struct SnapshotTableList {
+	int index;
+	std::uint32_t size;
+};
+
+struct SnapshotKey {
+	int type;
+	lua_Number num;
+	std::string str;
+
+	bool operator < (const SnapshotKey& k) const {
+		if (type != k.type)
+			return (type < k.type);
+		if (type == SNAPSHOT_TAG_STRING)
+			return (str < k.str);
+		return (num < k.num);
+	}
+};
+
+template<typename T> static void AppendSnapshotData(std::vector<std::uint8_t>& data, const T& v)
+{
+	const std::uint8_t* p = reinterpret_cast<const std::uint8_t*>(&v);
+	data.insert(data.end(), p, p + sizeof(T));
+}
+
+template<typename T> static bool ReadSnapshotData(const std::uint8_t*& ptr, const std::uint8_t* end, T& v)
+{
+	if ((end - ptr) < std::ptrdiff_t(sizeof(T)))
+		return false;
+
+	std::memcpy(&v, ptr, sizeof(T));
+	ptr += sizeof(T);
+	return true;
+}
+
+static int GetSnapshotTag(lua_State* L, int index)
+{
+	switch (lua_type(L, index)) {
+		case LUA_TNUMBER : return SNAPSHOT_TAG_NUMBER;
+		case LUA_TSTRING : return SNAPSHOT_TAG_STRING;
+		case LUA_TBOOLEAN: return SNAPSHOT_TAG_BOOLEAN;
+		case LUA_TTABLE  : return SNAPSHOT_TAG_TABLE;
+		default          : break;
+	}
+
+	return SNAPSHOT_TAG_END;
+}
+
+static bool SerializeTable(lua_State* L, int table, std::vector<std::uint8_t>& data, SnapshotTableIds& tables, int depth);
+static bool SerializeValue(lua_State* L, int index, int tag, std::vector<std::uint8_t>& data, SnapshotTableIds& tables, int depth)
+{
+	data.push_back(tag);
+
+	switch (tag) {
+		case SNAPSHOT_TAG_NUMBER: {
+			AppendSnapshotData(data, lua_tonumber(L, index));
+		} break;
+		case SNAPSHOT_TAG_STRING: {
+			size_t len = 0;
+			const char* str = lua_tolstring(L, index, &len);
+
+			AppendSnapshotData(data, std::uint32_t(len));
+			data.insert(data.end(), str, str + len);
+		} break;
+		case SNAPSHOT_TAG_BOOLEAN: {
+			data.push_back(lua_toboolean(L, index));
+		} break;
+		case SNAPSHOT_TAG_TABLE: {
+			const auto iter = tables.find(lua_topointer(L, index));
+
+			if (iter == tables.end())
+				return (SerializeTable(L, index, data, tables, depth + 1));
+
+			data.back() = SNAPSHOT_TAG_TABLEREF;
+			AppendSnapshotData(data, iter->second);
+		} break;
+		default: {
+			assert(false);
+		} break;
+	}
+
+	return true;
+}
+
+static bool SerializeTable(lua_State* L, int table, std::vector<std::uint8_t>& data, SnapshotTableIds& tables, int depth)
+{
+	if (depth > MAX_SNAPSHOT_DEPTH || !lua_checkstack(L, 4))
+		return false;
+
+	tables.emplace(lua_topointer(L, table), std::uint32_t(tables.size()));
+
+	if (table < 0)
+		table = lua_gettop(L) + table + 1;
+
+	std::vector<SnapshotKey> keys;
+
+	for (lua_pushnil(L); lua_next(L, table) != 0; lua_pop(L, 1)) {
+		switch (GetSnapshotTag(L, -2)) {
+			case SNAPSHOT_TAG_NUMBER: {
+				keys.push_back({SNAPSHOT_TAG_NUMBER, lua_tonumber(L, -2), {}});
+			} break;
+			case SNAPSHOT_TAG_STRING: {
+				size_t len = 0;
+				const char* str = lua_tolstring(L, -2, &len);
+
+				keys.push_back({SNAPSHOT_TAG_STRING, 0.0f, {str, len}});
+			} break;
+			case SNAPSHOT_TAG_BOOLEAN: {
+				keys.push_back({SNAPSHOT_TAG_BOOLEAN, lua_Number(lua_toboolean(L, -2)), {}});
+			} break;
+			default: {
+			} break;
+		}
+	}
+
+	std::sort(keys.begin(), keys.end());
+
+	for (const SnapshotKey& key: keys) {
+		switch (key.type) {
+			case SNAPSHOT_TAG_NUMBER : { lua_pushnumber(L, key.num); } break;
+			case SNAPSHOT_TAG_STRING : { lua_pushsstring(L, key.str); } break;
+			case SNAPSHOT_TAG_BOOLEAN: { lua_pushboolean(L, key.num != 0.0f); } break;
+			default: { assert(false); } break;
+		}
+
+		lua_pushvalue(L, -1);
+		lua_rawget(L, table);
+
+		const int valueTag = GetSnapshotTag(L, -1);
+
+		if (valueTag != SNAPSHOT_TAG_END) {
+			if (!SerializeValue(L, -2, key.type, data, tables, depth) || !SerializeValue(L, -1, valueTag, data, tables, depth)) {
+				lua_pop(L, 2);
+				return false;
+			}
+		}
+
+		lua_pop(L, 2);
+	}
+
+	data.push_back(SNAPSHOT_TAG_END);
+	return true;
+}
+
+static bool DeserializeTable(lua_State* L, const std::uint8_t*& ptr, const std::uint8_t* end, SnapshotTableList& tables, int depth);
+static bool DeserializeValue(lua_State* L, int tag, const std::uint8_t*& ptr, const std::uint8_t* end, SnapshotTableList& tables, int depth)
+{
+	switch (tag) {
+		case SNAPSHOT_TAG_NUMBER: {
+			lua_Number num = 0.0f;
+
+			if (!ReadSnapshotData(ptr, end, num))
+				return false;
+
+			lua_pushnumber(L, num);
+		} break;
+		case SNAPSHOT_TAG_STRING: {
+			std::uint32_t len = 0;
+
+			if (!ReadSnapshotData(ptr, end, len) || (end - ptr) < std::ptrdiff_t(len))
+				return false;
+
+			lua_pushlstring(L, reinterpret_cast<const char*>(ptr), len);
+			ptr += len;
+		} break;
+		case SNAPSHOT_TAG_BOOLEAN: {
+			std::uint8_t b = 0;
+
+			if (!ReadSnapshotData(ptr, end, b))
+				return false;
+
+			lua_pushboolean(L, b);
+		} break;
+		case SNAPSHOT_TAG_TABLE: {
+			return (DeserializeTable(L, ptr, end, tables, depth + 1));
+		} break;
+		case SNAPSHOT_TAG_TABLEREF: {
+			std::uint32_t id = 0;
+
+			// only tables that were already (at least partially) rebuilt
+			if (!ReadSnapshotData(ptr, end, id) || id >= tables.size)
+				return false;
+
+			lua_rawgeti(L, tables.index, id + 1);
+		} break;
+		default: {
+			return false;
+		} break;
+	}
+
+	return true;
+}
+
+static bool DeserializeTable(lua_State* L, const std::uint8_t*& ptr, const std::uint8_t* end, SnapshotTableList& tables, int depth)
+{
+	if (depth > MAX_SNAPSHOT_DEPTH || !lua_checkstack(L, 4))
+		return false;
+
+	lua_newtable(L);
+
+	// registered before its contents, which can refer back to it
+	lua_pushvalue(L, -1);
+	lua_rawseti(L, tables.index, ++tables.size);
+
+	for (std::uint8_t tag = SNAPSHOT_TAG_END; ReadSnapshotData(ptr, end, tag); ) {
+		if (tag == SNAPSHOT_TAG_END)
+			return true;
+		// tables are never used as keys
+		if (tag == SNAPSHOT_TAG_TABLE || tag == SNAPSHOT_TAG_TABLEREF || !DeserializeValue(L, tag, ptr, end, tables, depth))
+			return false;
+		if (!ReadSnapshotData(ptr, end, tag) || !DeserializeValue(L, tag, ptr, end, tables, depth))
+			return false;
+
+		lua_rawset(L, -3);
+	}
+
+	return false;
+}
+
+
+bool LuaParser::SerializeRoot(std::vector<std::uint8_t>& data)
+{
+	if (!IsValid() || rootRef == LUA_NOREF)
+		return false;
+
+	lua_settop(L, 0);
+	lua_rawgeti(L, LUA_REGISTRYINDEX, rootRef);
+
+	SnapshotTableIds tables;
+
+	const bool ret = lua_istable(L, -1) && SerializeTable(L, -1, data, tables, 0);
+
+	lua_settop(L, 0);
+	currentRef = LUA_NOREF;
+	return ret;
+}
+
+bool LuaParser::SerializeGlobal(const std::string& name, std::vector<std::uint8_t>& data)
+{
+	if (!IsValid())
+		return false;
+
+	lua_settop(L, 0);
+	lua_getglobal(L, name.c_str());
+
+	SnapshotTableIds tables;
+
+	const bool ret = lua_istable(L, -1) && SerializeTable(L, -1, data, tables, 0);
+
+	lua_settop(L, 0);
+	currentRef = LUA_NOREF;
+	return ret;
+}
+
+bool LuaParser::DeserializeRoot(const std::vector<std::uint8_t>& data)
+{
+	if (!IsValid()) {
+		errorLog = "could not initialize Lua library";
+		return false;
+	}
+
+	const std::uint8_t* ptr = data.data();
+	const std::uint8_t* end = data.data() + data.size();
+
+	lua_settop(L, 0);
+	currentRef = LUA_NOREF;
+
+	lua_newtable(L);
+
+	SnapshotTableList tables = {lua_gettop(L), 0};
+
+	if (!DeserializeTable(L, ptr, end, tables, 0) || ptr != end) {
+		lua_settop(L, 0);
+
+		errorLog = "corrupt table snapshot";
+		return false;
+	}
+
+	if (rootRef != LUA_NOREF)
+		luaL_unref(L, LUA_REGISTRYINDEX, rootRef);
+
+	rootRef = luaL_ref(L, LUA_REGISTRYINDEX);
+	initDepth = -1;
+
+	lua_settop(L, 0);
+	return (valid = true);
+}
+
+
+/******************************************************************************/
+
 void LuaParser::AddTable(LuaTable* tbl) { spring::VectorInsertUnique(tables, tbl); }
 void LuaParser::RemoveTable(LuaTable* tbl) { spring::VectorErase(tables, tbl); }
 
@@ -526,6 +841,7 @@ int LuaParser::Random(lua_State* L)
 {
 	// both US and DS depend on LuaParser via MapParser, etc
 	#if (!defined(UNITSYNC) && !defined(DEDICATED))
+	GetLuaParser(L)->usedSyncedRandom = true;
 
 	switch (lua_gettop(L)) {
 		case 0: {
@@ -3,6 +3,7 @@
 #ifndef LUA_PARSER_H
 #define LUA_PARSER_H
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -142,6 +143,19 @@ public:
 
 	const std::string& GetErrorLog() const { return errorLog; }
 
+	// binary snapshots of plain-data tables (numbers, strings, booleans and
+	// nested tables; anything else is dropped), keys are written in sorted
+	// order so the same content always produces the same snapshot; tables
+	// reachable more than once (shared subtables or cycles) stay shared
+	bool SerializeRoot(std::vector<std::uint8_t>& data);
+	bool SerializeGlobal(const std::string& name, std::vector<std::uint8_t>& data);
+	// replaces the root table by one rebuilt from a snapshot, does not run any code
+	bool DeserializeRoot(const std::vector<std::uint8_t>& data);
+
+	// true if the executed code drew from the synced RNG, i.e. its result
+	// depends on the game's random seed and advanced the generator
+	bool UsedSyncedRandom() const { return usedSyncedRandom; }
+
 	// for setting up the initial params table
 	void GetTable(int index,               bool overwrite = false);
 	void GetTable(const std::string& name, bool overwrite = false);
@@ -191,6 +205,7 @@ private:
 	bool valid = false;
 	bool lowerKeys = false; // convert all returned keys to lower case
 	bool lowerCppKeys = false; // convert strings in arguments keys to lower case
+	bool usedSyncedRandom = false;
 
 private:
 	// Weird call-outs
@@ -44,6 +44,7 @@
 #include "Sim/Misc/QuadField.h"
 #include "Sim/Misc/Wind.h"
 #include "Sim/MoveTypes/AAirMoveType.h"
+#include "Sim/MoveTypes/MoveMath/MoveMath.h"
 #include "Sim/Path/IPathManager.h"
 #include "Sim/Projectiles/ExplosionGenerator.h"
 #include "Sim/Projectiles/Projectile.h"
@@ -727,6 +728,9 @@ static int SetSolidObjectPieceCollisionVolumeData(lua_State* L, CSolidObject* ob
 	// piece volumes are not allowed to use discrete hit-testing
 	vol->InitShape(scales, offset, vType, CollisionVolume::COLVOL_HITTEST_CONT, pAxis);
 	vol->SetIgnoreHits(!luaL_checkboolean(L, 3));
+
+	obj->localModel.SetPieceBoundsNeedRecalc(lmp->GetLModelPieceIndex());
+	obj->localModel.UpdatePieceBounds();
 	return 0;
 }
 
@@ -740,6 +744,7 @@ static int SetSolidObjectPieceVisible(lua_State* L, CSolidObject* obj)
 		luaL_argerror(L, 2, "invalid piece");
 
 	lmp->SetScriptVisible(luaL_checkboolean(L, 3));
+	obj->localModel.UpdatePieceBounds();
 	return 0;
 }
 
@@ -3292,8 +3297,10 @@ int LuaSyncedCtrl::SetUnitPieceMatrix(lua_State* L)
 	if (LuaUtils::ParseFloatArray(L, 3, &mat.m[0], 16) == -1)
 		return 0;
 
-	if (lmp->SetPieceSpaceMatrix(mat))
+	if (lmp->SetPieceSpaceMatrix(mat)) {
 		lmp->SetDirty();
+		unit->localModel.UpdatePieceBounds();
+	}
 
 	lua_pushboolean(L, lmp->blockScriptAnims);
 	return 1;
@@ -6210,6 +6217,7 @@ int LuaSyncedCtrl::SetMapSquareTerrainType(lua_State* L)
 	const int ntt = luaL_checkint(L, 3);
 
 	readMap->GetTypeMapSynced()[tz * mapDims.hmapx + tx] = std::max(0, std::min(ntt, (CMapInfo::NUM_TERRAIN_TYPES - 1)));
+	CMoveMath::UpdateSpeedModRasters(hx, hz,  hx + 1, hz + 1);
 	pathManager->TerrainChange(hx, hz,  hx + 1, hz + 1,  TERRAINCHANGE_SQUARE_TYPEMAP_INDEX);
 
 	lua_pushnumber(L, ott);
@@ -6255,8 +6263,12 @@ int LuaSyncedCtrl::SetTerrainTypeData(lua_State* L)
 	// hardness changes do not require repathing
 	if (ttHardnessChanged)
 		mapDamage->TerrainTypeHardnessChanged(tti);
-	if (ttSpeedModChanged)
+	if (ttSpeedModChanged) {
+		// independent of the map-damage implementation, which may be a no-op;
+		// one pass over the whole map is cheaper than per-square raster updates
+		CMoveMath::UpdateSpeedModRasters(0, 0, mapDims.mapx - 1, mapDims.mapy - 1);
 		mapDamage->TerrainTypeSpeedModChanged(tti);
+	}
 
 	lua_pushboolean(L, true);
 	return 1;
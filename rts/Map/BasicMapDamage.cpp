@@ -9,6 +9,7 @@
 #include "Sim/Misc/LosHandler.h"
 #include "Sim/Misc/QuadField.h"
 #include "Sim/Misc/SmoothHeightMesh.h"
+#include "Sim/MoveTypes/MoveMath/MoveMath.h"
 #include "Sim/Units/Unit.h"
 #include "Sim/Units/UnitHandler.h"
 #include "Sim/Path/IPathManager.h"
@@ -213,32 +214,80 @@ void CBasicMapDamage::Explosion(const float3& pos, float strength, float radius)
 	}
 }
 
+SRectangle CBasicMapDamage::GetRecalcRect(int x1, int x2, int y1, int y2)
+{
+	x1 = std::max(x1, 0); x2 = std::clamp(x2, x1, mapDims.mapx);
+	y1 = std::max(y1, 0); y2 = std::clamp(y2, y1, mapDims.mapy);
+
+	return {x1, y1, x2, y2};
+}
+
 void CBasicMapDamage::RecalcArea(int x1, int x2, int y1, int y2)
 {
 	if (!readMap->GetHeightMapUpdated())
 		return;
 
-	x1 = std::max(x1, 0); x2 = std::clamp(x2, x1, mapDims.mapx);
-	y1 = std::max(y1, 0); y2 = std::clamp(y2, y1, mapDims.mapy);
-
 	// do not bother with zero-area updates
-	const SRectangle updRect(x1, y1, x2, y2);
+	const SRectangle updRect = GetRecalcRect(x1, x2, y1, y2);
 	if (updRect.GetArea() <= 0)
 		return;
 
 	readMap->UpdateHeightMapSynced(updRect);
-	featureHandler.TerrainChanged(x1, y1, x2, y2);
-	smoothGround.MapChanged(x1, y1, x2, y2);
+	featureHandler.TerrainChanged(updRect.x1, updRect.z1, updRect.x2, updRect.z2);
+	quadField.MarkActivity(float3(updRect.x1, 0.0f, updRect.z1) * SQUARE_SIZE, float3(updRect.x2 + 1, 0.0f, updRect.z2 + 1) * SQUARE_SIZE, gs->frameNum);
+	smoothGround.MapChanged(updRect.x1, updRect.z1, updRect.x2, updRect.z2);
 	{
 		SCOPED_TIMER("Sim::BasicMapDamage::Los");
 		losHandler->UpdateHeightMapSynced(updRect);
 	}
 	{
 		SCOPED_TIMER("Sim::BasicMapDamage::Path");
-		pathManager->TerrainChange(x1, y1, x2, y2, TERRAINCHANGE_DAMAGE_RECALCULATION);
+		CMoveMath::UpdateSpeedModRasters(updRect.x1, updRect.z1, updRect.x2, updRect.z2);
+		pathManager->TerrainChange(updRect.x1, updRect.z1, updRect.x2, updRect.z2, TERRAINCHANGE_DAMAGE_RECALCULATION);
 	}
 }
 
+void CBasicMapDamage::RecalcPendingAreas()
+{
+	if (pendingRecalcRects.empty())
+		return;
+
+	if (!readMap->GetHeightMapUpdated()) {
+		pendingRecalcRects.clear();
+		return;
+	}
+
+	// overlapping craters (e.g. from a salvo) are merged so that each square's
+	// derived data is only recomputed once, and the heightmap derivatives for
+	// all of them are built in a single parallel pass
+	pendingRecalcRects.Process(true);
+
+	const std::vector<SRectangle> updRects(pendingRecalcRects.cbegin(), pendingRecalcRects.cend());
+
+	readMap->UpdateHeightMapSynced(updRects);
+
+	for (const SRectangle& r: updRects) {
+		featureHandler.TerrainChanged(r.x1, r.z1, r.x2, r.z2);
+		quadField.MarkActivity(float3(r.x1, 0.0f, r.z1) * SQUARE_SIZE, float3(r.x2 + 1, 0.0f, r.z2 + 1) * SQUARE_SIZE, gs->frameNum);
+		smoothGround.MapChanged(r.x1, r.z1, r.x2, r.z2);
+	}
+	{
+		SCOPED_TIMER("Sim::BasicMapDamage::Los");
+		for (const SRectangle& r: updRects) {
+			losHandler->UpdateHeightMapSynced(r);
+		}
+	}
+	{
+		SCOPED_TIMER("Sim::BasicMapDamage::Path");
+		for (const SRectangle& r: updRects) {
+			CMoveMath::UpdateSpeedModRasters(r.x1, r.z1, r.x2, r.z2);
+			pathManager->TerrainChange(r.x1, r.z1, r.x2, r.z2, TERRAINCHANGE_DAMAGE_RECALCULATION);
+		}
+	}
+
+	pendingRecalcRects.clear();
+}
+
 
 void CBasicMapDamage::Update()
 {
@@ -279,9 +328,11 @@ void CBasicMapDamage::Update()
 		if (e.ttl != 0)
 			continue;
 
-		RecalcArea(e.x1 - 1, e.x2 + 1, e.y1 - 1, e.y2 + 1);
+		pendingRecalcRects.push_back(GetRecalcRect(e.x1 - 1, e.x2 + 1, e.y1 - 1, e.y2 + 1));
 	}
 
+	RecalcPendingAreas();
+
 
 	// pop explosions that are no longer being processed
 	while (explUpdateQueueIdx < explosionUpdateQueue.size()) {
@@ -4,6 +4,7 @@
 #define _BASIC_MAP_DAMAGE_H
 
 #include "MapDamage.h"
+#include "System/Misc/RectangleOverlapHandler.h"
 
 #include <vector>
 
@@ -21,6 +22,12 @@ public:
 	bool Disabled() const override { return false; }
 
 private:
+	/// clamps the area and returns it as (inclusive) heightmap rectangle, empty if nothing to update
+	static SRectangle GetRecalcRect(int x1, int x2, int y1, int y2);
+
+	/// recalculates all areas queued during this frame's Update in one batch
+	void RecalcPendingAreas();
+
 	void SetExplosionSquare(float v) {
 		explosionSquaresPool[explSquaresPoolIdx] = v;
 
@@ -61,6 +68,9 @@ private:
 	std::vector<float> explosionSquaresPool;
 	std::vector<Explo> explosionUpdateQueue;
 
+	// areas of explosions that expired this frame; merged before being recalculated
+	CRectangleOverlapHandler pendingRecalcRects;
+
 	static constexpr unsigned int CRATER_TABLE_SIZE = 200;
 	static constexpr unsigned int EXPLOSION_LIFETIME = 10;
 
@@ -503,32 +503,51 @@ void CReadMap::UpdateDraw(bool firstCall)
 
 void CReadMap::UpdateHeightMapSynced(const SRectangle& hgtMapRect)
 {
-	const bool initialize = (hgtMapRect == SRectangle{ 0, 0, mapDims.mapx, mapDims.mapy });
+	UpdateHeightMapSynced(std::vector<SRectangle>{hgtMapRect});
+}
+
+void CReadMap::UpdateHeightMapSynced(const std::vector<SRectangle>& hgtMapRects)
+{
+	if (hgtMapRects.empty())
+		return;
+
+	const bool initialize = (hgtMapRects.size() == 1 && hgtMapRects[0] == SRectangle{ 0, 0, mapDims.mapx, mapDims.mapy });
 
-	const int2 mins = {hgtMapRect.x1 - 1, hgtMapRect.z1 - 1};
-	const int2 maxs = {hgtMapRect.x2 + 1, hgtMapRect.z2 + 1};
+	std::vector<SRectangle> centerRects;
+	std::vector<SRectangle> cornerRects;
 
-	// NOTE:
-	//   rectangles are clamped to map{x,y}m1 which are the proper inclusive bounds for center heightmaps
-	//   parts of UpdateHeightMapUnsynced() (vertex normals, normal texture) however inclusively clamp to
-	//   map{x,y} since they index corner heightmaps, while UnsyncedHeightMapUpdate() EventClients should
-	//   already expect {x,z}2 <= map{x,y} and do internal clamping as well
-	const SRectangle centerRect = {std::max(mins.x, 0), std::max(mins.y, 0),  std::min(maxs.x, mapDims.mapxm1),  std::min(maxs.y, mapDims.mapym1)};
-	const SRectangle cornerRect = {std::max(mins.x, 0), std::max(mins.y, 0),  std::min(maxs.x, mapDims.mapx  ),  std::min(maxs.y, mapDims.mapy  )};
+	centerRects.reserve(hgtMapRects.size());
+	cornerRects.reserve(hgtMapRects.size());
 
-	UpdateCenterHeightmap(centerRect, initialize);
-	UpdateMipHeightmaps(centerRect, initialize);
-	UpdateFaceNormals(centerRect, initialize);
-	UpdateSlopemap(centerRect, initialize); // must happen after UpdateFaceNormals()!
+	for (const SRectangle& hgtMapRect: hgtMapRects) {
+		const int2 mins = {hgtMapRect.x1 - 1, hgtMapRect.z1 - 1};
+		const int2 maxs = {hgtMapRect.x2 + 1, hgtMapRect.z2 + 1};
+
+		// NOTE:
+		//   rectangles are clamped to map{x,y}m1 which are the proper inclusive bounds for center heightmaps
+		//   parts of UpdateHeightMapUnsynced() (vertex normals, normal texture) however inclusively clamp to
+		//   map{x,y} since they index corner heightmaps, while UnsyncedHeightMapUpdate() EventClients should
+		//   already expect {x,z}2 <= map{x,y} and do internal clamping as well
+		centerRects.push_back({std::max(mins.x, 0), std::max(mins.y, 0),  std::min(maxs.x, mapDims.mapxm1),  std::min(maxs.y, mapDims.mapym1)});
+		cornerRects.push_back({std::max(mins.x, 0), std::max(mins.y, 0),  std::min(maxs.x, mapDims.mapx  ),  std::min(maxs.y, mapDims.mapy  )});
+	}
+
+	UpdateCenterHeightmap(centerRects, initialize);
+	UpdateMipHeightmaps(centerRects, initialize);
+	UpdateFaceNormals(centerRects, initialize);
+	UpdateSlopemap(centerRects, initialize); // must happen after UpdateFaceNormals()!
 
 	// push the unsynced update; initial one without LOS check
 	if (initialize) {
-		unsyncedHeightMapUpdates.push_back(cornerRect);
-	} else {
+		unsyncedHeightMapUpdates.push_back(cornerRects[0]);
+		return;
+	}
+
+	for (size_t i = 0; i < cornerRects.size(); i++) {
 		#ifdef USE_HEIGHTMAP_DIGESTS
 		// convert heightmap rectangle to LOS-map space
 		const       int2 losMapSize = losHandler->los.size;
-		const SRectangle losMapRect = centerRect * (SQUARE_SIZE * losHandler->los.invDiv);
+		const SRectangle losMapRect = centerRects[i] * (SQUARE_SIZE * losHandler->los.invDiv);
 
 		// heightmap updated, increment digests (byte-overflow is intentional!)
 		for (int lmz = losMapRect.z1; lmz <= losMapRect.z2; ++lmz) {
@@ -542,7 +561,7 @@ void CReadMap::UpdateHeightMapSynced(const SRectangle& hgtMapRect)
 		}
 		#endif
 
-		HeightMapUpdateLOSCheck(cornerRect);
+		HeightMapUpdateLOSCheck(cornerRects[i]);
 	}
 }
 
@@ -594,42 +613,93 @@ void CReadMap::UpdateHeightBounds()
 	currHeightBounds.y = tempHeightBounds.y;
 }
 
-void CReadMap::UpdateCenterHeightmap(const SRectangle& rect, bool initialize) const
+/// runs f(y, x1, x2) for every row-span of <rects>; rows are distributed over threads, spans within a row are not
+template<typename F>
+static void ForEachRectRow(const std::vector<SRectangle>& rects, int minChunkSize, F&& f)
+{
+	int z1 = std::numeric_limits<int>::max();
+	int z2 = std::numeric_limits<int>::min();
+
+	for (const SRectangle& r: rects) {
+		z1 = std::min(z1, r.z1);
+		z2 = std::max(z2, r.z2);
+	}
+
+	for_mt_chunk(z1, z2 + 1, [&rects, &f](const int y) {
+		for (const SRectangle& r: rects) {
+			if (y < r.z1 || y > r.z2)
+				continue;
+
+			f(y, r.x1, r.x2);
+		}
+	}, -minChunkSize);
+}
+
+
+void CReadMap::UpdateCenterHeightmap(const std::vector<SRectangle>& rects, bool initialize) const
 {
+	using FloatBatch = xsimd::simd_type<float>;
+	constexpr int BATCH_SIZE = xsimd::simd_traits<float>::size;
+
 	const float* heightmapSynced = GetCornerHeightMapSynced();
 
-	for_mt_chunk(rect.z1, rect.z2 + 1, [heightmapSynced, &rect](const int y) {
-		for (int x = rect.x1; x <= rect.x2; x++) {
-			const int idxTL = (y + 0) * mapDims.mapxp1 + x + 0;
-			const int idxTR = (y + 0) * mapDims.mapxp1 + x + 1;
-			const int idxBL = (y + 1) * mapDims.mapxp1 + x + 0;
-			const int idxBR = (y + 1) * mapDims.mapxp1 + x + 1;
+	ForEachRectRow(rects, 256, [heightmapSynced](const int y, const int x1, const int x2) {
+		const float* rowT = &heightmapSynced[(y + 0) * mapDims.mapxp1];
+		const float* rowB = &heightmapSynced[(y + 1) * mapDims.mapxp1];
+		      float* rowC = &centerHeightMap[y * mapDims.mapx];
+
+		const FloatBatch scale(0.25f);
+
+		int x = x1;
 
+		// same summation order as the scalar tail, results are bit-identical
+		for (; (x + BATCH_SIZE - 1) <= x2; x += BATCH_SIZE) {
+			const FloatBatch hTL = xsimd::load_unaligned(rowT + x    );
+			const FloatBatch hTR = xsimd::load_unaligned(rowT + x + 1);
+			const FloatBatch hBL = xsimd::load_unaligned(rowB + x    );
+			const FloatBatch hBR = xsimd::load_unaligned(rowB + x + 1);
+
+			xsimd::store_unaligned(rowC + x, (hTL + hTR + hBL + hBR) * scale);
+		}
+
+		for (; x <= x2; x++) {
 			const float height =
-				heightmapSynced[idxTL] +
-				heightmapSynced[idxTR] +
-				heightmapSynced[idxBL] +
-				heightmapSynced[idxBR];
-			centerHeightMap[y * mapDims.mapx + x] = height * 0.25f;
+				rowT[x    ] +
+				rowT[x + 1] +
+				rowB[x    ] +
+				rowB[x + 1];
+			rowC[x] = height * 0.25f;
 		}
-	}, -256);
+	});
 }
 
 
-void CReadMap::UpdateMipHeightmaps(const SRectangle& rect, bool initialize)
+void CReadMap::UpdateMipHeightmaps(const std::vector<SRectangle>& rects, bool initialize)
 {
+	std::vector<SRectangle> mipRects(rects.size());
+
 	for (int i = 0; i < numHeightMipMaps - 1; i++) {
 		const int hmapx = mapDims.mapx >> i;
 
-		const int sx = (rect.x1 >> i) & (~1);
-		const int ex = (rect.x2 >> i);
-		const int sy = (rect.z1 >> i) & (~1);
-		const int ey = (rect.z2 >> i);
+		// rows of mipRects index the (half-size) destination level, x-bounds the source level
+		for (size_t j = 0; j < rects.size(); j++) {
+			const SRectangle& rect = rects[j];
+
+			const int sx = (rect.x1 >> i) & (~1);
+			const int ex = (rect.x2 >> i);
+			const int sy = (rect.z1 >> i) & (~1);
+			const int ey = (rect.z2 >> i);
 
-		float* topMipMap = mipPointerHeightMaps[i    ];
-		float* subMipMap = mipPointerHeightMaps[i + 1];
+			// empty (z2 < z1) if the source rows do not cover a full 2x2 block
+			mipRects[j] = {sx, sy / 2, ex, ((ey + 1) / 2) - 1};
+		}
+
+		const float* topMipMap = mipPointerHeightMaps[i    ];
+		      float* subMipMap = mipPointerHeightMaps[i + 1];
+
+		ForEachRectRow(mipRects, 128, [&](const int k, const int sx, const int ex) {
+			const int y = k * 2;
 
-		for (int y = sy; y < ey; y += 2) {
 			for (int x = sx; x < ex; x += 2) {
 				const float height =
 					topMipMap[(x    ) + (y    ) * hmapx] +
@@ -638,21 +708,28 @@ void CReadMap::UpdateMipHeightmaps(const SRectangle& rect, bool initialize)
 					topMipMap[(x + 1) + (y + 1) * hmapx];
 				subMipMap[(x / 2) + (y / 2) * hmapx / 2] = height * 0.25f;
 			}
-		}
+		});
 	}
 }
 
 
-void CReadMap::UpdateFaceNormals(const SRectangle& rect, bool initialize)
+void CReadMap::UpdateFaceNormals(const std::vector<SRectangle>& rects, bool initialize)
 {
 	const float* heightmapSynced = GetCornerHeightMapSynced();
 
-	const int z1 = std::max(             0, rect.z1 - 1);
-	const int x1 = std::max(             0, rect.x1 - 1);
-	const int z2 = std::min(mapDims.mapym1, rect.z2 + 1);
-	const int x2 = std::min(mapDims.mapxm1, rect.x2 + 1);
+	std::vector<SRectangle> normalRects;
+	normalRects.reserve(rects.size());
+
+	for (const SRectangle& rect: rects) {
+		const int z1 = std::max(             0, rect.z1 - 1);
+		const int x1 = std::max(             0, rect.x1 - 1);
+		const int z2 = std::min(mapDims.mapym1, rect.z2 + 1);
+		const int x2 = std::min(mapDims.mapxm1, rect.x2 + 1);
 
-	for_mt_chunk(z1, z2 + 1, [&](const int y) {
+		normalRects.push_back({x1, z1, x2, z2});
+	}
+
+	ForEachRectRow(normalRects, 64, [&](const int y, const int x1, const int x2) {
 		float3 fnTL;
 		float3 fnBR;
 
@@ -707,18 +784,25 @@ void CReadMap::UpdateFaceNormals(const SRectangle& rect, bool initialize)
 				centerNormalsUnsynced[y * mapDims.mapx + x] = centerNormalsSynced[y * mapDims.mapx + x];
 			}
 		}
-	}, -64);
+	});
 }
 
 
-void CReadMap::UpdateSlopemap(const SRectangle& rect, bool initialize)
+void CReadMap::UpdateSlopemap(const std::vector<SRectangle>& rects, bool initialize)
 {
-	const int sx = std::max(0,                 (rect.x1 / 2) - 1);
-	const int ex = std::min(mapDims.hmapx - 1, (rect.x2 / 2) + 1);
-	const int sy = std::max(0,                 (rect.z1 / 2) - 1);
-	const int ey = std::min(mapDims.hmapy - 1, (rect.z2 / 2) + 1);
+	std::vector<SRectangle> slopeRects;
+	slopeRects.reserve(rects.size());
+
+	for (const SRectangle& rect: rects) {
+		const int sx = std::max(0,                 (rect.x1 / 2) - 1);
+		const int ex = std::min(mapDims.hmapx - 1, (rect.x2 / 2) + 1);
+		const int sy = std::max(0,                 (rect.z1 / 2) - 1);
+		const int ey = std::min(mapDims.hmapy - 1, (rect.z2 / 2) + 1);
+
+		slopeRects.push_back({sx, sy, ex, ey});
+	}
 
-	for_mt_chunk(sy, ey + 1, [sx, ex](const int y) {
+	ForEachRectRow(slopeRects, 128, [](const int y, const int sx, const int ex) {
 		for (int x = sx; x <= ex; x++) {
 			const int idx0 = (y*2    ) * (mapDims.mapx) + x*2;
 			const int idx1 = (y*2 + 1) * (mapDims.mapx) + x*2;
@@ -749,7 +833,7 @@ void CReadMap::UpdateSlopemap(const SRectangle& rect, bool initialize)
 
 			slopeMap[y * mapDims.hmapx + x] = 1.0f - slope;
 		}
-	}, -128);
+	});
 }
 
 
@@ -102,6 +102,8 @@ public:
 	 * such as normals, centerheightmap and slopemap
 	 */
 	void UpdateHeightMapSynced(const SRectangle& hgtMapRect);
+	/// batched version for all rectangles changed within a frame, see CBasicMapDamage::Update
+	void UpdateHeightMapSynced(const std::vector<SRectangle>& hgtMapRects);
 	void UpdateLOS(const SRectangle& hgtMapRect);
 	void BecomeSpectator();
 	void UpdateDraw(bool firstCall);
@@ -233,10 +235,12 @@ private:
 	void UpdateHeightBounds(int syncFrame);
 	void UpdateTempHeightBoundsSIMD(size_t begin, size_t end);
 
-	void UpdateCenterHeightmap(const SRectangle& rect, bool initialize) const;
-	void UpdateMipHeightmaps(const SRectangle& rect, bool initialize);
-	void UpdateFaceNormals(const SRectangle& rect, bool initialize);
-	void UpdateSlopemap(const SRectangle& rect, bool initialize);
+	// each of these processes all (possibly overlapping) rectangles in one
+	// parallel pass over their rows; a row is only ever touched by one thread
+	void UpdateCenterHeightmap(const std::vector<SRectangle>& rects, bool initialize) const;
+	void UpdateMipHeightmaps(const std::vector<SRectangle>& rects, bool initialize);
+	void UpdateFaceNormals(const std::vector<SRectangle>& rects, bool initialize);
+	void UpdateSlopemap(const std::vector<SRectangle>& rects, bool initialize);
 
 	inline void HeightMapUpdateLOSCheck(const SRectangle& hgtMapRect);
 	inline bool HasHeightMapViewChanged(const int2 losMapPos);
@@ -313,6 +313,12 @@ void CGame::ClientReadNet()
 		const uint32_t dataLength = packet->length;
 		const uint8_t packetCode = inbuf[0];
 
+		// an asynchronous AI batch launched by the previous SimFrame may still
+		// be reading sim state, which any message other than a new frame (that
+		// waits for the batch itself) can change
+		if (packetCode != NETMSG_NEWFRAME && packetCode != NETMSG_KEYFRAME)
+			eoh->FinishAsyncUpdate();
+
 		switch (packetCode) {
 			case NETMSG_QUIT: {
 				ZoneScopedN("Net::Quit");
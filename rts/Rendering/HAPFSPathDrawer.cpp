@@ -238,8 +238,8 @@ void HAPFSPathDrawer::UpdateExtraTexture(int extraTex, int starty, int endy, int
 
 		case CLegacyInfoTextureHandler::drawPathCost: {
 			const PathNodeStateBuffer& maxResStates = pm->GetMaxResPF()->blockStates;
-			const PathNodeStateBuffer& medResStates = pm->GetMedResPS()->blockStates;
-			const PathNodeStateBuffer& lowResStates = pm->GetLowResPS()->blockStates;
+			const PathNodeStateBuffer& medResStates = pm->GetMedResPE()->blockStates;
+			const PathNodeStateBuffer& lowResStates = pm->GetLowResPE()->blockStates;
 
 			const unsigned int medResBlockSize = pm->GetMedResPE()->GetBlockSize(), medResBlocksX = pm->GetMedResPE()->GetNumBlocks().x;
 			const unsigned int lowResBlockSize = pm->GetLowResPE()->GetBlockSize(), lowResBlocksX = pm->GetLowResPE()->GetNumBlocks().x;
@@ -260,9 +260,9 @@ void HAPFSPathDrawer::UpdateExtraTexture(int extraTex, int starty, int endy, int
 					const unsigned int hy = ty << 1;
 
 					float gCost[3] = {
-						maxResStates.gCost[hy * mapDims.mapx + hx],
-						medResStates.gCost[(hy / medResBlockSize) * medResBlocksX + (hx / medResBlockSize)],
-						lowResStates.gCost[(hy / lowResBlockSize) * lowResBlocksX + (hx / lowResBlockSize)],
+						maxResStates.GetNodeGCost(hy * mapDims.mapx + hx),
+						medResStates.GetNodeGCost((hy / medResBlockSize) * medResBlocksX + (hx / medResBlockSize)),
+						lowResStates.GetNodeGCost((hy / lowResBlockSize) * lowResBlocksX + (hx / lowResBlockSize)),
 					};
 
 					if (std::isinf(gCost[0])) { gCost[0] = gCostMax[0]; }
@@ -352,7 +352,7 @@ void HAPFSPathDrawer::Draw(const HAPFS::CPathFinder* pf) const {
 			p1.z = sqr.y * SQUARE_SIZE;
 			p1.y = CGround::GetHeightAboveWater(p1.x, p1.z, false) + 15.0f;
 
-		const unsigned int dir = pf->blockStates.nodeMask[square] & PATHOPT_CARDINALS;
+		const unsigned int dir = pf->blockStates.GetNodeMask(square) & PATHOPT_CARDINALS;
 		const int2 obp = sqr - PF_DIRECTION_VECTORS_2D[dir];
 		float3 p2;
 			p2.x = obp.x * SQUARE_SIZE;
@@ -410,8 +410,8 @@ void HAPFSPathDrawer::Draw(const HAPFS::CPathEstimator* pe) const {
 				const int blockNr = ps->BlockPosToIdx(int2(x, z));
 
 				float3 p1;
-					p1.x = (blockStates.peNodeOffsets[md->pathType][blockNr].x) * SQUARE_SIZE;
-					p1.z = (blockStates.peNodeOffsets[md->pathType][blockNr].y) * SQUARE_SIZE;
+					p1.x = (blockStates.GetNodeOffset(md->pathType, blockNr).x) * SQUARE_SIZE;
+					p1.z = (blockStates.GetNodeOffset(md->pathType, blockNr).y) * SQUARE_SIZE;
 					p1.y = CGround::GetHeightAboveWater(p1.x, p1.z, false) + 10.0f;
 
 				if (!camera->InView(p1))
@@ -440,8 +440,8 @@ void HAPFSPathDrawer::Draw(const HAPFS::CPathEstimator* pe) const {
 						continue;
 
 					float3 p2;
-						p2.x = (blockStates.peNodeOffsets[md->pathType][obBlockNr].x) * SQUARE_SIZE;
-						p2.z = (blockStates.peNodeOffsets[md->pathType][obBlockNr].y) * SQUARE_SIZE;
+						p2.x = (blockStates.GetNodeOffset(md->pathType, obBlockNr).x) * SQUARE_SIZE;
+						p2.z = (blockStates.GetNodeOffset(md->pathType, obBlockNr).y) * SQUARE_SIZE;
 						p2.y = CGround::GetHeightAboveWater(p2.x, p2.z, false) + 10.0f;
 
 					glColor3f(1.0f / std::sqrt(nrmCost), 1.0f / nrmCost, 0.75f * drawLowResPE);
@@ -459,8 +459,8 @@ void HAPFSPathDrawer::Draw(const HAPFS::CPathEstimator* pe) const {
 				const int blockNr = ps->BlockPosToIdx(int2(x, z));
 
 				float3 p2;
-					p2.x = (blockStates.peNodeOffsets[md->pathType][blockNr].x) * SQUARE_SIZE;
-					p2.z = (blockStates.peNodeOffsets[md->pathType][blockNr].y) * SQUARE_SIZE;
+					p2.x = (blockStates.GetNodeOffset(md->pathType, blockNr).x) * SQUARE_SIZE;
+					p2.z = (blockStates.GetNodeOffset(md->pathType, blockNr).y) * SQUARE_SIZE;
 					p2.y = CGround::GetHeightAboveWater(p2.x, p2.z, false) + 10.0f;
 
 				font->SetTextColor(1.0f, 1.0f, 0.75f * drawLowResPE, 1.0f);
@@ -476,8 +476,8 @@ void HAPFSPathDrawer::Draw(const HAPFS::CPathEstimator* pe) const {
 				const int blockNr = ps->BlockPosToIdx(int2(x, z));
 
 				float3 p1;
-					p1.x = (blockStates.peNodeOffsets[md->pathType][blockNr].x) * SQUARE_SIZE;
-					p1.z = (blockStates.peNodeOffsets[md->pathType][blockNr].y) * SQUARE_SIZE;
+					p1.x = (blockStates.GetNodeOffset(md->pathType, blockNr).x) * SQUARE_SIZE;
+					p1.z = (blockStates.GetNodeOffset(md->pathType, blockNr).y) * SQUARE_SIZE;
 					p1.y = CGround::GetHeightAboveWater(p1.x, p1.z, false) + 10.0f;
 
 				if (!camera->InView(p1))
@@ -503,8 +503,8 @@ void HAPFSPathDrawer::Draw(const HAPFS::CPathEstimator* pe) const {
 					//	continue;
 
 					float3 p2;
-						p2.x = (blockStates.peNodeOffsets[md->pathType][obBlockNr].x) * SQUARE_SIZE;
-						p2.z = (blockStates.peNodeOffsets[md->pathType][obBlockNr].y) * SQUARE_SIZE;
+						p2.x = (blockStates.GetNodeOffset(md->pathType, obBlockNr).x) * SQUARE_SIZE;
+						p2.z = (blockStates.GetNodeOffset(md->pathType, obBlockNr).y) * SQUARE_SIZE;
 						p2.y = CGround::GetHeightAboveWater(p2.x, p2.z, false) + 10.0f;
 
 					// draw cost at middle of edge
@@ -542,7 +542,7 @@ void HAPFSPathDrawer::Draw(const HAPFS::CPathEstimator* pe) const {
 			const PathNode* ob = pe[i].openBlockBuffer.GetNode(idx);
 			const int blockNr = ob->nodeNum;
 
-			auto pathOptDir = blockStatesEst.nodeMask[blockNr] & PATHOPT_CARDINALS;
+			auto pathOptDir = blockStatesEst.GetNodeMask(blockNr) & PATHOPT_CARDINALS;
 			auto pathDir = PathOpt2PathDir(pathOptDir);
 			const int2 obp = pe[i].BlockIdxToPos(blockNr) - PE_DIRECTION_VECTORS[pathDir];
 			const int obBlockNr = pe[i].BlockPosToIdx(obp);
@@ -551,12 +551,12 @@ void HAPFSPathDrawer::Draw(const HAPFS::CPathEstimator* pe) const {
 				continue;
 
 			float3 p1;
-				p1.x = (blockStates.peNodeOffsets[md->pathType][blockNr].x) * SQUARE_SIZE;
-				p1.z = (blockStates.peNodeOffsets[md->pathType][blockNr].y) * SQUARE_SIZE;
+				p1.x = (blockStates.GetNodeOffset(md->pathType, blockNr).x) * SQUARE_SIZE;
+				p1.z = (blockStates.GetNodeOffset(md->pathType, blockNr).y) * SQUARE_SIZE;
 				p1.y = CGround::GetHeightAboveWater(p1.x, p1.z, false) + 15.0f;
 			float3 p2;
-				p2.x = (blockStates.peNodeOffsets[md->pathType][obBlockNr].x) * SQUARE_SIZE;
-				p2.z = (blockStates.peNodeOffsets[md->pathType][obBlockNr].y) * SQUARE_SIZE;
+				p2.x = (blockStates.GetNodeOffset(md->pathType, obBlockNr).x) * SQUARE_SIZE;
+				p2.z = (blockStates.GetNodeOffset(md->pathType, obBlockNr).y) * SQUARE_SIZE;
 				p2.y = CGround::GetHeightAboveWater(p2.x, p2.z, false) + 15.0f;
 
 			if (!camera->InView(p1) && !camera->InView(p2))
@@ -581,8 +581,8 @@ void HAPFSPathDrawer::Draw(const HAPFS::CPathEstimator* pe) const {
 				const int blockNr = ob->nodeNum;
 
 				float3 p1;
-					p1.x = (blockStates.peNodeOffsets[md->pathType][blockNr].x) * SQUARE_SIZE;
-					p1.z = (blockStates.peNodeOffsets[md->pathType][blockNr].y) * SQUARE_SIZE;
+					p1.x = (blockStates.GetNodeOffset(md->pathType, blockNr).x) * SQUARE_SIZE;
+					p1.z = (blockStates.GetNodeOffset(md->pathType, blockNr).y) * SQUARE_SIZE;
 					p1.y = CGround::GetHeightAboveWater(p1.x, p1.z, false) + 35.0f;
 
 				if (!camera->InView(p1))
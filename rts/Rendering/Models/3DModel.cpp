@@ -48,7 +48,9 @@ CR_REG_METADATA(LocalModel, (
 
 	CR_MEMBER(boundingVolume),
 	CR_IGNORED(luaMaterialData),
-	CR_MEMBER(needsBoundariesRecalc)
+	CR_MEMBER(needsBoundariesRecalc),
+
+	CR_IGNORED(pieceBounds)
 ))
 
 
@@ -314,6 +316,7 @@ void LocalModel::SetModel(const S3DModel* model, bool initialize)
 
 		pieces[0].UpdateChildMatricesRec(true);
 		UpdateBoundingVolume();
+		InitPieceBounds();
 		return;
 	}
 
@@ -329,6 +332,7 @@ void LocalModel::SetModel(const S3DModel* model, bool initialize)
 	// baked piece rotations (in the case of .dae)
 	pieces[0].UpdateChildMatricesRec(false);
 	UpdateBoundingVolume();
+	InitPieceBounds();
 
 	assert(pieces.size() == model->numPieces);
 }
@@ -408,6 +412,33 @@ void LocalModel::UpdateBoundingVolume()
 	needsBoundariesRecalc = false;
 }
 
+void LocalModel::InitPieceBounds()
+{
+	std::vector<int> parents(pieces.size(), -1);
+
+	for (size_t n = 1; n < pieces.size(); n++) {
+		parents[n] = (pieces[n].parent)->GetLModelPieceIndex();
+	}
+
+	pieceBounds.Init(parents);
+	UpdatePieceBounds();
+}
+
+void LocalModel::UpdatePieceBounds()
+{
+	pieceBounds.Refit([&](unsigned int i) {
+		const LocalModelPiece& lmp = pieces[i];
+		const CollisionVolume* vol = lmp.GetCollisionVolume();
+
+		PieceBounds bounds;
+
+		if (lmp.GetScriptVisible() && !vol->IgnoreHits())
+			bounds.SetVolumeBox(lmp.GetModelSpaceMatrix(), vol->GetHScales(), vol->GetOffsets());
+
+		return bounds;
+	});
+}
+
 /** ****************************************************************************************************
  * LocalModelPiece
  */
@@ -426,6 +457,7 @@ LocalModelPiece::LocalModelPiece(const S3DModelPiece* piece)
 
 	, original(piece)
 	, parent(nullptr) // set later
+	, localModel(nullptr) // set later
 {
 	assert(piece != nullptr);
 
@@ -441,6 +473,9 @@ void LocalModelPiece::SetDirty() {
 	dirty = true;
 	SetGetCustomDirty(true);
 
+	if (localModel != nullptr)
+		localModel->SetPieceBoundsNeedRecalc(lmodelPieceIndex);
+
 	for (LocalModelPiece* child: children) {
 		if (child->dirty)
 			continue;
@@ -448,6 +483,15 @@ void LocalModelPiece::SetDirty() {
 	}
 }
 
+void LocalModelPiece::SetScriptVisible(bool b)
+{
+	scriptSetVisible = b;
+	SetGetCustomDirty(true);
+
+	if (localModel != nullptr)
+		localModel->SetPieceBoundsNeedRecalc(lmodelPieceIndex);
+}
+
 bool LocalModelPiece::SetGetCustomDirty(bool cd) const
 {
 	std::swap(cd, customDirty);
@@ -12,6 +12,7 @@
 #include "Lua/LuaObjectMaterial.h"
 #include "Rendering/GL/VBO.h"
 #include "Sim/Misc/CollisionVolume.h"
+#include "Sim/Misc/PieceBounds.h"
 #include "System/Matrix44f.h"
 #include "System/type2.h"
 #include "System/float4.h"
@@ -516,7 +517,7 @@ struct LocalModelPiece
 	      CollisionVolume* GetCollisionVolume()       { return &colvol; }
 
 	bool GetScriptVisible() const { return scriptSetVisible; }
-	void SetScriptVisible(bool b) { scriptSetVisible = b; SetGetCustomDirty(true); }
+	void SetScriptVisible(bool b);
 private:
 	float3 pos; // translation relative to parent LMP, *INITIALLY* equal to original->offset
 	float3 rot; // orientation relative to parent LMP, in radians (updated by scripts)
@@ -613,8 +614,18 @@ struct LocalModel
 	}
 
 	void SetBoundariesNeedsRecalc() { needsBoundariesRecalc = true; }
+
+	// marks piece <i>'s subtree for the next refit of the culling bounds; see
+	// UpdatePieceBounds (hit tests skip culling while any bounds are stale)
+	void SetPieceBoundsNeedRecalc(unsigned int i) { pieceBounds.SetStale(i); }
+	void UpdatePieceBounds();
+
+	bool PieceBoundsNeedRecalc() const { return pieceBounds.IsStale(); }
+	const PieceBoundsTree& GetPieceBounds() const { return pieceBounds; }
+
 private:
 	LocalModelPiece* CreateLocalModelPieces(const S3DModelPiece* mpParent);
+	void InitPieceBounds();
 
 	void DrawPieces() const;
 	void DrawPiecesLOD(unsigned int lod) const;
@@ -630,6 +641,9 @@ private:
 	LuaObjectMaterialData luaMaterialData;
 
 	bool needsBoundariesRecalc = true;
+
+	// refitted eagerly by the sim, never from (const) hit-test paths
+	PieceBoundsTree pieceBounds;
 };
 
 #endif /* _3DMODEL_H */
@@ -34,6 +34,7 @@ CR_BIND_DERIVED_POOL(CFeature, CSolidObject, , featureMemPool.allocMem, featureM
 CR_REG_METADATA(CFeature, (
 	CR_MEMBER(isRepairingBeforeResurrect),
 	CR_MEMBER(inUpdateQue),
+	CR_MEMBER(atRest),
 	CR_MEMBER(deleteMe),
 	CR_MEMBER(alphaFade),
 
@@ -48,6 +49,8 @@ CR_REG_METADATA(CFeature, (
 	CR_MEMBER(lastReclaimFrame),
 	CR_MEMBER(fireTime),
 	CR_MEMBER(smokeTime),
+	CR_MEMBER(sleepFrame),
+	CR_MEMBER(wakeFrame),
 
 	CR_MEMBER(def),
 	CR_MEMBER(udef),
@@ -468,6 +471,9 @@ void CFeature::ForcedMove(const float3& newPos)
 	Move(newPos - pos, true);
 	Block();
 
+	// let gravity act on the new position; also wakes parked features
+	featureHandler.SetFeatureUpdateable(this);
+
 	// ForcedMove calls might cause the pstate to go stale
 	// (features are only Update()'d when in the FH queue)
 	UpdateTransformAndPhysState();
@@ -597,7 +603,13 @@ bool CFeature::UpdatePosition()
 
 bool CFeature::Update()
 {
-	bool continueUpdating = UpdatePosition();
+	// a settled feature only moves again after an event (impulse, terrain
+	// change, Lua, ...) that puts it back into the update-queue, so there
+	// is no need to keep integrating its position while its timers run
+	bool continueUpdating = false;
+
+	if (!atRest)
+		atRest = !(continueUpdating = UpdatePosition());
 
 	continueUpdating |= (smokeTime != 0);
 	continueUpdating |= (fireTime != 0);
@@ -628,6 +640,30 @@ bool CFeature::Update()
 }
 
 
+int CFeature::GetNextTimerFrame() const
+{
+	// called after Update, which has already counted down both timers for
+	// this frame; every other frame is a no-op for a settled feature until
+	// it emits smoke (the value the timer will have then must be non-zero)
+	// or its fire runs out
+	if (!atRest || deleteMe || def->geoThermal)
+		return (gs->frameNum + 1);
+
+	int nextFrame = std::numeric_limits<int>::max();
+
+	if (smokeTime != 0) {
+		const int smokeFrame = gs->frameNum + 1 + ((-(gs->frameNum + 1 + id)) & 3);
+
+		nextFrame = std::min(nextFrame, gs->frameNum + smokeTime);
+		nextFrame = std::min(nextFrame, smokeFrame);
+	}
+	if (fireTime != 0)
+		nextFrame = std::min(nextFrame, gs->frameNum + fireTime);
+
+	return nextFrame;
+}
+
+
 void CFeature::StartFire()
 {
 	if (fireTime != 0 || !def->burnable)
@@ -79,6 +79,7 @@ public:
 
 	bool Update();
 	bool UpdatePosition();
+	int GetNextTimerFrame() const;
 	bool UpdateVelocity(const float3& dragAccel, const float3& gravAccel, const float3& movMask, const float3& velMask);
 
 	void SetTransform(const CMatrix44f& m, bool synced) { transMatrix[synced] = m; }
@@ -115,6 +116,8 @@ public:
 	 */
 	bool isRepairingBeforeResurrect = false;
 	bool inUpdateQue = false;
+	// set once the position has settled, cleared by FeatureHandler::SetFeatureUpdateable
+	bool atRest = false;
 	bool deleteMe = false;
 	bool alphaFade = true; // unsynced
 
@@ -127,6 +130,11 @@ public:
 	int fireTime = 0;
 	int smokeTime = 0;
 
+	// frame of the last Update before the feature was parked on
+	// a wake-timer and the frame it wakes up at, -1 if not parked
+	int sleepFrame = -1;
+	int wakeFrame = -1;
+
 	SResourcePack defResources = {0.0f, 1.0f};
 	SResourcePack resources = {0.0f, 1.0f};
 
@@ -7,6 +7,7 @@
 #include "FeatureMemPool.h"
 #include "Map/Ground.h"
 #include "Map/ReadMap.h"
+#include "Sim/Misc/GlobalSynced.h"
 #include "Sim/Misc/QuadField.h"
 #include "Sim/Units/CommandAI/BuilderCAI.h"
 #include "System/creg/STL_Set.h"
@@ -21,7 +22,8 @@ CR_REG_METADATA(CFeatureHandler, (
 	CR_MEMBER(deletedFeatureIDs),
 	CR_MEMBER(activeFeatureIDs),
 	CR_MEMBER(features),
-	CR_MEMBER(updateFeatures)
+	CR_MEMBER(updateFeatures),
+	CR_MEMBER(parkedFeatures)
 ))
 
 /******************************************************************************/
@@ -33,6 +35,7 @@ CFeatureHandler featureHandler;
 
 void CFeatureHandler::Init() {
 	features.resize(MAX_FEATURES, nullptr);
+	parkedFeatures.resize(WAKE_TIMER_SLOTS);
 	activeFeatureIDs.reserve(MAX_FEATURES); // internal table size must be constant
 	featureMemPool.reserve(128);
 
@@ -52,6 +55,7 @@ void CFeatureHandler::Kill() {
 	deletedFeatureIDs.clear();
 	features.clear();
 	updateFeatures.clear();
+	parkedFeatures.clear();
 }
 
 
@@ -185,6 +189,8 @@ void CFeatureHandler::Update()
 		deletedFeatureIDs.erase(iter, deletedFeatureIDs.end());
 	}
 	{
+		WakeParkedFeatures();
+
 		const auto& pred = [this](CFeature* feature) { return (this->UpdateFeature(feature)); };
 		const auto& iter = std::remove_if(updateFeatures.begin(), updateFeatures.end(), pred);
 
@@ -236,12 +242,77 @@ bool CFeatureHandler::UpdateFeature(CFeature* feature)
 		return true;
 	}
 
+	const int wakeFrame = feature->GetNextTimerFrame();
+
+	if (wakeFrame > (gs->frameNum + 1)) {
+		// nothing to do for at least one frame, sleep until then
+		ParkFeature(feature, std::min(wakeFrame, gs->frameNum + WAKE_TIMER_SLOTS - 1));
+		return true;
+	}
+
 	return false;
 }
 
 
+void CFeatureHandler::ParkFeature(CFeature* feature, int wakeFrame)
+{
+	assert(feature->wakeFrame == -1);
+
+	feature->inUpdateQue = false;
+	feature->sleepFrame = gs->frameNum;
+	feature->wakeFrame = wakeFrame;
+
+	parkedFeatures[wakeFrame % WAKE_TIMER_SLOTS].push_back(feature);
+}
+
+void CFeatureHandler::WakeFeature(CFeature* feature)
+{
+	std::vector<CFeature*>& bucket = parkedFeatures[feature->wakeFrame % WAKE_TIMER_SLOTS];
+
+	// keep the bucket order, it decides the order of waking
+	bucket.erase(std::find(bucket.begin(), bucket.end(), feature));
+
+	ResumeFeature(feature);
+}
+
+void CFeatureHandler::WakeParkedFeatures()
+{
+	std::vector<CFeature*>& bucket = parkedFeatures[gs->frameNum % WAKE_TIMER_SLOTS];
+
+	for (CFeature* feature: bucket) {
+		assert(feature->wakeFrame == gs->frameNum);
+		ResumeFeature(feature);
+	}
+
+	bucket.clear();
+}
+
+void CFeatureHandler::ResumeFeature(CFeature* feature)
+{
+	assert(!feature->inUpdateQue);
+	assert(std::find(updateFeatures.begin(), updateFeatures.end(), feature) == updateFeatures.end());
+
+	// count down the timers for the frames that were skipped
+	const int numSkippedFrames = std::max(gs->frameNum - feature->sleepFrame - 1, 0);
+
+	feature->smokeTime = std::max(feature->smokeTime - numSkippedFrames, 0);
+	feature->fireTime = std::max(feature->fireTime - numSkippedFrames, 0);
+	feature->sleepFrame = -1;
+	feature->wakeFrame = -1;
+	feature->inUpdateQue = true;
+
+	updateFeatures.push_back(feature);
+}
+
+
 void CFeatureHandler::SetFeatureUpdateable(CFeature* feature)
 {
+	// whatever woke the feature might also have moved it
+	feature->atRest = false;
+
+	if (feature->wakeFrame != -1)
+		WakeFeature(feature);
+
 	if (feature->inUpdateQue) {
 		assert(std::find(updateFeatures.begin(), updateFeatures.end(), feature) != updateFeatures.end());
 		return;
@@ -262,6 +333,13 @@ void CFeatureHandler::TerrainChanged(int x1, int y1, int x2, int y2)
 
 	for (const int qi: *qfQuery.quads) {
 		for (CFeature* f: quadField.GetQuad(qi).features) {
+			// only the height below a feature's position can bury or drop it
+			// (plus a square of margin for the interpolation of corner heights)
+			if (f->pos.x < (mins.x - SQUARE_SIZE) || f->pos.x > (maxs.x + SQUARE_SIZE))
+				continue;
+			if (f->pos.z < (mins.z - SQUARE_SIZE) || f->pos.z > (maxs.z + SQUARE_SIZE))
+				continue;
+
 			// put this feature back in the update-queue
 			SetFeatureUpdateable(f);
 		}
@@ -81,13 +81,26 @@ private:
 
 	void InsertActiveFeature(CFeature* feature);
 
+	void ParkFeature(CFeature* feature, int wakeFrame);
+	void WakeFeature(CFeature* feature);
+	void WakeParkedFeatures();
+	void ResumeFeature(CFeature* feature);
+
 private:
+	// number of frames a parked feature can sleep before it must be re-parked
+	static constexpr int WAKE_TIMER_SLOTS = 256;
+
 	SimObjectIDPool idPool;
 
 	spring::unordered_set<int> activeFeatureIDs;
 	std::vector<int> deletedFeatureIDs;
 	std::vector<CFeature*> features;
 	std::vector<CFeature*> updateFeatures;
+
+	// features that are at rest and only wait for their smoke- or fire-timer
+	// to need them again, bucketed by <wakeFrame % WAKE_TIMER_SLOTS> and kept
+	// in the order they were parked so they wake in the same order everywhere
+	std::vector< std::vector<CFeature*> > parkedFeatures;
 };
 
 extern CFeatureHandler featureHandler;
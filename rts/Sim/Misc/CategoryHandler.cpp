@@ -22,7 +22,11 @@ CR_REG_METADATA(CCategoryHandler, (
 static CCategoryHandler instance;
 
 
+static thread_local CCategoryHandler::QueryLog* threadQueryLog = nullptr;
+
+
 CCategoryHandler* CCategoryHandler::Instance() { return &instance; }
+void CCategoryHandler::SetThreadQueryLog(QueryLog* log) { threadQueryLog = log; }
 
 void CCategoryHandler::CreateInstance() { instance.Init(); }
 void CCategoryHandler::RemoveInstance() { instance.Kill(); }
@@ -39,6 +43,15 @@ unsigned int CCategoryHandler::GetCategory(std::string name)
 	if (name.empty())
 		return cat;
 
+	if (threadQueryLog != nullptr) {
+		const auto it = categories.find(name);
+
+		threadQueryLog->names.push_back(name);
+		threadQueryLog->incomplete |= (it == categories.end());
+
+		return ((it != categories.end())? it->second: cat);
+	}
+
 	if (categories.find(name) == categories.end()) {
 		// this category is yet unknown
 		if (firstUnused >= CCategoryHandler::GetMaxCategories()) {
@@ -83,6 +96,16 @@ unsigned int CCategoryHandler::GetCategories(std::string names)
 }
 
 
+void CCategoryHandler::ReplayQueryLog(const QueryLog& log)
+{
+	assert(threadQueryLog == nullptr);
+
+	for (const std::string& name: log.names) {
+		GetCategory(name);
+	}
+}
+
+
 std::vector<std::string> CCategoryHandler::GetCategoryNames(unsigned int bits) const
 {
 	std::vector<std::string> names;
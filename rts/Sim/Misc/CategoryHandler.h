@@ -19,7 +19,19 @@ public:
 	// we can not support more than this
 	static constexpr inline unsigned int GetMaxCategories() { return (sizeof(unsigned int) * 8); }
 
+	/**
+	 * While set as the calling thread's query-log, GetCategory only looks
+	 * up known names (unknown ones yield 0 and mark the log incomplete) and
+	 * records every queried name. Replaying the logs of concurrent parsers
+	 * in a fixed order registers categories exactly as a serial run would.
+	 */
+	struct QueryLog {
+		std::vector<std::string> names;
+		bool incomplete = false;
+	};
+
 	static CCategoryHandler* Instance();
+	static void SetThreadQueryLog(QueryLog* log);
 
 	static void CreateInstance();
 	static void RemoveInstance();
@@ -47,6 +59,8 @@ public:
 	 */
 	std::vector<std::string> GetCategoryNames(unsigned int bits) const;
 
+	void ReplayQueryLog(const QueryLog& log);
+
 private:
 	// iterated in GetCategoryNames; reserved size must be constant
 	spring::unordered_map<std::string, unsigned int> categories;
@@ -1,5 +1,7 @@
 /* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
 
+#include "xsimd/xsimd.hpp"
+
 #include "CollisionHandler.h"
 #include "CollisionVolume.h"
 #include "Map/ReadMap.h" // mapDims
@@ -14,6 +16,308 @@ unsigned int CCollisionHandler::numDiscTests = 0;
 unsigned int CCollisionHandler::numContTests = 0;
 
 
+namespace {
+	using FloatBatch = xsimd::simd_type<float>;
+	using IntBatch = xsimd::simd_type<std::int32_t>;
+	using FloatMask = xsimd::batch_bool<float, FloatBatch::size>;
+
+	constexpr size_t NUM_LANES = FloatBatch::size;
+
+	// SoA float3; every operator mirrors the float3 one it replaces
+	struct BatchVec3 {
+		BatchVec3 operator + (const BatchVec3& v) const { return {x + v.x, y + v.y, z + v.z}; }
+		BatchVec3 operator - (const BatchVec3& v) const { return {x - v.x, y - v.y, z - v.z}; }
+		BatchVec3 operator * (const BatchVec3& v) const { return {x * v.x, y * v.y, z * v.z}; }
+		BatchVec3 operator * (const FloatBatch& f) const { return {x * f, y * f, z * f}; }
+
+		FloatBatch dot(const BatchVec3& v) const { return ((x * v.x) + (y * v.y) + (z * v.z)); }
+		FloatBatch SqLength() const { return (x*x + y*y + z*z); }
+
+		FloatBatch x;
+		FloatBatch y;
+		FloatBatch z;
+	};
+
+	struct LaneInputs {
+		BatchVec3 pi0;
+		BatchVec3 pi1;
+		BatchVec3 hScales;
+		BatchVec3 hiScales;
+		BatchVec3 hsqScales;
+
+		// primary-axis masks, only meaningful for cylinders
+		FloatMask axisX;
+		FloatMask axisY;
+		FloatMask axisZ;
+	};
+
+	// per-lane query fields in the layout the kernels produce them
+	struct LaneResults {
+		enum {
+			WRITE_NONE  = 0, // scalar path returns before touching the query
+			WRITE_FULL  = 1, // b{0,1}, t{0,1}, p{0,1}
+			WRITE_INVOL = 2, // b{0,1}, p{0,1} only (ray starts inside volume)
+		};
+
+		alignas(FloatBatch) float b0[NUM_LANES];
+		alignas(FloatBatch) float b1[NUM_LANES];
+		alignas(FloatBatch) float t0[NUM_LANES];
+		alignas(FloatBatch) float t1[NUM_LANES];
+		alignas(FloatBatch) float p0[3][NUM_LANES];
+		alignas(FloatBatch) float p1[3][NUM_LANES];
+		alignas(FloatBatch) float write[NUM_LANES];
+	};
+
+
+	inline BatchVec3 Select(const FloatMask& m, const BatchVec3& a, const BatchVec3& b) {
+		return {xsimd::select(m, a.x, b.x), xsimd::select(m, a.y, b.y), xsimd::select(m, a.z, b.z)};
+	}
+
+	inline FloatBatch ToBatch(const FloatMask& m, float v) {
+		return (xsimd::select(m, FloatBatch(v), FloatBatch(0.0f)));
+	}
+
+	// lane-wise fastmath::isqrt2_nosse, i.e. math::isqrt
+	inline FloatBatch ISqrt(const FloatBatch& v) {
+		const FloatBatch xh = FloatBatch(0.5f) * v;
+		const IntBatch i = IntBatch(0x5f375a86) - (xsimd::bitwise_cast<IntBatch>(v) >> 1);
+
+		FloatBatch x = xsimd::bitwise_cast<FloatBatch>(i);
+		x = x * (FloatBatch(1.5f) - xh * (x * x));
+		x = x * (FloatBatch(1.5f) - xh * (x * x));
+		return x;
+	}
+
+	// lane-wise float3::SafeNormalize
+	inline BatchVec3 SafeNormalize(const BatchVec3& v) {
+		const FloatBatch sql = v.SqLength();
+		return (Select(sql > FloatBatch(float3::nrm_eps()), v * ISqrt(sql), v));
+	}
+
+	// divisors of lanes that do not take the division are replaced by 1
+	// so masked-out lanes never raise FP exceptions or produce NaNs
+	inline FloatBatch SafeDivisor(const FloatMask& m, const FloatBatch& d) {
+		return (xsimd::select(m, d, FloatBatch(1.0f)));
+	}
+
+	inline void StoreVec3(float (&dst)[3][NUM_LANES], const BatchVec3& v) {
+		v.x.store_aligned(dst[0]);
+		v.y.store_aligned(dst[1]);
+		v.z.store_aligned(dst[2]);
+	}
+
+
+	// mirrors CCollisionHandler::IntersectEllipsoid
+	void IntersectEllipsoidLanes(const LaneInputs& in, LaneResults& out)
+	{
+		const FloatBatch zero(0.0f);
+
+		const BatchVec3 upi0 = in.pi0 * in.hiScales;
+		const BatchVec3 upi1 = in.pi1 * in.hiScales;
+		const FloatMask inVol = (upi0.dot(upi0) <= FloatBatch(1.0f));
+
+		const BatchVec3 dir = SafeNormalize(upi1 - upi0);
+
+		// A == 1
+		const FloatBatch B = FloatBatch(2.0f) * upi0.dot(dir);
+		const FloatBatch C = upi0.dot(upi0) - FloatBatch(1.0f);
+		const FloatBatch D = (B * B) - (FloatBatch(4.0f) * C);
+
+		const FloatMask noSol = (D < FloatBatch(-COLLISION_VOLUME_EPS));
+		const FloatMask oneSol = (D < FloatBatch(COLLISION_VOLUME_EPS));
+
+		const FloatBatch segLenSq = (in.pi1 - in.pi0).SqLength();
+
+		// one solution for t
+		const FloatBatch ts = -B * FloatBatch(0.5f);
+		const BatchVec3 ps = (upi0 + (dir * ts)) * in.hScales;
+		const FloatMask bs = (ts > zero) & ((ps - in.pi0).SqLength() <= segLenSq);
+
+		// two solutions for t
+		const FloatBatch rD = xsimd::sqrt(xsimd::select(oneSol, zero, D));
+		const FloatBatch t0 = (-B - rD) * FloatBatch(0.5f);
+		const FloatBatch t1 = (-B + rD) * FloatBatch(0.5f);
+		const BatchVec3 p0 = (upi0 + (dir * t0)) * in.hScales;
+		const BatchVec3 p1 = (upi0 + (dir * t1)) * in.hScales;
+		const FloatMask b0 = (t0 > zero) & ((p0 - in.pi0).SqLength() <= segLenSq);
+		const FloatMask b1 = (t1 > zero) & ((p1 - in.pi0).SqLength() <= segLenSq);
+
+		const BatchVec3 zeroVec = {zero, zero, zero};
+
+		xsimd::select(inVol, FloatBatch(CQ_POINT_IN_VOL), xsimd::select(oneSol, ToBatch(bs, CQ_POINT_ON_RAY), ToBatch(b0, CQ_POINT_ON_RAY))).store_aligned(out.b0);
+		xsimd::select(inVol, FloatBatch(CQ_POINT_IN_VOL), xsimd::select(oneSol, zero, ToBatch(b1, CQ_POINT_ON_RAY))).store_aligned(out.b1);
+		xsimd::select(oneSol, ts, t0).store_aligned(out.t0);
+		xsimd::select(oneSol, zero, t1).store_aligned(out.t1);
+
+		StoreVec3(out.p0, Select(inVol, zeroVec, Select(oneSol, ps, p0)));
+		StoreVec3(out.p1, Select(inVol, zeroVec, Select(oneSol, zeroVec, p1)));
+
+		const FloatBatch write = xsimd::select(noSol, FloatBatch(LaneResults::WRITE_NONE), FloatBatch(LaneResults::WRITE_FULL));
+		xsimd::select(inVol, FloatBatch(LaneResults::WRITE_INVOL), write).store_aligned(out.write);
+	}
+
+	// mirrors CCollisionHandler::IntersectCylinder
+	void IntersectCylinderLanes(const LaneInputs& in, LaneResults& out)
+	{
+		const FloatBatch zero(0.0f);
+		const FloatBatch one(1.0f);
+
+		// components along the primary and both secondary axes
+		const auto prim = [&](const BatchVec3& v) { return xsimd::select(in.axisX, v.x, xsimd::select(in.axisY, v.y, v.z)); };
+		const auto sec0 = [&](const BatchVec3& v) { return xsimd::select(in.axisX, v.y, v.x); };
+		const auto sec1 = [&](const BatchVec3& v) { return xsimd::select(in.axisZ, v.y, v.z); };
+		const auto ratio = [&](const BatchVec3& v) {
+			return (((sec0(v) * sec0(v)) / sec0(in.hsqScales)) + ((sec1(v) * sec1(v)) / sec1(in.hsqScales)));
+		};
+
+		const FloatBatch ahsPrim = prim(in.hScales);
+		const FloatMask inVol = (xsimd::abs(prim(in.pi0)) < ahsPrim) & (ratio(in.pi0) <= one);
+
+		// (unit) cylinder-space scales; the primary axis is left as-is (x * 1 == x)
+		const BatchVec3 unitScales = {xsimd::select(in.axisX, one, in.hiScales.x), xsimd::select(in.axisY, one, in.hiScales.y), xsimd::select(in.axisZ, one, in.hiScales.z)};
+		const BatchVec3 inv = {xsimd::select(in.axisX, one, in.hScales.x), xsimd::select(in.axisY, one, in.hScales.y), xsimd::select(in.axisZ, one, in.hScales.z)};
+
+		const BatchVec3 upi0 = in.pi0 * unitScales;
+		const BatchVec3 upi1 = in.pi1 * unitScales;
+		const BatchVec3 udir = SafeNormalize(upi1 - upi0);
+
+		// end-cap plane normals, see the per-axis cases of the scalar version
+		const BatchVec3 n0 = {ToBatch(in.axisX, -1.0f), ToBatch(in.axisY,  1.0f), ToBatch(in.axisZ,  1.0f)};
+		const BatchVec3 n1 = {ToBatch(in.axisX,  1.0f), ToBatch(in.axisY, -1.0f), ToBatch(in.axisZ, -1.0f)};
+
+		// unit-cylinder surface equation params
+		const FloatBatch a =  (sec0(udir) * sec0(udir)) + (sec1(udir) * sec1(udir));
+		const FloatBatch b = ((sec0(upi0) * sec0(udir)) + (sec1(upi0) * sec1(udir))) * FloatBatch(2.0f);
+		const FloatBatch c =  (sec0(upi0) * sec0(upi0)) + (sec1(upi0) * sec1(upi0)) - one;
+		const FloatBatch d = (b * b) - (FloatBatch(4.0f) * a * c);
+
+		const FloatBatch segLenSq = (in.pi1 - in.pi0).SqLength();
+
+		const FloatMask validD = (d >= FloatBatch(-COLLISION_VOLUME_EPS));
+		const FloatMask quadEq = validD & (a != zero);
+		const FloatMask quadEq1 = quadEq & (d < FloatBatch(COLLISION_VOLUME_EPS));
+		const FloatMask quadEq2 = quadEq & (d >= FloatBatch(COLLISION_VOLUME_EPS));
+		const FloatMask linEq = validD & (a == zero) & (b != zero);
+		const FloatMask anyEq = quadEq | linEq;
+
+		const FloatBatch twoA = SafeDivisor(quadEq, FloatBatch(2.0f) * a);
+		const FloatBatch rd = xsimd::sqrt(xsimd::select(quadEq2, d, zero));
+
+		FloatBatch t0 = xsimd::select(quadEq1, -b / twoA, xsimd::select(quadEq2, (-b - rd) / twoA, xsimd::select(linEq, -c / SafeDivisor(linEq, b), zero)));
+		FloatBatch t1 = xsimd::select(quadEq2, (-b + rd) / twoA, zero);
+
+		const BatchVec3 zeroVec = {zero, zero, zero};
+
+		BatchVec3 p0 = Select(anyEq, (upi0 + (udir * t0)) * inv, zeroVec);
+		BatchVec3 p1 = Select(quadEq2, (upi0 + (udir * t1)) * inv, zeroVec);
+
+		FloatMask b0 = anyEq & ((p0 - in.pi0).SqLength() < segLenSq) & (xsimd::abs(prim(p0)) < ahsPrim);
+		FloatMask b1 = quadEq2 & ((p1 - in.pi0).SqLength() < segLenSq) & (xsimd::abs(prim(p1)) < ahsPrim);
+
+		{
+			// front cap for lanes without a valid p0
+			const FloatBatch dp = n0.dot(udir);
+			const FloatBatch rdp = xsimd::select(dp != zero, one / SafeDivisor(dp != zero, dp), FloatBatch(0.01f));
+			const FloatBatch tc = -(n0.dot(upi0) - ahsPrim) * rdp;
+			const BatchVec3 pc = (upi0 + (udir * tc)) * inv;
+			const FloatMask bc = (tc >= zero) & (ratio(pc) <= one) & ((pc - in.pi0).SqLength() <= segLenSq);
+
+			t0 = xsimd::select(b0, t0, tc);
+			p0 = Select(b0, p0, pc);
+			b0 = b0 | bc;
+		}
+		{
+			// rear cap for lanes without a valid p1
+			const FloatBatch dp = n1.dot(udir);
+			const FloatBatch rdp = xsimd::select(dp != zero, one / SafeDivisor(dp != zero, dp), FloatBatch(0.01f));
+			const FloatBatch tc = -(n1.dot(upi0) - ahsPrim) * rdp;
+			const BatchVec3 pc = (upi0 + (udir * tc)) * inv;
+			const FloatMask bc = (tc >= zero) & (ratio(pc) <= one) & ((pc - in.pi0).SqLength() <= segLenSq);
+
+			t1 = xsimd::select(b1, t1, tc);
+			p1 = Select(b1, p1, pc);
+			b1 = b1 | bc;
+		}
+
+		xsimd::select(inVol, FloatBatch(CQ_POINT_IN_VOL), ToBatch(b0, CQ_POINT_ON_RAY)).store_aligned(out.b0);
+		xsimd::select(inVol, FloatBatch(CQ_POINT_IN_VOL), ToBatch(b1, CQ_POINT_ON_RAY)).store_aligned(out.b1);
+		t0.store_aligned(out.t0);
+		t1.store_aligned(out.t1);
+
+		StoreVec3(out.p0, Select(inVol, zeroVec, p0));
+		StoreVec3(out.p1, Select(inVol, zeroVec, p1));
+
+		xsimd::select(inVol, FloatBatch(LaneResults::WRITE_INVOL), FloatBatch(LaneResults::WRITE_FULL)).store_aligned(out.write);
+	}
+
+	// mirrors CCollisionHandler::IntersectBox
+	void IntersectBoxLanes(const LaneInputs& in, LaneResults& out)
+	{
+		const FloatBatch zero(0.0f);
+		const FloatBatch eps(COLLISION_VOLUME_EPS);
+
+		const BatchVec3& ahs = in.hScales;
+		const BatchVec3& pi0 = in.pi0;
+
+		const FloatMask inVol = (xsimd::abs(pi0.x) < ahs.x) & (xsimd::abs(pi0.y) < ahs.y) & (xsimd::abs(pi0.z) < ahs.z);
+
+		const BatchVec3 dir = SafeNormalize(in.pi1 - pi0);
+
+		FloatBatch tn(-9999999.9f);
+		FloatBatch tf( 9999999.9f);
+		FloatMask miss = (zero != zero);
+
+		const auto clipSlab = [&](const FloatBatch& d, const FloatBatch& p, const FloatBatch& h) {
+			const FloatMask flat = (xsimd::abs(d) < eps);
+			const FloatBatch sd = SafeDivisor(!flat, d);
+
+			const FloatBatch tl = (-h - p) / sd;
+			const FloatBatch th = ( h - p) / sd;
+			const FloatMask pos = (d > zero);
+
+			FloatBatch t0 = xsimd::select(pos, tl, th);
+			FloatBatch t1 = xsimd::select(pos, th, tl);
+
+			const FloatMask swap = (t0 > t1);
+			const FloatBatch t2 = t1;
+
+			t1 = xsimd::select(swap, t0, t1);
+			t0 = xsimd::select(swap, t2, t0);
+
+			tn = xsimd::select((!flat) & (t0 > tn), t0, tn);
+			tf = xsimd::select((!flat) & (t1 < tf), t1, tf);
+
+			miss = miss | (flat & (xsimd::abs(p) > h));
+			miss = miss | ((!flat) & ((tn > tf) | (tf < zero)));
+		};
+
+		clipSlab(dir.x, pi0.x, ahs.x);
+		clipSlab(dir.y, pi0.y, ahs.y);
+		clipSlab(dir.z, pi0.z, ahs.z);
+
+		const BatchVec3 p0 = pi0 + (dir * tn);
+		const BatchVec3 p1 = pi0 + (dir * tf);
+
+		const FloatBatch segLenSq = (in.pi1 - pi0).SqLength();
+		const FloatMask b0 = ((p0 - pi0).SqLength() <= segLenSq);
+		const FloatMask b1 = ((p1 - pi0).SqLength() <= segLenSq);
+
+		const BatchVec3 zeroVec = {zero, zero, zero};
+
+		xsimd::select(inVol, FloatBatch(CQ_POINT_IN_VOL), ToBatch(b0, CQ_POINT_ON_RAY)).store_aligned(out.b0);
+		xsimd::select(inVol, FloatBatch(CQ_POINT_IN_VOL), ToBatch(b1, CQ_POINT_ON_RAY)).store_aligned(out.b1);
+		tn.store_aligned(out.t0);
+		tf.store_aligned(out.t1);
+
+		StoreVec3(out.p0, Select(inVol, zeroVec, p0));
+		StoreVec3(out.p1, Select(inVol, zeroVec, p1));
+
+		const FloatBatch write = xsimd::select(miss, FloatBatch(LaneResults::WRITE_NONE), FloatBatch(LaneResults::WRITE_FULL));
+		xsimd::select(inVol, FloatBatch(LaneResults::WRITE_INVOL), write).store_aligned(out.write);
+	}
+}
+
+
 
 void CCollisionHandler::PrintStats()
 {
@@ -258,46 +562,160 @@ bool CCollisionHandler::IntersectPiecesHelper(
 	const float3& p1,
 	CollisionQuery* cq
 ) {
-	CMatrix44f volMat;
+	// pieces are queued per volume-type and tested in batches; the ray is
+	// transformed into each piece's volume-space up front as in Intersect
+	struct PieceBatch {
+		const CollisionVolume* vols[NUM_LANES];
+		const LocalModelPiece* pieces[NUM_LANES];
+
+		CMatrix44f mats[NUM_LANES];
+		float3 pi0s[NUM_LANES];
+		float3 pi1s[NUM_LANES];
+
+		unsigned int indices[NUM_LANES];
+		unsigned int size = 0;
+	};
+
+	const LocalModel& lm = o->localModel;
+
+	PieceBatch batches[3];
+	CollisionQuery cqs[NUM_LANES];
+	bool hits[NUM_LANES];
 
 	float minDistSq = std::numeric_limits<float>::max();
-	float curDistSq = minDistSq;
+	unsigned int minPieceIdx = -1u;
+
+	bool anyHit = false;
+
+	const auto flushBatch = [&](PieceBatch& b, int batchType) {
+		std::fill(std::begin(cqs), std::begin(cqs) + b.size, CollisionQuery{});
+
+		switch (batchType) {
+			case CollisionVolume::COLVOL_TYPE_ELLIPSOID: { IntersectEllipsoids(b.vols, b.pi0s, b.pi1s, cqs, hits, b.size); } break;
+			case CollisionVolume::COLVOL_TYPE_CYLINDER : { IntersectCylinders (b.vols, b.pi0s, b.pi1s, cqs, hits, b.size); } break;
+			case CollisionVolume::COLVOL_TYPE_BOX      : { IntersectBoxes     (b.vols, b.pi0s, b.pi1s, cqs, hits, b.size); } break;
+		}
 
-	for (unsigned int n = 0; n < o->localModel.pieces.size(); n++) {
-		const LocalModelPiece* lmp = o->localModel.GetPiece(n);
+		for (unsigned int i = 0; i < b.size; i++) {
+			CollisionQuery& cqn = cqs[i];
+
+			cqn.SwapParams();
+			cqn.Transform(b.mats[i]);
+
+			if (!hits[i])
+				continue;
+
+			// skip if neither an ingress nor an egress hit
+			if (!cqn.AnyHit())
+				continue;
+
+			// save the closest intersection (others are not needed); ties go
+			// to the lowest piece index, same as a sequential traversal would
+			const float curDistSq = (cqn.GetHitPos()).SqDistance(p0);
+
+			if (curDistSq > minDistSq)
+				continue;
+			if (curDistSq == minDistSq && (minPieceIdx == -1u || b.indices[i] > minPieceIdx))
+				continue;
+
+			anyHit = true;
+			minDistSq = curDistSq;
+			minPieceIdx = b.indices[i];
+
+			if (cq == nullptr)
+				continue;
+
+			*cq = cqn;
+			cq->SetHitPiece(b.pieces[i]);
+		}
+
+		b.size = 0;
+	};
+
+	// the ray in model-space, where the piece-subtree bounds live; these are
+	// refitted by the sim only, so stale bounds just disable culling here
+	const PieceBoundsTree& pieceBounds = lm.GetPieceBounds();
+
+	bool cullPieces = false;
+
+	const CMatrix44f mInvModel = m.Invert(&cullPieces);
+	const float3 mp0 = mInvModel.Mul(p0);
+	const float3 mp1 = mInvModel.Mul(p1);
+
+	cullPieces &= !lm.PieceBoundsNeedRecalc();
+
+	for (unsigned int n = 0, numPieces = lm.pieces.size(); n < numPieces; ) {
+		// skip entire subtrees whose volumes the ray can not touch
+		if (cullPieces && !pieceBounds.GetSubtreeBounds(n).SegmentHits(mp0, mp1)) {
+			n += pieceBounds.GetSubtreeSize(n);
+			continue;
+		}
+
+		const unsigned int pieceIdx = n++;
+
+		const LocalModelPiece* lmp = lm.GetPiece(pieceIdx);
 		const CollisionVolume* lmpVol = lmp->GetCollisionVolume();
 
 		if (!lmp->GetScriptVisible() || lmpVol->IgnoreHits())
 			continue;
 
-		volMat = m * lmp->GetModelSpaceMatrix();
+		CMatrix44f volMat = m * lmp->GetModelSpaceMatrix();
 		volMat.Translate(lmpVol->GetOffsets());
 
-		CollisionQuery cqn;
-		if (!CCollisionHandler::Intersect(lmpVol, volMat, p0, p1, &cqn))
-			continue;
+		numContTests += 1;
+
+		const CMatrix44f mInv = volMat.InvertAffine();
+		const float3 pi0 = mInv.Mul(p0);
+		const float3 pi1 = mInv.Mul(p1);
 
-		// skip if neither an ingress nor an egress hit
-		if (!cqn.AnyHit())
+		// same (bounding box) early-out as Intersect
+		const float3 rmin = float3::min(pi0, pi1);
+		const float3 rmax = float3::max(pi0, pi1);
+		const float3& vmax = lmpVol->GetHScales();
+
+		if (rmax.x < -vmax.x || rmin.x > vmax.x)
+			continue;
+		if (rmax.y < -vmax.y || rmin.y > vmax.y)
 			continue;
+		if (rmax.z < -vmax.z || rmin.z > vmax.z)
+			continue;
+
+		int batchType = lmpVol->GetVolumeType();
 
-		// save the closest intersection (others are not needed)
-		if ((curDistSq = (cqn.GetHitPos()).SqDistance(p0)) >= minDistSq)
+		// sphere is special case of ellipsoid
+		if (batchType == CollisionVolume::COLVOL_TYPE_SPHERE)
+			batchType = CollisionVolume::COLVOL_TYPE_ELLIPSOID;
+
+		PieceBatch& b = batches[batchType];
+
+		b.vols[b.size] = lmpVol;
+		b.pieces[b.size] = lmp;
+		b.mats[b.size] = volMat;
+		b.pi0s[b.size] = pi0;
+		b.pi1s[b.size] = pi1;
+		b.indices[b.size] = pieceIdx;
+
+		if ((b.size += 1) < NUM_LANES)
 			continue;
 
-		minDistSq = curDistSq;
+		flushBatch(b, batchType);
 
 		// return early if caller only wants to know a collision exists
-		if (cq == nullptr)
+		if (cq == nullptr && anyHit)
 			return true;
+	}
 
-		*cq = cqn;
-		cq->SetHitPiece(lmp);
+	for (int batchType = CollisionVolume::COLVOL_TYPE_ELLIPSOID; batchType <= CollisionVolume::COLVOL_TYPE_BOX; batchType++) {
+		if (batches[batchType].size > 0)
+			flushBatch(batches[batchType], batchType);
 	}
 
+	if (cq == nullptr)
+		return anyHit;
+
 	// true iff at least one piece was intersected
 	// (query must have been reset by calling code)
-	return (cq != nullptr && cq->GetHitPiece() != nullptr);
+	return (cq->GetHitPiece() != nullptr);
 }
 
 
@@ -787,3 +1205,102 @@ bool CCollisionHandler::IntersectBox(const CollisionVolume* v, const float3& pi0
 	return (b0 == CQ_POINT_ON_RAY || b1 == CQ_POINT_ON_RAY);
 }
 
+
+template<typename LaneKernel>
+void CCollisionHandler::IntersectBatched(
+	const CollisionVolume* const* vs,
+	const float3* pi0s,
+	const float3* pi1s,
+	CollisionQuery* qs,
+	bool* hits,
+	size_t n,
+	LaneKernel kernel
+) {
+	alignas(FloatBatch) float lanes[16][NUM_LANES];
+
+	LaneInputs in;
+	LaneResults out;
+
+	const auto loadVec3 = [&](BatchVec3& v, unsigned int row) {
+		v.x.load_aligned(lanes[row + 0]);
+		v.y.load_aligned(lanes[row + 1]);
+		v.z.load_aligned(lanes[row + 2]);
+	};
+
+	for (size_t base = 0; base < n; base += NUM_LANES) {
+		const size_t numLanes = std::min(n - base, NUM_LANES);
+
+		// gather into SoA; unused lanes replicate the last valid one
+		for (size_t j = 0; j < NUM_LANES; j++) {
+			const size_t i = base + std::min(j, numLanes - 1);
+
+			const CollisionVolume* v = vs[i];
+			const float3* vecs[] = {&pi0s[i], &pi1s[i], &v->GetHScales(), &v->GetHIScales(), &v->GetHSqScales()};
+
+			for (unsigned int k = 0; k < 5; k++) {
+				lanes[k * 3 + 0][j] = vecs[k]->x;
+				lanes[k * 3 + 1][j] = vecs[k]->y;
+				lanes[k * 3 + 2][j] = vecs[k]->z;
+			}
+
+			lanes[15][j] = v->GetPrimaryAxis();
+		}
+
+		loadVec3(in.pi0, 0);
+		loadVec3(in.pi1, 3);
+		loadVec3(in.hScales, 6);
+		loadVec3(in.hiScales, 9);
+		loadVec3(in.hsqScales, 12);
+
+		{
+			FloatBatch axis;
+			axis.load_aligned(lanes[15]);
+
+			in.axisX = (axis == FloatBatch(CollisionVolume::COLVOL_AXIS_X));
+			in.axisY = (axis == FloatBatch(CollisionVolume::COLVOL_AXIS_Y));
+			in.axisZ = (axis == FloatBatch(CollisionVolume::COLVOL_AXIS_Z));
+		}
+
+		kernel(in, out);
+
+		// scatter back into the queries, writing exactly what the scalar path writes
+		for (size_t j = 0; j < numLanes; j++) {
+			CollisionQuery& q = qs[base + j];
+
+			switch (static_cast<int>(out.write[j])) {
+				case LaneResults::WRITE_NONE: {
+					hits[base + j] = false;
+					continue;
+				} break;
+				case LaneResults::WRITE_FULL: {
+					q.t0 = out.t0[j];
+					q.t1 = out.t1[j];
+				} break;
+				default: {
+				} break;
+			}
+
+			q.b0 = static_cast<int>(out.b0[j]);
+			q.b1 = static_cast<int>(out.b1[j]);
+			q.p0 = {out.p0[0][j], out.p0[1][j], out.p0[2][j]};
+			q.p1 = {out.p1[0][j], out.p1[1][j], out.p1[2][j]};
+
+			hits[base + j] = (q.b0 == CQ_POINT_ON_RAY || q.b1 == CQ_POINT_ON_RAY || q.InsideHit());
+		}
+	}
+}
+
+void CCollisionHandler::IntersectEllipsoids(const CollisionVolume* const* vs, const float3* pi0s, const float3* pi1s, CollisionQuery* qs, bool* hits, size_t n)
+{
+	IntersectBatched(vs, pi0s, pi1s, qs, hits, n, IntersectEllipsoidLanes);
+}
+
+void CCollisionHandler::IntersectCylinders(const CollisionVolume* const* vs, const float3* pi0s, const float3* pi1s, CollisionQuery* qs, bool* hits, size_t n)
+{
+	IntersectBatched(vs, pi0s, pi1s, qs, hits, n, IntersectCylinderLanes);
+}
+
+void CCollisionHandler::IntersectBoxes(const CollisionVolume* const* vs, const float3* pi0s, const float3* pi1s, CollisionQuery* qs, bool* hits, size_t n)
+{
+	IntersectBatched(vs, pi0s, pi1s, qs, hits, n, IntersectBoxLanes);
+}
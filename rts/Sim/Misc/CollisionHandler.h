@@ -167,6 +167,22 @@ class CCollisionHandler {
 		static bool IntersectCylinder(const CollisionVolume* v, const float3& pi0, const float3& pi1, CollisionQuery* cq);
 		static bool IntersectBox(const CollisionVolume* v, const float3& pi0, const float3& pi1, CollisionQuery* cq);
 
+		/**
+		 * Batched versions of the above: ray (pi0s[i], pi1s[i]) is tested against
+		 * vs[i] with all coordinates in volume-space, so one ray against many volumes
+		 * (transformed once per volume) and many rays against one volume both fit.
+		 * The SIMD kernels replicate the scalar float-ops in the same order, so each
+		 * qs[i] and hits[i] is bit-identical to what the scalar call would produce.
+		 * vs[i] must all be of the matching type, and cylinders may mix axes.
+		 */
+		static void IntersectEllipsoids(const CollisionVolume* const* vs, const float3* pi0s, const float3* pi1s, CollisionQuery* qs, bool* hits, size_t n);
+		static void IntersectCylinders(const CollisionVolume* const* vs, const float3* pi0s, const float3* pi1s, CollisionQuery* qs, bool* hits, size_t n);
+		static void IntersectBoxes(const CollisionVolume* const* vs, const float3* pi0s, const float3* pi1s, CollisionQuery* qs, bool* hits, size_t n);
+
+	private:
+		template<typename LaneKernel>
+		static void IntersectBatched(const CollisionVolume* const* vs, const float3* pi0s, const float3* pi1s, CollisionQuery* qs, bool* hits, size_t n, LaneKernel kernel);
+
 	private:
 		static unsigned int numDiscTests; // number of discrete hit-tests executed
 		static unsigned int numContTests; // number of continuous hit-tests executed (inc. unsynced)
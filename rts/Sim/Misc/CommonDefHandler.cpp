@@ -2,14 +2,18 @@
 
 #include <algorithm>
 #include <array>
+#include <cassert>
+#include <memory>
 
 #include "CommonDefHandler.h"
 
+#include "Lua/LuaParser.h"
 #include "Sim/Misc/GuiSoundSet.h"
 #include "System/FileSystem/FileSystem.h"
 #include "System/FileSystem/FileHandler.h"
 #include "System/Sound/ISound.h"
 #include "System/Log/ILog.h"
+#include "System/Threading/ThreadPool.h"
 
 static const std::array<std::string, 2> soundExts = {{"wav", "ogg"}};
 
@@ -73,3 +77,48 @@ int CommonDefHandler::LoadSoundFile(const std::string& fileName)
 
 	return 0;
 }
+
+
+void CommonDefHandler::ParseDefTables(
+	LuaParser* defsParser,
+	const char* tableName,
+	const std::vector<std::string>& defNames,
+	const std::function<void(const LuaTable&, size_t)>& parseFunc
+) {
+	// below this, replicating the root costs more than it saves
+	constexpr size_t MIN_PARALLEL_DEFS = 64;
+
+	struct ThreadReplica {
+		std::unique_ptr<LuaParser> parser;
+		LuaTable defsTable;
+	};
+
+	std::vector<std::uint8_t> rootData;
+
+	// the defs-parser root is itself rebuilt from a snapshot (CDefsCache)
+	// so replicas made from the same snapshot iterate in identical order
+	if (!ThreadPool::HasThreads() || defNames.size() < MIN_PARALLEL_DEFS || !defsParser->SerializeRoot(rootData)) {
+		const LuaTable& defsTable = defsParser->GetRoot().SubTable(tableName);
+
+		for (size_t i = 0; i < defNames.size(); i++) {
+			parseFunc(defsTable.SubTable(defNames[i]), i);
+		}
+
+		return;
+	}
+
+	std::vector<ThreadReplica> replicas(ThreadPool::GetMaxThreads());
+
+	for_mt(0, defNames.size(), [&](const int i) {
+		ThreadReplica& replica = replicas[ThreadPool::GetThreadNum()];
+
+		if (replica.parser == nullptr) {
+			replica.parser = std::make_unique<LuaParser>("", SPRING_VFS_ZIP, 0);
+			replica.parser->DeserializeRoot(rootData);
+			replica.defsTable = replica.parser->GetRoot().SubTable(tableName);
+		}
+
+		assert(replica.defsTable.IsValid());
+		parseFunc(replica.defsTable.SubTable(defNames[i]), i);
+	});
+}
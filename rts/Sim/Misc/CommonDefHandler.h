@@ -3,10 +3,14 @@
 #ifndef COMMON_DEF_HANDLER_H
 #define COMMON_DEF_HANDLER_H
 
+#include <functional>
 #include <string>
+#include <vector>
 
 struct GuiSoundSet;
 struct GuiSoundSetData;
+class LuaParser;
+class LuaTable;
 
 class CommonDefHandler {
 public:
@@ -21,6 +25,20 @@ public:
 
 	// loads a soundfile, adds "sounds/" prefix and ".wav" extension if necessary
 	static int LoadSoundFile(const std::string& fileName);
+
+	/**
+	 * Calls parseFunc(defTable, i) for each root[tableName][defNames[i]].
+	 * A single Lua state can not be shared between threads, so this runs
+	 * concurrently on per-thread replicas of the (plain data) root table
+	 * if possible and serially on the root itself otherwise. parseFunc
+	 * must therefore not modify state shared between defs.
+	 */
+	static void ParseDefTables(
+		LuaParser* defsParser,
+		const char* tableName,
+		const std::vector<std::string>& defNames,
+		const std::function<void(const LuaTable&, size_t)>& parseFunc
+	);
 };
 
 #endif
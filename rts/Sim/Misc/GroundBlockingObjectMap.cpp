@@ -171,6 +171,7 @@ void CGroundBlockingObjectMap::OpenBlockingYard(CSolidObject* object)
 {
 	RemoveGroundBlockingObject(object);
 	AddGroundBlockingObject(object, YARDMAP_YARDFREE);
+	object->MarkFootPrintActivity();
 
 	object->yardOpen = true;
 }
@@ -187,6 +188,7 @@ void CGroundBlockingObjectMap::CloseBlockingYard(CSolidObject* object)
 {
 	RemoveGroundBlockingObject(object);
 	AddGroundBlockingObject(object, YARDMAP_YARDBLOCKED);
+	object->MarkFootPrintActivity();
 
 	object->yardOpen = false;
 }
@@ -6,7 +6,9 @@
 #include "InterceptHandler.h"
 
 #include "Map/Ground.h"
+#include "Map/ReadMap.h"
 #include "Sim/Misc/GlobalSynced.h"
+#include "Sim/Misc/QuadField.h"
 #include "Sim/Misc/TeamHandler.h"
 #include "Sim/Weapons/Weapon.h"
 #include "Sim/Projectiles/WeaponProjectiles/WeaponProjectile.h"
@@ -21,7 +23,15 @@
 CR_BIND_DERIVED(CInterceptHandler, CObject, )
 CR_REG_METADATA(CInterceptHandler, (
 	CR_MEMBER(interceptors),
-	CR_MEMBER(interceptables)
+	CR_MEMBER(interceptables),
+
+	CR_IGNORED(targetQuadOffsets),
+	CR_IGNORED(targetQuadItems),
+	CR_IGNORED(targetQuadPairs),
+	CR_IGNORED(targetImpactDists),
+	CR_IGNORED(targetIndices),
+	CR_IGNORED(targetStamps),
+	CR_IGNORED(targetStamp)
 ))
 
 CInterceptHandler interceptHandler;
@@ -31,6 +41,10 @@ CInterceptHandler interceptHandler;
 void CInterceptHandler::Update(bool forced) {
 	if (((gs->frameNum % UNIT_SLOWUPDATE_RATE) != 0) && !forced)
 		return;
+	if (interceptors.empty() || interceptables.empty())
+		return;
+
+	IndexInterceptTargets();
 
 	for (CWeapon* w: interceptors) {
 		const WeaponDef* wDef = w->weaponDef;
@@ -38,7 +52,13 @@ void CInterceptHandler::Update(bool forced) {
 
 		assert(wDef->interceptor || wDef->isShield);
 
-		for (CWeaponProjectile* p: interceptables) {
+		// only targets whose predicted path or target position can be
+		// within the coverage circle need to be considered (see below)
+		GetInterceptTargets(w->aimFromPos, wDef->coverageRange);
+
+		for (const unsigned int targetIdx: targetIndices) {
+			CWeaponProjectile* p = interceptables[targetIdx];
+
 			if (!p->CanBeInterceptedBy(wDef))
 				continue;
 			if (w->HasIncomingProjectile(p->id))
@@ -61,8 +81,11 @@ void CInterceptHandler::Update(bool forced) {
 			//
 			// these checks all need to be evaluated periodically, not just
 			// when a projectile is created and handed to AddInterceptTarget
+			// the ground is hit within weaponDist iff its first impact along p's
+			// (unbounded) direction is, which IndexInterceptTargets cached
 			const float weaponDist = w->aimFromPos.distance(p->pos);
-			const float impactDist = CGround::LineGroundCol(p->pos, p->pos + p->dir * weaponDist);
+			const float groundDist = targetImpactDists[targetIdx];
+			const float impactDist = (groundDist >= 0.0f && groundDist <= weaponDist)? groundDist: -1.0f;
 
 			const float3& pImpactPos = p->pos + p->dir * impactDist;
 			const float3& pTargetPos = p->GetTargetPos();
@@ -116,6 +139,97 @@ void CInterceptHandler::Update(bool forced) {
 
 
 
+void CInterceptHandler::IndexInterceptTargets()
+{
+	const unsigned int numQuads = quadField.GetNumQuadsX() * quadField.GetNumQuadsZ();
+	const unsigned int numTargets = interceptables.size();
+
+	// every map position lies within this sphere, so a path can not hit the
+	// ground further away than its start's distance from the center plus r
+	const float3 mapMins = {                              0.0f, readMap->GetCurrMinHeight(),                               0.0f};
+	const float3 mapMaxs = {mapDims.mapx * 1.0f * SQUARE_SIZE, readMap->GetCurrMaxHeight(), mapDims.mapy * 1.0f * SQUARE_SIZE};
+	const float3 mapCenter = (mapMins + mapMaxs) * 0.5f;
+	const float mapRadius = mapMins.distance(mapCenter);
+
+	targetQuadPairs.clear();
+	targetImpactDists.clear();
+	targetImpactDists.resize(numTargets, -1.0f);
+
+	for (unsigned int i = 0; i < numTargets; i++) {
+		const CWeaponProjectile* p = interceptables[i];
+
+		const float maxPathDist = p->pos.distance(mapCenter) + mapRadius;
+		const float groundDist = CGround::LineGroundCol(p->pos, p->pos + p->dir * maxPathDist);
+
+		targetImpactDists[i] = groundDist;
+
+		// all positions Update tests against an interceptor's coverage circle are
+		// either the target position or p->pos + p->dir * t for t within [-1, d]
+		// where d is the impact distance, so any circle that contains one of them
+		// overlaps a quad on this ray
+		QuadFieldQuery qfQuery;
+		quadField.GetQuadsOnRay(qfQuery, p->pos - p->dir, p->dir, std::max(groundDist, 0.0f) + 1.0f);
+
+		for (const int quadIdx: *qfQuery.quads) {
+			targetQuadPairs.emplace_back(quadIdx, i);
+		}
+
+		targetQuadPairs.emplace_back(quadField.WorldPosToQuadFieldIdx(p->GetTargetPos()), i);
+	}
+
+	// counting-sort the pairs by quad
+	targetQuadOffsets.clear();
+	targetQuadOffsets.resize(numQuads + 1, 0);
+	targetQuadItems.resize(targetQuadPairs.size());
+
+	for (const auto& pair: targetQuadPairs) {
+		targetQuadOffsets[pair.first + 1] += 1;
+	}
+	for (unsigned int q = 0; q < numQuads; q++) {
+		targetQuadOffsets[q + 1] += targetQuadOffsets[q];
+	}
+	for (const auto& pair: targetQuadPairs) {
+		targetQuadItems[targetQuadOffsets[pair.first]++] = pair.second;
+	}
+
+	// the fill-pass advanced each offset to the start of the next quad
+	for (unsigned int q = numQuads; q > 0; q--) {
+		targetQuadOffsets[q] = targetQuadOffsets[q - 1];
+	}
+
+	targetQuadOffsets[0] = 0;
+
+	targetStamps.clear();
+	targetStamps.resize(numTargets, 0);
+	targetStamp = 0;
+}
+
+void CInterceptHandler::GetInterceptTargets(const float3& pos, float radius)
+{
+	QuadFieldQuery qfQuery;
+	quadField.GetQuads(qfQuery, pos, radius);
+
+	targetIndices.clear();
+	targetStamp += 1;
+
+	for (const int quadIdx: *qfQuery.quads) {
+		for (unsigned int k = targetQuadOffsets[quadIdx]; k < targetQuadOffsets[quadIdx + 1]; k++) {
+			const unsigned int targetIdx = targetQuadItems[k];
+
+			if (targetStamps[targetIdx] == targetStamp)
+				continue;
+
+			targetStamps[targetIdx] = targetStamp;
+			targetIndices.push_back(targetIdx);
+		}
+	}
+
+	// keep the order of <interceptables>, which determines the order
+	// of AddIncomingProjectile and AllowWeaponInterceptTarget calls
+	std::sort(targetIndices.begin(), targetIndices.end());
+}
+
+
 void CInterceptHandler::AddInterceptorWeapon(CWeapon* weapon)
 {
 	interceptors.push_back(weapon);
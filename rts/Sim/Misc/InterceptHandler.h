@@ -4,6 +4,8 @@
 #define INTERCEPT_HANDLER_H
 
 #include <deque>
+#include <vector>
+
 #include "System/Misc/NonCopyable.h"
 #include "System/Object.h"
 
@@ -26,9 +28,29 @@ public:
 
 	void DependentDied(CObject* o);
 
+private:
+	void IndexInterceptTargets();
+	void GetInterceptTargets(const float3& pos, float radius);
+
 private:
 	std::deque<CWeapon*> interceptors;
 	std::deque<CWeaponProjectile*> interceptables;
+
+	// spatial index over <interceptables>, rebuilt by every Update: each
+	// target is listed in the quads its predicted path crosses and in the
+	// quad of its target position; items of quad q are in the index-range
+	// [targetQuadOffsets[q], targetQuadOffsets[q + 1])
+	std::vector<unsigned int> targetQuadOffsets;
+	std::vector<unsigned int> targetQuadItems;
+	std::vector< std::pair<int, unsigned int> > targetQuadPairs;
+
+	// distance along each target's direction to its first ground impact (or -1)
+	std::vector<float> targetImpactDists;
+	// indices of the targets an interceptor might cover, in <interceptables> order
+	std::vector<unsigned int> targetIndices;
+	std::vector<int> targetStamps;
+
+	int targetStamp = 0;
 };
 
 extern CInterceptHandler interceptHandler;
@@ -0,0 +1,94 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include <algorithm>
+#include <cstring>
+
+#include "PieceBounds.h"
+#include "System/Matrix44f.h"
+#include "System/SpringMath.h"
+
+bool PieceBounds::Equals(const PieceBounds& b) const
+{
+	// bit-wise, any change has to be picked up by the refit
+	return (std::memcmp(this, &b, sizeof(PieceBounds)) == 0);
+}
+
+// conservative segment vs. axis-aligned box test
+bool PieceBounds::SegmentHits(const float3& p0, const float3& p1) const
+{
+	if (Empty())
+		return false;
+
+	const float3 d = p1 - p0;
+
+	float tmin = 0.0f;
+	float tmax = 1.0f;
+
+	for (int a = 0; a < 3; a++) {
+		if (math::fabs(d[a]) < 1e-6f) {
+			if (p0[a] < mins[a] || p0[a] > maxs[a])
+				return false;
+
+			continue;
+		}
+
+		const float invD = 1.0f / d[a];
+
+		float t0 = (mins[a] - p0[a]) * invD;
+		float t1 = (maxs[a] - p0[a]) * invD;
+
+		if (t0 > t1)
+			std::swap(t0, t1);
+
+		tmin = std::max(tmin, t0);
+		tmax = std::min(tmax, t1);
+
+		if (tmin > tmax)
+			return false;
+	}
+
+	return true;
+}
+
+void PieceBounds::AddBounds(const PieceBounds& b)
+{
+	if (b.Empty())
+		return;
+
+	mins = float3::min(mins, b.mins);
+	maxs = float3::max(maxs, b.maxs);
+}
+
+void PieceBounds::SetVolumeBox(const CMatrix44f& mat, const float3& hs, const float3& offsets)
+{
+	// transform the volume's (padded) bounding-box as center plus extents;
+	// padding keeps the culling conservative w.r.t. the rounding errors of
+	// the per-piece test which works in volume-space instead
+	const float3 ext = hs * 1.01f + OnesVector;
+	const float3 ctr = mat * offsets;
+	const float3 mex =
+		float3::fabs(mat.GetX()) * ext.x +
+		float3::fabs(mat.GetY()) * ext.y +
+		float3::fabs(mat.GetZ()) * ext.z;
+
+	mins = ctr - mex;
+	maxs = ctr + mex;
+}
+
+
+void PieceBoundsTree::Init(const std::vector<int>& pieceParents)
+{
+	parents = pieceParents;
+
+	bounds.clear();
+	bounds.resize(parents.size());
+	sizes.assign(parents.size(), 1);
+	stale.assign(parents.size(), 1);
+
+	// children always follow their parent, so sizes can be summed bottom-up
+	for (size_t n = parents.size(); n-- > 1; ) {
+		sizes[parents[n]] += sizes[n];
+	}
+
+	anyStale = !parents.empty();
+}
@@ -0,0 +1,99 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef PIECE_BOUNDS_H
+#define PIECE_BOUNDS_H
+
+#include <cstdint>
+#include <vector>
+
+#include "System/float3.h"
+
+class CMatrix44f;
+
+// model-space box around (some of) a model's piece collision volumes
+struct PieceBounds {
+	bool Empty() const { return (mins.x > maxs.x); }
+	bool Equals(const PieceBounds& b) const;
+	bool SegmentHits(const float3& p0, const float3& p1) const;
+
+	void AddBounds(const PieceBounds& b);
+	// box around a volume with half-scales <hs> centered at <offsets> in <mat>'s space
+	void SetVolumeBox(const CMatrix44f& mat, const float3& hs, const float3& offsets);
+
+	float3 mins = { 1e9f,  1e9f,  1e9f};
+	float3 maxs = {-1e9f, -1e9f, -1e9f};
+};
+
+
+// per-piece bounds of each subtree's collision volumes for culling piece-tree
+// hit tests; pieces are stored in pre-order so subtree <i> spans the indices
+// [i, i + GetSubtreeSize(i)) and can be skipped wholesale
+class PieceBoundsTree {
+public:
+	// <parents> holds the index of each piece's parent, -1 for the root
+	void Init(const std::vector<int>& parents);
+
+	// marks before Init are moot, it starts out with every piece stale
+	void SetStale(unsigned int i) {
+		if (i >= stale.size())
+			return;
+
+		stale[i] = 1;
+		anyStale = true;
+	}
+
+	bool IsStale() const { return anyStale; }
+
+	// refits the subtrees of stale pieces and whichever ancestors they grow or
+	// shrink; <getPieceBounds(i)> yields the bounds of piece i's own volume
+	template<typename F> void Refit(F&& getPieceBounds);
+
+	const PieceBounds& GetSubtreeBounds(unsigned int i) const { return bounds[i]; }
+	unsigned int GetSubtreeSize(unsigned int i) const { return sizes[i]; }
+
+private:
+	std::vector<PieceBounds> bounds;
+	std::vector<unsigned int> sizes;
+	std::vector<int> parents;
+	std::vector<uint8_t> stale;
+
+	bool anyStale = false;
+};
+
+
+template<typename F> void PieceBoundsTree::Refit(F&& getPieceBounds)
+{
+	if (!anyStale)
+		return;
+
+	// pieces move along with their parent, and children always follow it
+	for (size_t n = 1; n < parents.size(); n++) {
+		stale[n] |= stale[parents[n]];
+	}
+
+	for (size_t n = parents.size(); n-- > 0; ) {
+		if (!stale[n])
+			continue;
+
+		PieceBounds b = getPieceBounds(n);
+
+		// direct children, skipping over their own subtrees
+		for (size_t c = n + 1; c < n + sizes[n]; c += sizes[c]) {
+			b.AddBounds(bounds[c]);
+		}
+
+		stale[n] = 0;
+
+		if (b.Equals(bounds[n]))
+			continue;
+
+		bounds[n] = b;
+
+		if (n > 0)
+			stale[parents[n]] = 1;
+	}
+
+	anyStale = false;
+}
+
+#endif
@@ -38,9 +38,11 @@ CR_BIND(CQuadField::Quad, )
 CR_REG_METADATA_SUB(CQuadField, Quad, (
 	CR_MEMBER(units),
 	CR_IGNORED(teamUnits),
+	CR_IGNORED(teamUnitOffsets),
 	CR_MEMBER(features),
 	CR_MEMBER(projectiles),
 	CR_MEMBER(repulsers),
+	CR_MEMBER(activityFrame),
 
 	CR_POSTLOAD(PostLoad)
 ))
@@ -102,11 +104,47 @@ void CQuadField::Quad::PostLoad()
 	Resize(teamHandler.ActiveAllyTeams());
 
 	for (CUnit* unit: units) {
-		spring::VectorInsertUnique(teamUnits[unit->allyteam], unit, false);
+		teamUnits.insert(teamUnits.begin() + teamUnitOffsets[unit->allyteam + 1], unit);
+
+		for (size_t i = unit->allyteam + 1; i < teamUnitOffsets.size(); i++) {
+			teamUnitOffsets[i] += 1;
+		}
 	}
 #endif
 }
 
+void CQuadField::Quad::AddUnit(CUnit* unit, int allyTeam)
+{
+	spring::VectorInsertUnique(units, unit, false);
+
+	// append to the end of the allyteam's block, shifting the blocks after it
+	teamUnits.insert(teamUnits.begin() + teamUnitOffsets[allyTeam + 1], unit);
+
+	for (size_t i = allyTeam + 1; i < teamUnitOffsets.size(); i++) {
+		teamUnitOffsets[i] += 1;
+	}
+}
+
+void CQuadField::Quad::RemoveUnit(CUnit* unit, int allyTeam)
+{
+	if (!spring::VectorErase(units, unit))
+		return;
+
+	const auto blockBeg = teamUnits.begin() + teamUnitOffsets[allyTeam    ];
+	const auto blockEnd = teamUnits.begin() + teamUnitOffsets[allyTeam + 1];
+	const auto unitIter = std::find(blockBeg, blockEnd, unit);
+
+	assert(unitIter != blockEnd);
+
+	// same (swap with last) order semantics as VectorErase within the block
+	*unitIter = *(blockEnd - 1);
+	teamUnits.erase(blockEnd - 1);
+
+	for (size_t i = allyTeam + 1; i < teamUnitOffsets.size(); i++) {
+		teamUnitOffsets[i] -= 1;
+	}
+}
+
 void CQuadField::Init(int2 mapDims, int quadSize)
 {
 	quadSizeX = quadSize;
@@ -146,18 +184,19 @@ void CQuadField::Kill()
 		quad.Clear();
 	}
 
-	for (auto cache : tempUnits)
+	for (auto& cache : tempUnits)
 		cache.ReleaseAll();
 
-	for (auto cache : tempFeatures)
+	for (auto& cache : tempFeatures)
 		cache.ReleaseAll();
 
-	tempProjectiles.ReleaseAll();
+	for (auto& cache : tempProjectiles)
+		cache.ReleaseAll();
 
-	for (auto cache : tempSolids)
+	for (auto& cache : tempSolids)
 		cache.ReleaseAll();
 
-	for (auto cache : tempQuads)
+	for (auto& cache : tempQuads)
 		cache.ReleaseAll();
 }
 
@@ -337,8 +376,7 @@ bool CQuadField::InsertUnitIf(CUnit* unit, const float3& wpos)
 	if (!spring::VectorInsertUnique(unit->quads, wposQuadIdx, true))
 		return false;
 
-	spring::VectorInsertUnique(baseQuads[wposQuadIdx].units, unit, false);
-	spring::VectorInsertUnique(baseQuads[wposQuadIdx].teamUnits[unit->allyteam], unit, false);
+	baseQuads[wposQuadIdx].AddUnit(unit, unit->allyteam);
 	return true;
 }
 
@@ -367,8 +405,7 @@ bool CQuadField::RemoveUnitIf(CUnit* unit, const float3& wpos)
 	if (!spring::VectorErase(unit->quads, wposQuadIdx))
 		return false;
 
-	spring::VectorErase(baseQuads[wposQuadIdx].units, unit);
-	spring::VectorErase(baseQuads[wposQuadIdx].teamUnits[unit->allyteam], unit);
+	baseQuads[wposQuadIdx].RemoveUnit(unit, unit->allyteam);
 	return true;
 }
 #endif
@@ -381,20 +418,36 @@ void CQuadField::MovedUnit(CUnit* unit)
 	QuadFieldQuery qfQuery;
 	GetQuads(qfQuery, unit->pos, unit->radius);
 
+	// covers creation, teleports and transfers as well as regular movement
+	for (const int qi: *qfQuery.quads) {
+		baseQuads[qi].activityFrame = gs->frameNum;
+	}
+
+	// footprints can stick out of the radius disc
+	const float3 fpExtents = float3(unit->xsize, 0.0f, unit->zsize) * (SQUARE_SIZE * 0.5f);
+
+	MarkActivity(unit->pos - fpExtents, unit->pos + fpExtents, gs->frameNum);
+
 	// compare if the quads have changed, if not stop here
 	if (qfQuery.quads->size() == unit->quads.size()) {
 		if (std::equal(qfQuery.quads->begin(), qfQuery.quads->end(), unit->quads.begin()))
 			return;
 	}
 
+	// only touch the quads the unit left or entered; both lists are small
+	// and <unit->quads> is not necessarily sorted (see InsertUnitIf)
 	for (const int qi: unit->quads) {
-		spring::VectorErase(baseQuads[qi].units, unit);
-		spring::VectorErase(baseQuads[qi].teamUnits[unit->allyteam], unit);
+		if (std::find(qfQuery.quads->begin(), qfQuery.quads->end(), qi) != qfQuery.quads->end())
+			continue;
+
+		baseQuads[qi].RemoveUnit(unit, unit->allyteam);
 	}
 
 	for (const int qi: *qfQuery.quads) {
-		spring::VectorInsertUnique(baseQuads[qi].units, unit, false);
-		spring::VectorInsertUnique(baseQuads[qi].teamUnits[unit->allyteam], unit, false);
+		if (std::find(unit->quads.begin(), unit->quads.end(), qi) != unit->quads.end())
+			continue;
+
+		baseQuads[qi].AddUnit(unit, unit->allyteam);
 	}
 
 	unit->quads = std::move(*qfQuery.quads);
@@ -403,18 +456,15 @@ void CQuadField::MovedUnit(CUnit* unit)
 void CQuadField::RemoveUnit(CUnit* unit)
 {
 	for (const int qi: unit->quads) {
-		spring::VectorErase(baseQuads[qi].units, unit);
-		spring::VectorErase(baseQuads[qi].teamUnits[unit->allyteam], unit);
+		baseQuads[qi].RemoveUnit(unit, unit->allyteam);
 	}
 
 	unit->quads.clear();
 
 	#ifdef DEBUG_QUADFIELD
 	for (const Quad& q: baseQuads) {
-		for (auto& teamUnits: q.teamUnits) {
-			for (CUnit* u: teamUnits) {
-				assert(u != unit);
-			}
+		for (CUnit* u: q.units) {
+			assert(u != unit);
 		}
 	}
 	#endif
@@ -470,6 +520,7 @@ void CQuadField::AddFeature(CFeature* feature)
 
 	for (const int qi: *qfQuery.quads) {
 		spring::VectorInsertUnique(baseQuads[qi].features, feature, false);
+		baseQuads[qi].activityFrame = gs->frameNum;
 	}
 }
 
@@ -492,6 +543,41 @@ void CQuadField::RemoveFeature(CFeature* feature)
 }
 
 
+void CQuadField::MarkActivity(const float3& pos, float radius, int frame)
+{
+	QuadFieldQuery qfQuery;
+	GetQuads(qfQuery, pos, radius);
+
+	for (const int qi: *qfQuery.quads) {
+		baseQuads[qi].activityFrame = std::max(baseQuads[qi].activityFrame, frame);
+	}
+}
+
+void CQuadField::MarkActivity(const float3& mins, const float3& maxs, int frame)
+{
+	QuadFieldQuery qfQuery;
+	GetQuadsRectangle(qfQuery, mins, maxs);
+
+	for (const int qi: *qfQuery.quads) {
+		baseQuads[qi].activityFrame = std::max(baseQuads[qi].activityFrame, frame);
+	}
+}
+
+int CQuadField::GetLastActivityFrame(const float3& pos, float radius)
+{
+	QuadFieldQuery qfQuery;
+	GetQuads(qfQuery, pos, radius);
+
+	int frame = -1;
+
+	for (const int qi: *qfQuery.quads) {
+		frame = std::max(frame, baseQuads[qi].activityFrame);
+	}
+
+	return frame;
+}
+
+
 
 void CQuadField::MovedProjectile(CProjectile* p)
 {
@@ -602,8 +688,8 @@ void CQuadField::GetUnitsExact(QuadFieldQuery& qfq, const float3& mins, const fl
 {
 	auto curThread = qfq.threadOwner;
 	QuadFieldQuery qfQuery;
-	GetQuadsRectangle(qfQuery, mins, maxs);
 	qfQuery.threadOwner = curThread;
+	GetQuadsRectangle(qfQuery, mins, maxs);
 	const int tempNum = gs->GetMtTempNum(curThread);
 	qfq.units = tempUnits[curThread].ReserveVector();
 
@@ -694,17 +780,19 @@ void CQuadField::GetFeaturesExact(QuadFieldQuery& qfq, const float3& mins, const
 
 void CQuadField::GetProjectilesExact(QuadFieldQuery& qfq, const float3& pos, float radius)
 {
+	auto curThread = qfq.threadOwner;
 	QuadFieldQuery qfQuery;
+	qfQuery.threadOwner = curThread;
 	GetQuads(qfQuery, pos, radius);
-	const int tempNum = gs->GetTempNum();
-	qfq.projectiles = tempProjectiles.ReserveVector();
+	const int tempNum = gs->GetMtTempNum(curThread);
+	qfq.projectiles = tempProjectiles[curThread].ReserveVector();
 
 	for (const int qi: *qfQuery.quads) {
 		for (CProjectile* p: baseQuads[qi].projectiles) {
-			if (p->tempNum == tempNum)
+			if (p->mtTempNum[curThread] == tempNum)
 				continue;
 
-			p->tempNum = tempNum;
+			p->mtTempNum[curThread] = tempNum;
 
 			if (pos.SqDistance(p->pos) >= Square(radius + p->radius))
 				continue;
@@ -718,17 +806,19 @@ void CQuadField::GetProjectilesExact(QuadFieldQuery& qfq, const float3& pos, flo
 
 void CQuadField::GetProjectilesExact(QuadFieldQuery& qfq, const float3& mins, const float3& maxs)
 {
+	auto curThread = qfq.threadOwner;
 	QuadFieldQuery qfQuery;
+	qfQuery.threadOwner = curThread;
 	GetQuadsRectangle(qfQuery, mins, maxs);
-	const int tempNum = gs->GetTempNum();
-	qfq.projectiles = tempProjectiles.ReserveVector();
+	const int tempNum = gs->GetMtTempNum(curThread);
+	qfq.projectiles = tempProjectiles[curThread].ReserveVector();
 
 	for (const int qi: *qfQuery.quads) {
 		for (CProjectile* p: baseQuads[qi].projectiles) {
-			if (p->tempNum == tempNum)
+			if (p->mtTempNum[curThread] == tempNum)
 				continue;
 
-			p->tempNum = tempNum;
+			p->mtTempNum[curThread] = tempNum;
 
 			const float3& pos = p->pos;
 			if (pos.x < mins.x || pos.x > maxs.x)
@@ -804,16 +894,18 @@ bool CQuadField::NoSolidsExact(
 	const unsigned int physicalStateBits,
 	const unsigned int collisionStateBits
 ) {
+	const int curThread = ThreadPool::GetThreadNum();
 	QuadFieldQuery qfQuery;
+	qfQuery.threadOwner = curThread;
 	GetQuads(qfQuery, pos, radius);
-	const int tempNum = gs->GetTempNum();
+	const int tempNum = gs->GetMtTempNum(curThread);
 
 	for (const int qi: *qfQuery.quads) {
 		for (CUnit* u: baseQuads[qi].units) {
-			if (u->tempNum == tempNum)
+			if (u->mtTempNum[curThread] == tempNum)
 				continue;
 
-			u->tempNum = tempNum;
+			u->mtTempNum[curThread] = tempNum;
 
 			if (!u->HasPhysicalStateBit(physicalStateBits))
 				continue;
@@ -826,10 +918,10 @@ bool CQuadField::NoSolidsExact(
 		}
 
 		for (CFeature* f: baseQuads[qi].features) {
-			if (f->tempNum == tempNum)
+			if (f->mtTempNum[curThread] == tempNum)
 				continue;
 
-			f->tempNum = tempNum;
+			f->mtTempNum[curThread] = tempNum;
 
 			if (!f->HasPhysicalStateBit(physicalStateBits))
 				continue;
@@ -854,9 +946,11 @@ void CQuadField::GetUnitsAndFeaturesColVol(
 	std::vector<CFeature*>& features,
 	std::vector<CPlasmaRepulser*>* repulsers
 ) {
-	const int tempNum = gs->GetTempNum();
+	const int curThread = ThreadPool::GetThreadNum();
+	const int tempNum = gs->GetMtTempNum(curThread);
 
 	QuadFieldQuery qfQuery;
+	qfQuery.threadOwner = curThread;
 	GetQuads(qfQuery, pos, radius);
 	// start counting from the previous object-cache sizes
 
@@ -865,10 +959,10 @@ void CQuadField::GetUnitsAndFeaturesColVol(
 
 		for (CUnit* u: quad.units) {
 			// prevent double adding
-			if (u->tempNum == tempNum)
+			if (u->mtTempNum[curThread] == tempNum)
 				continue;
 
-			u->tempNum = tempNum;
+			u->mtTempNum[curThread] = tempNum;
 
 			const auto* colvol = &u->collisionVolume;
 			const float totRad = radius + colvol->GetBoundingRadius();
@@ -881,10 +975,10 @@ void CQuadField::GetUnitsAndFeaturesColVol(
 
 		for (CFeature* f: quad.features) {
 			// prevent double adding
-			if (f->tempNum == tempNum)
+			if (f->mtTempNum[curThread] == tempNum)
 				continue;
 
-			f->tempNum = tempNum;
+			f->mtTempNum[curThread] = tempNum;
 
 			const auto* colvol = &f->collisionVolume;
 			const float totRad = radius + colvol->GetBoundingRadius();
@@ -897,10 +991,10 @@ void CQuadField::GetUnitsAndFeaturesColVol(
 		if (repulsers != nullptr) {
 			for (CPlasmaRepulser* r: quad.repulsers) {
 				// prevent double adding
-				if (r->tempNum == tempNum)
+				if (r->mtTempNum[curThread] == tempNum)
 					continue;
 
-				r->tempNum = tempNum;
+				r->mtTempNum[curThread] = tempNum;
 
 				const auto* colvol = &r->collisionVolume;
 				const float totRad = radius + colvol->GetBoundingRadius();
@@ -158,6 +158,16 @@ public:
 	void MovedUnit(CUnit* unit);
 	void RemoveUnit(CUnit* unit);
 
+	/**
+	 * Stamps every quad overlapping the given area with @c frame, so that
+	 * objects resting there can tell whether their surroundings changed
+	 * (must only be called from the main simulation thread)
+	 */
+	void MarkActivity(const float3& pos, float radius, int frame);
+	void MarkActivity(const float3& mins, const float3& maxs, int frame);
+	/// @return the most recent frame any quad overlapping the area was marked in, or -1
+	int GetLastActivityFrame(const float3& pos, float radius);
+
 	void AddFeature(CFeature* feature);
 	void RemoveFeature(CFeature* feature);
 
@@ -172,10 +182,25 @@ public:
 
 	void ReleaseVector(std::vector<CUnit*>* v       , int onThread = 0) { tempUnits[onThread].ReleaseVector(v); }
 	void ReleaseVector(std::vector<CFeature*>* v    , int onThread = 0) { tempFeatures[onThread].ReleaseVector(v); }
-	void ReleaseVector(std::vector<CProjectile*>* v ) { tempProjectiles.ReleaseVector(v); }
+	void ReleaseVector(std::vector<CProjectile*>* v , int onThread = 0) { tempProjectiles[onThread].ReleaseVector(v); }
 	void ReleaseVector(std::vector<CSolidObject*>* v, int onThread = 0) { tempSolids[onThread].ReleaseVector(v); }
 	void ReleaseVector(std::vector<int>* v          , int onThread = 0) { tempQuads[onThread].ReleaseVector(v); }
 
+	/// contiguous [begin, end) view into a quad's object storage
+	template<typename T>
+	struct ObjectRange {
+	public:
+		const T* begin() const { return beg; }
+		const T* end() const { return fin; }
+
+		size_t size() const { return (fin - beg); }
+		bool empty() const { return (beg == fin); }
+
+	public:
+		const T* beg;
+		const T* fin;
+	};
+
 	struct Quad {
 	public:
 		CR_DECLARE_STRUCT(Quad)
@@ -188,32 +213,52 @@ public:
 		Quad& operator = (Quad&& q) {
 			units = std::move(q.units);
 			teamUnits = std::move(q.teamUnits);
+			teamUnitOffsets = std::move(q.teamUnitOffsets);
 			features = std::move(q.features);
 			projectiles = std::move(q.projectiles);
 			repulsers = std::move(q.repulsers);
+			activityFrame = q.activityFrame;
 			return *this;
 		}
 
 		void PostLoad();
-		void Resize(int numAllyTeams) { teamUnits.resize(numAllyTeams); }
+		void Resize(int numAllyTeams) { teamUnitOffsets.assign(numAllyTeams + 1, 0); }
 		void Clear() {
 			units.clear();
-			// reuse inner vectors when reloading
-			// teamUnits.clear();
-			for (auto& v: teamUnits) {
-				v.clear();
-			}
+			teamUnits.clear();
+			std::fill(teamUnitOffsets.begin(), teamUnitOffsets.end(), 0);
 			features.clear();
 			projectiles.clear();
 			repulsers.clear();
+			activityFrame = -1;
+		}
+
+		void AddUnit(CUnit* unit, int allyTeam);
+		void RemoveUnit(CUnit* unit, int allyTeam);
+
+		ObjectRange<CUnit*> GetTeamUnits(int allyTeam) const {
+			assert(size_t(allyTeam + 1) < teamUnitOffsets.size());
+			CUnit* const* base = teamUnits.data();
+			return {base + teamUnitOffsets[allyTeam], base + teamUnitOffsets[allyTeam + 1]};
 		}
 
 	public:
 		std::vector<CUnit*> units;
-		std::vector< std::vector<CUnit*> > teamUnits;
 		std::vector<CFeature*> features;
 		std::vector<CProjectile*> projectiles;
 		std::vector<CPlasmaRepulser*> repulsers;
+
+		// last sim-frame in which anything moved into, within or out of
+		// this quad (or the terrain under it changed); see MarkActivity
+		int activityFrame = -1;
+
+	private:
+		// all units of this quad grouped by allyteam, those of allyteam <t>
+		// occupy [teamUnitOffsets[t], teamUnitOffsets[t + 1]); one array per
+		// quad instead of one per allyteam keeps the quad to a fixed number
+		// of allocations and lets GetTeamUnits stream a contiguous block
+		std::vector<CUnit*> teamUnits;
+		std::vector<unsigned int> teamUnitOffsets;
 	};
 
 	const Quad& GetQuad(unsigned i) const {
@@ -232,19 +277,18 @@ public:
 	int GetQuadSizeX() const { return quadSizeX; }
 	int GetQuadSizeZ() const { return quadSizeZ; }
 
-	constexpr static unsigned int BASE_QUAD_SIZE = 128;
-
-private:
 	int2 WorldPosToQuadField(const float3 p) const;
 	int WorldPosToQuadFieldIdx(const float3 p) const;
 
+	constexpr static unsigned int BASE_QUAD_SIZE = 128;
+
 private:
 	std::vector<Quad> baseQuads;
 
 	// preallocated vectors for Get*Exact functions
 	std::array< QueryVectorCache<CUnit*>, ThreadPool::MAX_THREADS >  tempUnits;
 	std::array< QueryVectorCache<CFeature*>, ThreadPool::MAX_THREADS >  tempFeatures;
-	QueryVectorCache<CProjectile*> tempProjectiles;
+	std::array< QueryVectorCache<CProjectile*>, ThreadPool::MAX_THREADS > tempProjectiles;
 	std::array< QueryVectorCache<CSolidObject*>, ThreadPool::MAX_THREADS > tempSolids;
 	std::array< QueryVectorCache<int>, ThreadPool::MAX_THREADS > tempQuads;
 
@@ -260,11 +304,17 @@ private:
 extern CQuadField quadField;
 
 
+/**
+ * Result of a quadfield query. All queries are safe to run concurrently
+ * from different threads: result vectors come from per-thread caches and
+ * objects are deduplicated via their per-thread mtTempNum stamps, both
+ * selected by <threadOwner> (which defaults to the calling thread).
+ */
 struct QuadFieldQuery {
 	~QuadFieldQuery() {
 		quadField.ReleaseVector(units, threadOwner);
 		quadField.ReleaseVector(features, threadOwner);
-		quadField.ReleaseVector(projectiles);
+		quadField.ReleaseVector(projectiles, threadOwner);
 		quadField.ReleaseVector(solids, threadOwner);
 		quadField.ReleaseVector(quads, threadOwner);
 	}
@@ -274,7 +324,7 @@ struct QuadFieldQuery {
 	std::vector<CProjectile*>* projectiles = nullptr;
 	std::vector<CSolidObject*>* solids = nullptr;
 	std::vector<int>* quads = nullptr;
-	int threadOwner = 0;
+	int threadOwner = ThreadPool::GetThreadNum();
 };
 
 
@@ -0,0 +1,161 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include <algorithm>
+
+#include "UnitBroadphase.h"
+#include "GlobalConstants.h"
+#include "Map/ReadMap.h"
+#include "Sim/Units/Unit.h"
+#include "System/SpringMath.h"
+
+CUnitBroadphase unitBroadphase;
+
+// bounds for the cell size, in elmos
+static constexpr float MIN_CELL_SIZE = SQUARE_SIZE *  4.0f;
+static constexpr float MAX_CELL_SIZE = SQUARE_SIZE * 32.0f;
+
+
+void CUnitBroadphase::Kill()
+{
+	valid = false;
+
+	entries.clear();
+	cellOffsets.clear();
+	cellEntries.clear();
+
+	for (std::vector<int>& v: queryEntries) {
+		v.clear();
+	}
+	for (std::vector<CUnit*>& v: queryUnits) {
+		v.clear();
+	}
+}
+
+int2 CUnitBroadphase::GetCell(float x, float z) const
+{
+	return {
+		Clamp(int(x * invCellSize), 0, numCells.x - 1),
+		Clamp(int(z * invCellSize), 0, numCells.y - 1)
+	};
+}
+
+
+void CUnitBroadphase::Build(const std::vector<CUnit*>& units)
+{
+	entries.clear();
+	entries.reserve(units.size());
+
+	float maxMobileRadius = 0.0f;
+
+	for (CUnit* unit: units) {
+		// mirror QuadField membership
+		if (unit->quads.empty())
+			continue;
+
+		entries.push_back({unit->pos, unit->radius, unit->id, {0, 0}, {0, 0}, unit});
+
+		if (unit->moveDef == nullptr)
+			continue;
+
+		maxMobileRadius = std::max(maxMobileRadius, unit->radius);
+	}
+
+	// id-order makes ascending entry indices equal ascending unit ids
+	std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return (a.id < b.id); });
+
+	// one mobile footprint per cell; larger (mostly static) units span several
+	cellSize = Clamp(maxMobileRadius * 2.0f, MIN_CELL_SIZE, MAX_CELL_SIZE);
+	invCellSize = 1.0f / cellSize;
+	numCells.x = int(math::ceil((mapDims.mapx * SQUARE_SIZE) * invCellSize));
+	numCells.y = int(math::ceil((mapDims.mapy * SQUARE_SIZE) * invCellSize));
+
+	for_mt(0, entries.size(), [&](const int i) {
+		Entry& e = entries[i];
+
+		e.minCell = GetCell(e.pos.x - e.radius, e.pos.z - e.radius);
+		e.maxCell = GetCell(e.pos.x + e.radius, e.pos.z + e.radius);
+	});
+
+	// counting-sort entries into cells; filled serially so that each cell
+	// lists its entries in ascending order independent of the thread count
+	cellOffsets.clear();
+	cellOffsets.resize(numCells.x * numCells.y + 1, 0);
+
+	for (const Entry& e: entries) {
+		for (int z = e.minCell.y; z <= e.maxCell.y; z++) {
+			for (int x = e.minCell.x; x <= e.maxCell.x; x++) {
+				cellOffsets[z * numCells.x + x + 1] += 1;
+			}
+		}
+	}
+
+	for (size_t i = 1; i < cellOffsets.size(); i++) {
+		cellOffsets[i] += cellOffsets[i - 1];
+	}
+
+	cellEntries.resize(cellOffsets.back());
+
+	{
+		std::vector<int> cellFill(cellOffsets.begin(), cellOffsets.end() - 1);
+
+		for (int i = 0, n = entries.size(); i < n; i++) {
+			const Entry& e = entries[i];
+
+			for (int z = e.minCell.y; z <= e.maxCell.y; z++) {
+				for (int x = e.minCell.x; x <= e.maxCell.x; x++) {
+					cellEntries[cellFill[z * numCells.x + x]++] = i;
+				}
+			}
+		}
+	}
+
+	valid = true;
+}
+
+
+const std::vector<CUnit*>& CUnitBroadphase::GetUnitsExact(const float3& pos, float radius, int thread)
+{
+	assert(valid);
+
+	std::vector<int>& indices = queryEntries[thread];
+	std::vector<CUnit*>& units = queryUnits[thread];
+
+	indices.clear();
+	units.clear();
+
+	const int2 minCell = GetCell(pos.x - radius, pos.z - radius);
+	const int2 maxCell = GetCell(pos.x + radius, pos.z + radius);
+
+	for (int z = minCell.y; z <= maxCell.y; z++) {
+		for (int x = minCell.x; x <= maxCell.x; x++) {
+			const int cellIdx = z * numCells.x + x;
+
+			for (int j = cellOffsets[cellIdx], n = cellOffsets[cellIdx + 1]; j < n; j++) {
+				const int entryIdx = cellEntries[j];
+				const Entry& e = entries[entryIdx];
+
+				// an entry spanning several cells is only tested in the first
+				// one it shares with the query rectangle, avoiding duplicates
+				if (std::max(e.minCell.x, minCell.x) != x || std::max(e.minCell.y, minCell.y) != z)
+					continue;
+
+				// same test as CQuadField::GetUnitsExact
+				const float totRad   = radius + e.radius;
+				const float totRadSq = totRad * totRad;
+
+				if (pos.SqDistance(e.pos) >= totRadSq)
+					continue;
+
+				indices.push_back(entryIdx);
+			}
+		}
+	}
+
+	std::sort(indices.begin(), indices.end());
+
+	for (const int entryIdx: indices) {
+		units.push_back(entries[entryIdx].unit);
+	}
+
+	return units;
+}
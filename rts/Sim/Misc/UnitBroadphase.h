@@ -0,0 +1,72 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef UNIT_BROADPHASE_H
+#define UNIT_BROADPHASE_H
+
+#include <array>
+#include <vector>
+
+#include "System/Threading/ThreadPool.h"
+#include "System/float3.h"
+#include "System/type2.h"
+
+class CUnit;
+
+/**
+ * Uniform grid over a snapshot of all units registered in the QuadField,
+ * rebuilt by CUnitHandler before each movetype stage during which unit
+ * positions stay fixed. Cells are sized by the largest mobile footprint,
+ * so the dense unit blobs that dominate collision handling are resolved
+ * by visiting a handful of compact cells rather than by QuadField walks.
+ */
+class CUnitBroadphase
+{
+public:
+	void Kill();
+
+	/// snapshots <units>, positions must not change until Clear() is called
+	void Build(const std::vector<CUnit*>& units);
+	void Clear() { valid = false; }
+
+	bool IsValid() const { return valid; }
+
+	/**
+	 * Same set of units as CQuadField::GetUnitsExact(pos, radius, true)
+	 * but sorted by ascending id; the returned vector is owned by <thread>
+	 * and overwritten by its next query.
+	 */
+	const std::vector<CUnit*>& GetUnitsExact(const float3& pos, float radius, int thread);
+
+private:
+	struct Entry {
+		float3 pos;
+		float radius;
+		int id;
+		int2 minCell;
+		int2 maxCell;
+		CUnit* unit;
+	};
+
+	int2 GetCell(float x, float z) const;
+
+private:
+	std::vector<Entry> entries;
+
+	// entries overlapping cell i are cellEntries[cellOffsets[i] .. cellOffsets[i + 1]]
+	std::vector<int> cellOffsets;
+	std::vector<int> cellEntries;
+
+	std::array<std::vector<int>, ThreadPool::MAX_THREADS> queryEntries;
+	std::array<std::vector<CUnit*>, ThreadPool::MAX_THREADS> queryUnits;
+
+	int2 numCells;
+
+	float cellSize = 0.0f;
+	float invCellSize = 0.0f;
+
+	bool valid = false;
+};
+
+extern CUnitBroadphase unitBroadphase;
+
+#endif // UNIT_BROADPHASE_H
@@ -18,6 +18,7 @@
 #include "Sim/Misc/ModInfo.h"
 #include "Sim/Misc/QuadField.h"
 #include "Sim/Misc/TeamHandler.h"
+#include "Sim/Misc/UnitBroadphase.h"
 #include "Sim/Path/IPathManager.h"
 #include "Sim/Units/Scripts/CobInstance.h"
 #include "Sim/Units/CommandAI/CommandAI.h"
@@ -243,6 +244,16 @@ static bool CheckCollisionInclSAT(
 
 
 
+static const std::vector<CUnit*>& GetUnitsExact(QuadFieldQuery& qfQuery, const float3& pos, float radius)
+{
+	// the broadphase is only built for stages during which no unit moves
+	if (unitBroadphase.IsValid())
+		return (unitBroadphase.GetUnitsExact(pos, radius, qfQuery.threadOwner));
+
+	quadField.GetUnitsExact(qfQuery, pos, radius);
+	return *qfQuery.units;
+}
+
 static void HandleUnitCollisionsAux(
 	const CUnit* collider,
 	const CUnit* collidee,
@@ -572,10 +583,28 @@ void CGroundMoveType::UpdateCollisionDetections() {
 	if (owner->GetTransporter() != nullptr) return;
 	if (owner->IsSkidding()) return;
 	if (owner->IsFalling()) return;
+	if (IsParked()) return;
 
 	HandleObjectCollisions();
 }
 
+bool CGroundMoveType::IsParked() const {
+	// a unit that has nowhere to go, stands still and was not pushed last
+	// frame can only start colliding again if something moves near it, so
+	// skip collision detection until its surrounding quads see activity
+	if (progressState == Active || pathID != 0)
+		return false;
+	if (owner->speed.w != 0.0f || resultantForces != ZeroVector)
+		return false;
+	if (owner->beingBuilt || owner->IsFlying() || owner->UnderFirstPersonControl())
+		return false;
+
+	const float queryRadius = owner->radius + owner->moveDef->CalcFootPrintMaxInteriorRadius();
+	const int lastActivity = quadField.GetLastActivityFrame(owner->pos, queryRadius);
+
+	return (lastActivity < (gs->frameNum - 1));
+}
+
 void CGroundMoveType::ProcessCollisionEvents() {
 	SyncWaypoints();
 
@@ -1593,14 +1622,19 @@ float3 CGroundMoveType::GetObstacleAvoidanceDir(const float3& desiredDir) {
 	const float avoidanceRadius = std::max(currentSpeed, 1.0f) * (avoider->radius * 2.0f);
 	const float avoiderRadius = avoiderMD->CalcFootPrintMinExteriorRadius();
 
+	// features have no MoveDef and would be skipped below, so query units only
 	QuadFieldQuery qfQuery;
 	qfQuery.threadOwner = ThreadPool::GetThreadNum();
-	quadField.GetSolidsExact(qfQuery, avoider->pos, avoidanceRadius, 0xFFFFFFFF, CSolidObject::CSTATE_BIT_SOLIDOBJECTS);
 
-	for (const CSolidObject* avoidee: *qfQuery.solids) {
+	for (const CSolidObject* avoidee: GetUnitsExact(qfQuery, avoider->pos, avoidanceRadius)) {
 		const MoveDef* avoideeMD = avoidee->moveDef;
 		const UnitDef* avoideeUD = dynamic_cast<const UnitDef*>(avoidee->GetDef());
 
+		if (!avoidee->HasPhysicalStateBit(0xFFFFFFFF))
+			continue;
+		if (!avoidee->HasCollidableStateBit(CSolidObject::CSTATE_BIT_SOLIDOBJECTS))
+			continue;
+
 		// cases in which there is no need to avoid this obstacle
 		if (avoidee == owner)
 			continue;
@@ -2536,9 +2570,10 @@ void CGroundMoveType::HandleUnitCollisions(
 	// copy on purpose, since the below can call Lua
 	QuadFieldQuery qfQuery;
 	qfQuery.threadOwner = curThread;
-	quadField.GetUnitsExact(qfQuery, collider->pos, colliderParams.x + (colliderParams.y * 2.0f));
 
-	for (CUnit* collidee: *qfQuery.units) {
+	const std::vector<CUnit*>& collidees = GetUnitsExact(qfQuery, collider->pos, colliderParams.x + (colliderParams.y * 2.0f));
+
+	for (CUnit* collidee: collidees) {
 		if (collidee == collider) continue;
 		if (collidee->IsSkidding()) continue;
 		if (collidee->IsFlying()) continue;
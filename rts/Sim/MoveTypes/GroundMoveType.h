@@ -150,6 +150,7 @@ private:
 	void Arrived(bool callScript);
 	void Fail(bool callScript);
 
+	bool IsParked() const;
 	void HandleObjectCollisions();
 	bool HandleStaticObjectCollision(
 		CUnit* collider,
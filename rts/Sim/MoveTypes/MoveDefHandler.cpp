@@ -138,6 +138,8 @@ void MoveDefHandler::Init(LuaParser* defsParser)
 	crc << CMoveMath::noHoverWaterMove;
 
 	mdChecksum = crc.GetDigest();
+
+	CMoveMath::InitSpeedModRasters();
 }
 
 
@@ -347,34 +349,6 @@ float MoveDef::CalcFootPrintAxisStretchFactor() const
 }
 
 
-float MoveDef::GetDepthMod(float height) const {
-	// [DEPTHMOD_{MIN, MAX}_HEIGHT] are always >= 0,
-	// so we return early for positive height values
-	// only negative heights ("depths") are allowed
-	if (height > -depthModParams[DEPTHMOD_MIN_HEIGHT])
-		return 1.0f;
-	if (height < -depthModParams[DEPTHMOD_MAX_HEIGHT])
-		return 0.0f;
-
-	const float a = depthModParams[DEPTHMOD_QUA_COEFF];
-	const float b = depthModParams[DEPTHMOD_LIN_COEFF];
-	const float c = depthModParams[DEPTHMOD_CON_COEFF];
-
-	const float minScale = 0.01f;
-	const float maxScale = depthModParams[DEPTHMOD_MAX_SCALE];
-
-	const float depth = -height;
-	const float scale = Clamp((a * depth * depth + b * depth + c), minScale, maxScale);
-
-	// NOTE:
-	//   <maxScale> is guaranteed to be >= 0.01, so the
-	//   depth-mod range is [1.0 / 0.01, 1.0 / +infinity]
-	//
-	//   if minScale <= scale <       1.0, speedup
-	//   if      1.0 <  scale <= maxScale, slowdown
-	return (1.0f / scale);
-}
-
 unsigned int MoveDef::CalcCheckSum() const {
 	unsigned int sum = 0;
 
@@ -1,16 +1,22 @@
 /* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
 
+#include <algorithm>
+#include <array>
+#include <vector>
+
 #include "MoveMath.h"
 
 #include "Map/Ground.h"
 #include "Map/MapInfo.h"
 #include "Sim/Misc/GlobalSynced.h"
 #include "Sim/Misc/GroundBlockingObjectMap.h"
+#include "Sim/Misc/ModInfo.h"
 #include "Sim/MoveTypes/MoveDefHandler.h"
 #include "Sim/MoveTypes/MoveType.h"
 #include "Sim/Objects/SolidObject.h"
 #include "Sim/Units/Unit.h"
 #include "System/Platform/Threading.h"
+#include "System/Threading/ThreadPool.h"
 
 bool CMoveMath::noHoverWaterMove = false;
 float CMoveMath::waterDamageCost = 0.0f;
@@ -45,29 +51,174 @@ float CMoveMath::yLevel(const MoveDef& moveDef, const float3& pos)
 
 
 
+// GetPosSpeedMod values at half-heightmap resolution, one raster per distinct
+// set of speed-mod inputs (MoveDefs usually differ only in footprint size), at
+// [speedModRasterIndices[pathType] * (hmapx * hmapy) + hmIdx]; empty until InitSpeedModRasters
+static std::vector<float> speedModRasters;
+static std::vector<unsigned int> speedModRasterIndices;
+// first MoveDef of each raster, the one it is computed for
+static std::vector<const MoveDef*> speedModRasterDefs;
+
+static bool HaveSpeedModRaster(const MoveDef& moveDef)
+{
+	if (speedModRasters.empty())
+		return false;
+	if (moveDef.pathType >= moveDefHandler.GetNumMoveDefs())
+		return false;
+
+	// MoveDefs not owned by the handler have no raster
+	return (&moveDef == moveDefHandler.GetMoveDefByPathType(moveDef.pathType));
+}
+
+static const float* GetSpeedModRaster(const MoveDef& moveDef)
+{
+	return &speedModRasters[speedModRasterIndices[moveDef.pathType] * (mapDims.hmapx * mapDims.hmapy)];
+}
+
+// true if GetPosSpeedMod (without a direction) can not tell <a> and <b> apart
+static bool SameSpeedModInputs(const MoveDef& a, const MoveDef& b)
+{
+	if (a.speedModClass != b.speedModClass)
+		return false;
+	if (a.maxSlope != b.maxSlope || a.slopeMod != b.slopeMod || a.depth != b.depth)
+		return false;
+
+	return (std::equal(std::begin(a.depthModParams), std::end(a.depthModParams), std::begin(b.depthModParams)));
+}
+
+
+float CMoveMath::CalcHalfSquareSpeedMod(const MoveDef& moveDef, unsigned int hmIdx)
+{
+	const int squareTerrType = readMap->GetTypeMapSynced()[hmIdx];
+
+	const float height  = readMap->GetMIPHeightMapSynced(1)[hmIdx];
+	const float slope   = readMap->GetSlopeMapSynced()[hmIdx];
+
+	return (TerrainSpeedMod(moveDef, height, slope, mapInfo->terrainTypes[squareTerrType]));
+}
+
+void CMoveMath::CalcHalfRowSpeedMods(const MoveDef& moveDef, unsigned int hmx1, unsigned int hmx2, unsigned int hmz, float* speedMods)
+{
+	const unsigned int rowIdx = hmz * mapDims.hmapx + hmx1;
+
+	const unsigned char* typeRow = readMap->GetTypeMapSynced() + rowIdx;
+	const float* heightRow = readMap->GetMIPHeightMapSynced(1) + rowIdx;
+	const float* slopeRow = readMap->GetSlopeMapSynced() + rowIdx;
+
+	TerrainSpeedModRow(moveDef, heightRow, slopeRow, typeRow, &mapInfo->terrainTypes[0], hmx2 - hmx1, speedMods);
+}
+
+
+void CMoveMath::InitSpeedModRasters()
+{
+	speedModRasters.clear();
+	speedModRasterIndices.clear();
+	speedModRasterDefs.clear();
+
+	for (unsigned int pathType = 0, numMoveDefs = moveDefHandler.GetNumMoveDefs(); pathType < numMoveDefs; pathType++) {
+		const MoveDef* md = moveDefHandler.GetMoveDefByPathType(pathType);
+		const auto pred = [md](const MoveDef* rmd) { return (SameSpeedModInputs(*md, *rmd)); };
+		const auto iter = std::find_if(speedModRasterDefs.begin(), speedModRasterDefs.end(), pred);
+
+		speedModRasterIndices.push_back(iter - speedModRasterDefs.begin());
+
+		if (iter == speedModRasterDefs.end())
+			speedModRasterDefs.push_back(md);
+	}
+
+	speedModRasters.resize(speedModRasterDefs.size() * mapDims.hmapx * mapDims.hmapy, 0.0f);
+
+	UpdateSpeedModRasters(0, 0, mapDims.mapx - 1, mapDims.mapy - 1);
+}
+
+void CMoveMath::KillSpeedModRasters()
+{
+	speedModRasters.clear();
+	speedModRasterIndices.clear();
+	speedModRasterDefs.clear();
+}
+
+/* Recalculate the rasters over the (inclusive) square-rectangle {x1, z1} - {x2, z2} */
+void CMoveMath::UpdateSpeedModRasters(int x1, int z1, int x2, int z2)
+{
+	if (speedModRasters.empty())
+		return;
+
+	// pad to the half-squares whose slopes CReadMap::UpdateSlopemap rewrites
+	// after a heightmap change over the same rectangle; slopes are sampled
+	// from the (one square larger) center-heightmap rectangle around it
+	const int hmx1 = std::max(((x1 - 1) >> 1) - 1, 0);
+	const int hmz1 = std::max(((z1 - 1) >> 1) - 1, 0);
+	const int hmx2 = std::min(((x2 + 1) >> 1) + 1, mapDims.hmapx - 1) + 1;
+	const int hmz2 = std::min(((z2 + 1) >> 1) + 1, mapDims.hmapy - 1) + 1;
+
+	if (hmx1 >= hmx2 || hmz1 >= hmz2)
+		return;
+
+	const int numRows = hmz2 - hmz1;
+	const int numJobs = speedModRasterDefs.size() * numRows;
+	const int rasterSize = mapDims.hmapx * mapDims.hmapy;
+
+	const auto UpdateRow = [&](int jobIdx) {
+		const unsigned int rasterIdx = jobIdx / numRows;
+		const unsigned int hmz = hmz1 + (jobIdx % numRows);
+
+		CalcHalfRowSpeedMods(*speedModRasterDefs[rasterIdx], hmx1, hmx2, hmz, &speedModRasters[rasterIdx * rasterSize + hmz * mapDims.hmapx + hmx1]);
+	};
+
+	// single-square changes (e.g. from Lua) are not worth waking the pool for
+	if ((numJobs * (hmx2 - hmx1)) < (64 * 64)) {
+		for (int i = 0; i < numJobs; i++) {
+			UpdateRow(i);
+		}
+	} else {
+		for_mt(0, numJobs, UpdateRow);
+	}
+}
+
+
 /* calculate the local speed-modifier for this MoveDef */
 float CMoveMath::GetPosSpeedMod(const MoveDef& moveDef, unsigned xSquare, unsigned zSquare)
 {
 	if (xSquare >= mapDims.mapx || zSquare >= mapDims.mapy)
 		return 0.0f;
 
-	const int square = (xSquare >> 1) + ((zSquare >> 1) * mapDims.hmapx);
-	const int squareTerrType = readMap->GetTypeMapSynced()[square];
+	const unsigned int square = (xSquare >> 1) + ((zSquare >> 1) * mapDims.hmapx);
 
-	const float height  = readMap->GetMIPHeightMapSynced(1)[square];
-	const float slope   = readMap->GetSlopeMapSynced()[square];
+	if (HaveSpeedModRaster(moveDef))
+		return (GetSpeedModRaster(moveDef)[square]);
 
-	const CMapInfo::TerrainType& tt = mapInfo->terrainTypes[squareTerrType];
+	return (CalcHalfSquareSpeedMod(moveDef, square));
+}
 
-	switch (moveDef.speedModClass) {
-		case MoveDef::Tank:  { return (GroundSpeedMod(moveDef, height, slope) * tt.tankSpeed ); } break;
-		case MoveDef::KBot:  { return (GroundSpeedMod(moveDef, height, slope) * tt.kbotSpeed ); } break;
-		case MoveDef::Hover: { return ( HoverSpeedMod(moveDef, height, slope) * tt.hoverSpeed); } break;
-		case MoveDef::Ship:  { return (  ShipSpeedMod(moveDef, height, slope) * tt.shipSpeed ); } break;
-		default: {} break;
+void CMoveMath::GetPosSpeedModRow(const MoveDef& moveDef, unsigned int xmin, unsigned int xmax, unsigned int zSquare, float* speedMods)
+{
+	const unsigned int xend = (zSquare < mapDims.mapy)? std::max(xmin, std::min(xmax, unsigned(mapDims.mapx))): xmin;
+
+	if (HaveSpeedModRaster(moveDef)) {
+		const float* halfRow = GetSpeedModRaster(moveDef) + (zSquare >> 1) * mapDims.hmapx;
+
+		for (unsigned int x = xmin; x < xend; x++) {
+			speedMods[x - xmin] = halfRow[x >> 1];
+		}
+	} else {
+		std::array<float, 256> halfRow;
+
+		// compute in chunks of at most halfRow.size() half-squares
+		for (unsigned int x = xmin; x < xend; ) {
+			const unsigned int hmx1 = x >> 1;
+			const unsigned int hmx2 = std::min(((xend - 1) >> 1) + 1, hmx1 + unsigned(halfRow.size()));
+
+			CalcHalfRowSpeedMods(moveDef, hmx1, hmx2, zSquare >> 1, halfRow.data());
+
+			for (const unsigned int chunkEnd = std::min(xend, hmx2 << 1); x < chunkEnd; x++) {
+				speedMods[x - xmin] = halfRow[(x >> 1) - hmx1];
+			}
+		}
 	}
 
-	return 0.0f;
+	// squares outside the map are impassable
+	std::fill(speedMods + (xend - xmin), speedMods + (xmax - xmin), 0.0f);
 }
 
 float CMoveMath::GetPosSpeedMod(const MoveDef& moveDef, unsigned xSquare, unsigned zSquare, float3 moveDir)
@@ -75,6 +226,10 @@ float CMoveMath::GetPosSpeedMod(const MoveDef& moveDef, unsigned xSquare, unsign
 	if (xSquare >= mapDims.mapx || zSquare >= mapDims.mapy)
 		return 0.0f;
 
+	// without directional pathing only ships depend on moveDir
+	if (!modInfo.allowDirectionalPathing && moveDef.speedModClass != MoveDef::Ship)
+		return (GetPosSpeedMod(moveDef, xSquare, zSquare));
+
 	const int square = (xSquare >> 1) + ((zSquare >> 1) * mapDims.hmapx);
 	const int squareTerrType = readMap->GetTypeMapSynced()[square];
 
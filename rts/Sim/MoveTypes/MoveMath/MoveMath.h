@@ -3,6 +3,7 @@
 #ifndef MOVEMATH_H
 #define MOVEMATH_H
 
+#include "Map/MapInfo.h"
 #include "Map/ReadMap.h"
 #include "System/float3.h"
 #include "System/Misc/BitwiseEnum.h"
@@ -49,6 +50,28 @@ public:
 		return (GetPosSpeedMod(moveDef, pos.x / SQUARE_SIZE, pos.z / SQUARE_SIZE, moveDir));
 	}
 
+	// batched GetPosSpeedMod, fills speedMods[x - xmin] for the squares x in [xmin, xmax) of row zSquare
+	static void GetPosSpeedModRow(const MoveDef& moveDef, unsigned int xmin, unsigned int xmax, unsigned int zSquare, float* speedMods);
+
+	// GetPosSpeedMod of a single half-heightmap square given its map data, and
+	// a bit-identical SIMD version for <count> consecutive ones; pure functions
+	static float TerrainSpeedMod(const MoveDef& moveDef, float height, float slope, const CMapInfo::TerrainType& tt);
+	static void TerrainSpeedModRow(
+		const MoveDef& moveDef,
+		const float* heights,
+		const float* slopes,
+		const unsigned char* types,
+		const CMapInfo::TerrainType* terrainTypes,
+		unsigned int count,
+		float* speedMods
+	);
+
+	// rasters of GetPosSpeedMod values (shared by MoveDefs with equal inputs), must be refreshed
+	// (before notifying the path managers) whenever terrain changes
+	static void InitSpeedModRasters();
+	static void KillSpeedModRasters();
+	static void UpdateSpeedModRasters(int x1, int z1, int x2, int z2);
+
 	// tells whether a position is blocked (inaccessable for a given object's MoveDef)
 	static inline BlockType IsBlocked(const MoveDef& moveDef, const float3& pos, const CSolidObject* collider);
 	static inline BlockType IsBlocked(const MoveDef& moveDef, int xSquare, int zSquare, const CSolidObject* collider);
@@ -75,6 +98,10 @@ public:
 	static BlockType RangeIsBlocked(const MoveDef& moveDef, int xmin, int xmax, int zmin, int zmax, const CSolidObject* collider, int thread = 0);
 
 private:
+	// speed-mods of half-heightmap squares, the resolution GetPosSpeedMod samples at
+	static float CalcHalfSquareSpeedMod(const MoveDef& moveDef, unsigned int hmIdx);
+	static void CalcHalfRowSpeedMods(const MoveDef& moveDef, unsigned int hmx1, unsigned int hmx2, unsigned int hmz, float* speedMods);
+
 	static BlockType RangeIsBlockedSt(const MoveDef& moveDef, int xmin, int xmax, int zmin, int zmax, const CSolidObject* collider);
 	static BlockType RangeIsBlockedMt(const MoveDef& moveDef, int xmin, int xmax, int zmin, int zmax, const CSolidObject* collider, int thread);
 
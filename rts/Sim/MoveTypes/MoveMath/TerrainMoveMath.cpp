@@ -0,0 +1,124 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include <algorithm>
+#include <xmmintrin.h>
+
+#include "MoveMath.h"
+#include "Sim/MoveTypes/MoveDefHandler.h"
+
+static inline __m128 SelectPS(__m128 mask, __m128 a, __m128 b) { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+static inline __m128 NegatePS(__m128 v) { return _mm_xor_ps(v, _mm_set1_ps(-0.0f)); }
+
+// the lane kernels evaluate the same expressions in the same order as
+// the scalar *SpeedMod functions, so both produce bit-identical results
+static inline __m128 DepthModPS(const MoveDef& moveDef, __m128 height, __m128 depth)
+{
+	const float* params = moveDef.depthModParams;
+
+	const __m128 a = _mm_set1_ps(params[MoveDef::DEPTHMOD_QUA_COEFF]);
+	const __m128 b = _mm_set1_ps(params[MoveDef::DEPTHMOD_LIN_COEFF]);
+	const __m128 c = _mm_set1_ps(params[MoveDef::DEPTHMOD_CON_COEFF]);
+
+	const __m128 poly = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_mul_ps(a, depth), depth), _mm_mul_ps(b, depth)), c);
+	const __m128 scale = _mm_min_ps(_mm_max_ps(poly, _mm_set1_ps(0.01f)), _mm_set1_ps(params[MoveDef::DEPTHMOD_MAX_SCALE]));
+
+	const __m128 shallow = _mm_cmpgt_ps(height, _mm_set1_ps(-params[MoveDef::DEPTHMOD_MIN_HEIGHT]));
+	const __m128 tooDeep = _mm_cmplt_ps(height, _mm_set1_ps(-params[MoveDef::DEPTHMOD_MAX_HEIGHT]));
+
+	return (SelectPS(shallow, _mm_set1_ps(1.0f), _mm_andnot_ps(tooDeep, _mm_div_ps(_mm_set1_ps(1.0f), scale))));
+}
+
+static inline __m128 GroundSpeedModPS(const MoveDef& moveDef, __m128 height, __m128 slope)
+{
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 depth = NegatePS(height);
+
+	// slope too steep or square too deep?
+	const __m128 blocked = _mm_or_ps(_mm_cmpgt_ps(slope, _mm_set1_ps(moveDef.maxSlope)), _mm_cmpgt_ps(depth, _mm_set1_ps(moveDef.depth)));
+
+	__m128 speedMod = _mm_div_ps(one, _mm_add_ps(one, _mm_mul_ps(slope, _mm_set1_ps(moveDef.slopeMod))));
+	speedMod = _mm_mul_ps(speedMod, SelectPS(_mm_cmplt_ps(height, _mm_setzero_ps()), _mm_set1_ps(CMoveMath::waterDamageCost), one));
+	speedMod = _mm_mul_ps(speedMod, DepthModPS(moveDef, height, depth));
+
+	return (_mm_andnot_ps(blocked, speedMod));
+}
+
+static inline __m128 HoverSpeedModPS(const MoveDef& moveDef, __m128 height, __m128 slope)
+{
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 waterSpeedMod = _mm_set1_ps(1.0f * !CMoveMath::noHoverWaterMove);
+
+	__m128 speedMod = _mm_div_ps(one, _mm_add_ps(one, _mm_mul_ps(slope, _mm_set1_ps(moveDef.slopeMod))));
+	speedMod = _mm_andnot_ps(_mm_cmpgt_ps(slope, _mm_set1_ps(moveDef.maxSlope)), speedMod);
+
+	return (SelectPS(_mm_cmplt_ps(height, _mm_setzero_ps()), waterSpeedMod, speedMod));
+}
+
+static inline __m128 ShipSpeedModPS(const MoveDef& moveDef, __m128 height)
+{
+	return (_mm_andnot_ps(_mm_cmplt_ps(NegatePS(height), _mm_set1_ps(moveDef.depth)), _mm_set1_ps(1.0f)));
+}
+
+
+float CMoveMath::TerrainSpeedMod(const MoveDef& moveDef, float height, float slope, const CMapInfo::TerrainType& tt)
+{
+	switch (moveDef.speedModClass) {
+		case MoveDef::Tank:  { return (GroundSpeedMod(moveDef, height, slope) * tt.tankSpeed ); } break;
+		case MoveDef::KBot:  { return (GroundSpeedMod(moveDef, height, slope) * tt.kbotSpeed ); } break;
+		case MoveDef::Hover: { return ( HoverSpeedMod(moveDef, height, slope) * tt.hoverSpeed); } break;
+		case MoveDef::Ship:  { return (  ShipSpeedMod(moveDef, height, slope) * tt.shipSpeed ); } break;
+		default: {} break;
+	}
+
+	return 0.0f;
+}
+
+void CMoveMath::TerrainSpeedModRow(
+	const MoveDef& moveDef,
+	const float* heights,
+	const float* slopes,
+	const unsigned char* types,
+	const CMapInfo::TerrainType* terrainTypes,
+	unsigned int count,
+	float* speedMods
+) {
+	float CMapInfo::TerrainType::* ttSpeed = nullptr;
+
+	switch (moveDef.speedModClass) {
+		case MoveDef::Tank:  { ttSpeed = &CMapInfo::TerrainType::tankSpeed ; } break;
+		case MoveDef::KBot:  { ttSpeed = &CMapInfo::TerrainType::kbotSpeed ; } break;
+		case MoveDef::Hover: { ttSpeed = &CMapInfo::TerrainType::hoverSpeed; } break;
+		case MoveDef::Ship:  { ttSpeed = &CMapInfo::TerrainType::shipSpeed ; } break;
+		default: {
+			std::fill(speedMods, speedMods + count, 0.0f);
+			return;
+		} break;
+	}
+
+	unsigned int i = 0;
+
+	for (; (i + 4) <= count; i += 4) {
+		const __m128 height = _mm_loadu_ps(heights + i);
+		const __m128 slope = _mm_loadu_ps(slopes + i);
+		const __m128 ttSpeedMod = _mm_setr_ps(
+			terrainTypes[types[i + 0]].*ttSpeed,
+			terrainTypes[types[i + 1]].*ttSpeed,
+			terrainTypes[types[i + 2]].*ttSpeed,
+			terrainTypes[types[i + 3]].*ttSpeed
+		);
+
+		__m128 speedMod;
+
+		switch (moveDef.speedModClass) {
+			case MoveDef::Hover: { speedMod = HoverSpeedModPS(moveDef, height, slope); } break;
+			case MoveDef::Ship:  { speedMod =  ShipSpeedModPS(moveDef, height       ); } break;
+			default:             { speedMod = GroundSpeedModPS(moveDef, height, slope); } break;
+		}
+
+		_mm_storeu_ps(speedMods + i, _mm_mul_ps(speedMod, ttSpeedMod));
+	}
+
+	for (; i < count; i++) {
+		speedMods[i] = TerrainSpeedMod(moveDef, heights[i], slopes[i], terrainTypes[types[i]]);
+	}
+}
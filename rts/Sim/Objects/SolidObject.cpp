@@ -7,7 +7,9 @@
 #include "Map/Ground.h"
 #include "Sim/Misc/CollisionVolume.h"
 #include "Sim/Misc/DamageArray.h"
+#include "Sim/Misc/GlobalSynced.h"
 #include "Sim/Misc/GroundBlockingObjectMap.h"
+#include "Sim/Misc/QuadField.h"
 #include "Sim/MoveTypes/MoveDefHandler.h"
 #include "Game/GameHelper.h"
 #include "System/SpringMath.h"
@@ -196,6 +198,7 @@ void CSolidObject::UnBlock()
 	if (!IsBlocking())
 		return;
 
+	MarkFootPrintActivity();
 	groundBlockingObjectMap.RemoveGroundBlockingObject(this);
 	assert(!IsBlocking());
 }
@@ -217,9 +220,19 @@ void CSolidObject::Block()
 	if (FootPrintOnGround()) {
 		groundBlockingObjectMap.AddGroundBlockingObject(this);
 		assert(IsBlocking());
+		MarkFootPrintActivity();
 	}
 }
 
+void CSolidObject::MarkFootPrintActivity() const
+{
+	// the whole footprint, it can stick out of the radius disc
+	const float3 mins = float3(mapPos.x * SQUARE_SIZE, 0.0f, mapPos.y * SQUARE_SIZE);
+	const float3 maxs = float3((mapPos.x + xsize) * SQUARE_SIZE, 0.0f, (mapPos.y + zsize) * SQUARE_SIZE);
+
+	quadField.MarkActivity(mins, maxs, gs->frameNum);
+}
+
 bool CSolidObject::FootPrintOnGround() const {
 	const float sdist = std::max(radius, CalcFootPrintMinExteriorRadius());
 
@@ -215,6 +215,11 @@ public:
 	 * is currently marked on it, does nothing otherwise.
 	 */
 	void UnBlock();
+	/**
+	 * Stamps the quads under this object's blocking footprint as
+	 * active, waking parked units (see CGroundMoveType::IsParked)
+	 */
+	void MarkFootPrintActivity() const;
 
 	void SetMapPos(const int2 mp) {
 		mapPos = mp;
@@ -50,7 +50,6 @@ void IPathFinder::Init(unsigned int _BLOCK_SIZE)
 		// blockStates.Clear();
 		// done in ResetSearch
 		// openBlocks.Clear();
-		dirtyBlocks.clear();
 	}
 	{
 		pathFinderInstances.push_back(this);
@@ -74,7 +73,7 @@ void IPathFinder::AllocStateBuffer()
 		nodeStateBuffers.emplace_back();
 
 	nodeStateBuffers[instanceIndex].Clear();
-	nodeStateBuffers[instanceIndex].Resize(nbrOfBlocks, int2(mapDims.mapx, mapDims.mapy));
+	nodeStateBuffers[instanceIndex].Resize(nbrOfBlocks, int2(mapDims.mapx, mapDims.mapy), true);
 
 	// steal memory, returned in dtor
 	blockStates = std::move(nodeStateBuffers[instanceIndex]);
@@ -82,13 +81,8 @@ void IPathFinder::AllocStateBuffer()
 
 void IPathFinder::ResetSearch()
 {
-	while (!dirtyBlocks.empty()) {
-		blockStates.ClearSquare(dirtyBlocks.back());
-		dirtyBlocks.pop_back();
-	}
-
-	// reserve a batch of dirty blocks
-	dirtyBlocks.reserve(4096);
+	// lazily invalidates every node state written by the last search
+	blockStates.NewSearch();
 	openBlocks.Clear();
 
 	testedBlocks = 0;
@@ -235,9 +229,9 @@ IPath::SearchResult IPathFinder::InitSearch(const MoveDef& moveDef, const CPathF
 
 	if (BLOCK_SIZE != 1){
 		if (psBlockStates != nullptr)
-			square = (*psBlockStates).peNodeOffsets[moveDef.pathType][mStartBlockIdx];
+			square = (*psBlockStates).GetNodeOffset(moveDef.pathType, mStartBlockIdx);
 		else
-			square = blockStates.peNodeOffsets[moveDef.pathType][mStartBlockIdx];
+			square = blockStates.GetNodeOffset(moveDef.pathType, mStartBlockIdx);
 	}
 
 	const bool isStartGoal = pfDef.IsGoal(square.x, square.y);
@@ -258,16 +252,14 @@ IPath::SearchResult IPathFinder::InitSearch(const MoveDef& moveDef, const CPathF
 	if (isStartGoal && startInGoal)
 		return results[allowRawPath];
 
-	// mark and store the start-block; clear all bits except PATHOPT_OBSOLETE
-	blockStates.nodeMask[mStartBlockIdx] &= PATHOPT_OBSOLETE;
-	blockStates.nodeMask[mStartBlockIdx] |= PATHOPT_OPEN;
-	blockStates.fCost[mStartBlockIdx] = 0.0f;
-	blockStates.gCost[mStartBlockIdx] = 0.0f;
+	// mark and store the start-block
+	PathNodeState& startState = blockStates.GetNodeState(mStartBlockIdx);
+	startState.mask |= PATHOPT_OPEN;
+	startState.fCost = 0.0f;
+	startState.gCost = PathNodeStateBuffer::PackCost(0.0f);
 	blockStates.SetMaxCost(NODE_COST_F, 0.0f);
 	blockStates.SetMaxCost(NODE_COST_G, 0.0f);
 
-	dirtyBlocks.push_back(mStartBlockIdx);
-
 	// start a new search and add the starting block to the open-blocks-queue
 	openBlockBuffer.SetSize(0);
 	PathNode* ob = openBlockBuffer.GetNode(openBlockBuffer.GetSize());
@@ -154,9 +154,6 @@ public:
 	PathNodeStateBuffer blockStates;
 	PathPriorityQueue openBlocks;
 
-	// list of blocks changed in last search
-	std::vector<unsigned int> dirtyBlocks;
-
 	PathNodeStateBuffer* psBlockStates = nullptr;
 };
 
@@ -6,6 +6,8 @@
 #include <queue>
 #include <vector>
 #include <algorithm> // for std::fill
+#include <cassert>
+#include <cstring>
 
 #include "PathConstants.h"
 #include "System/type2.h"
@@ -68,6 +70,21 @@ private:
 };
 
 
+/// per-node search state, packed into 8 bytes so a node visit touches one cache-line
+struct PathNodeState {
+	/// exact; searches compare it against the PathNode::fCost copies in the open queue
+	float fCost;
+	/// upper half of the float (bfloat16), only ever read back for visualisation
+	std::uint16_t gCost;
+	/// bitmask of PATHOPT_{CARDINALS, OPEN, CLOSED, BLOCKED} flags
+	std::uint8_t mask;
+	/// search that last wrote this state; states of earlier searches read as unvisited
+	std::uint8_t searchGen;
+};
+
+static_assert(sizeof(PathNodeState) == 8, "PathNodeState is not packed");
+
+
 struct PathNodeStateBuffer {
 	PathNodeStateBuffer() {
 		#if !defined(_MSC_FULL_VER) || _MSC_FULL_VER > 180040000 // ensure that ::max() is constexpr
@@ -82,8 +99,7 @@ struct PathNodeStateBuffer {
 
 	PathNodeStateBuffer& operator = (const PathNodeStateBuffer& pnsb) = delete;
 	PathNodeStateBuffer& operator = (PathNodeStateBuffer&& pnsb) {
-		fCost = std::move(pnsb.fCost);
-		gCost = std::move(pnsb.gCost);
+		nodeStates = std::move(pnsb.nodeStates);
 
 		nodeMask = std::move(pnsb.nodeMask);
 		nodeLinksObsoleteFlags = std::move(pnsb.nodeLinksObsoleteFlags);
@@ -108,36 +124,40 @@ struct PathNodeStateBuffer {
 
 		er[ true] = pnsb.er[ true];
 		er[false] = pnsb.er[false];
+
+		searchGen = pnsb.searchGen;
 		return *this;
 	}
 
 
-	unsigned int GetSize() const { return fCost.size(); }
+	unsigned int GetSize() const { return (br.x * br.y); }
 
-	void Resize(const int2& bufRes, const int2& mapRes) {
+	/**
+	 * Searches (PF, PE) only need the per-node search state, the PathingState
+	 * which owns the precalculated block data only needs the obsolete-flags;
+	 * neither allocates the other's half.
+	 */
+	void Resize(const int2& bufRes, const int2& mapRes, bool searchState) {
 		ps = mapRes / bufRes;
 		br = bufRes;
 		mr = mapRes;
 
-		fCost.resize(br.x * br.y, PATHCOST_INFINITY);
-		gCost.resize(br.x * br.y, PATHCOST_INFINITY);
-		nodeMask.resize(br.x * br.y, 0);
-		nodeLinksObsoleteFlags.resize(br.x * br.y, 0);
+		if (searchState) {
+			nodeStates.resize(br.x * br.y, UnvisitedNodeState(0));
+		} else {
+			nodeMask.resize(br.x * br.y, 0);
+			nodeLinksObsoleteFlags.resize(br.x * br.y, 0);
+		}
 
 		// created on-demand
 		// extraCosts[ true].resize(br.x * br.y, 0.0f);
 		// extraCosts[false].resize(br.x * br.y, 0.0f);
 
-		#if 0
-		// is done in PathEstimator, PF does not need these
-		if (bufRes != mapRes)
-			peNodeOffsets.resize(numPathTypes);
-		#endif
+		// peNodeOffsets are done in PathingState via AllocNodeOffsets, PF does not need these
 	}
 
 	void Clear() {
-		fCost.clear();
-		gCost.clear();
+		nodeStates.clear();
 
 		nodeMask.clear();
 		nodeLinksObsoleteFlags.clear();
@@ -158,27 +178,92 @@ struct PathNodeStateBuffer {
 		mr        = {0, 0};
 		er[ true] = {1, 1};
 		er[false] = {1, 1};
+
+		searchGen = 0;
+	}
+
+
+	/**
+	 * Invalidates the state of every node touched by the previous search in
+	 * O(1); only when the 8-bit generation counter wraps around do all nodes
+	 * have to be reset explicitly (once every 255 searches).
+	 */
+	void NewSearch() {
+		if ((++searchGen) != 0)
+			return;
+
+		std::fill(nodeStates.begin(), nodeStates.end(), UnvisitedNodeState(0));
+		searchGen = 1;
+	}
+
+	/// state of node <idx> in the current search; reset first if it was last written by an earlier one
+	PathNodeState& GetNodeState(unsigned int idx) {
+		PathNodeState& state = nodeStates[idx];
+
+		if (state.searchGen != searchGen)
+			state = UnvisitedNodeState(searchGen);
+
+		return state;
+	}
+
+	// read-only accessors for the results of the last search; do not reset stale states
+	std::uint8_t GetNodeMask(unsigned int idx) const {
+		const PathNodeState& state = nodeStates[idx];
+		return ((state.searchGen == searchGen)? state.mask: 0);
+	}
+	float GetNodeFCost(unsigned int idx) const {
+		const PathNodeState& state = nodeStates[idx];
+		return ((state.searchGen == searchGen)? state.fCost: PATHCOST_INFINITY);
 	}
+	float GetNodeGCost(unsigned int idx) const {
+		const PathNodeState& state = nodeStates[idx];
+		return ((state.searchGen == searchGen)? UnpackCost(state.gCost): PATHCOST_INFINITY);
+	}
+
+	static std::uint16_t PackCost(float cost) {
+		std::uint32_t bits;
+		std::memcpy(&bits, &cost, sizeof(bits));
+		// round to nearest-even, +inf stays +inf
+		return ((bits + 0x7FFF + ((bits >> 16) & 1)) >> 16);
+	}
+	static float UnpackCost(std::uint16_t packed) {
+		const std::uint32_t bits = std::uint32_t(packed) << 16;
+		float cost;
+		std::memcpy(&cost, &bits, sizeof(cost));
+		return cost;
+	}
+
 
-	void ClearSquare(int idx) {
-		// assert(idx >= 0 && idx < fCost.size());
-		fCost[idx] = PATHCOST_INFINITY;
-		gCost[idx] = PATHCOST_INFINITY;
-		// clear all bits except PATHOPT_OBSOLETE
-		nodeMask[idx] &= PATHOPT_OBSOLETE;
+	/// offsets are stored flat as [pathType][blockIdx], the layout of the PE cache-file
+	void AllocNodeOffsets(unsigned int numPathTypes) {
+		peNodeOffsets.clear();
+		peNodeOffsets.resize(numPathTypes * GetSize());
+	}
+
+	const short2& GetNodeOffset(unsigned int pathType, unsigned int blockIdx) const {
+		assert(blockIdx < GetSize());
+		return peNodeOffsets[pathType * GetSize() + blockIdx];
 	}
+	void SetNodeOffset(unsigned int pathType, unsigned int blockIdx, short2 offset) {
+		assert(blockIdx < GetSize());
+		peNodeOffsets[pathType * GetSize() + blockIdx] = offset;
+	}
+
+	const short2* GetNodeOffsets(unsigned int pathType) const { return &peNodeOffsets[pathType * GetSize()]; }
+	      short2* GetNodeOffsets(unsigned int pathType)       { return &peNodeOffsets[pathType * GetSize()]; }
+
+	const std::vector<short2>& GetAllNodeOffsets() const { return peNodeOffsets; }
+	      std::vector<short2>& GetAllNodeOffsets()       { return peNodeOffsets; }
 
 
 	/// size of the memory-region we hold allocated (excluding sizeof(*this))
 	unsigned int GetMemFootPrint() const {
 		unsigned int memFootPrint = 0;
 
-		if (!peNodeOffsets.empty())
-			memFootPrint += (peNodeOffsets.size() * (sizeof(std::vector<short2>) + peNodeOffsets[0].size() * sizeof(short2)));
-
+		memFootPrint += (nodeStates.size() * sizeof(decltype(nodeStates)::value_type));
+		memFootPrint += (peNodeOffsets.size() * sizeof(decltype(peNodeOffsets)::value_type));
 		memFootPrint += (nodeMask.size() * sizeof(decltype(nodeMask)::value_type));
 		memFootPrint += (nodeLinksObsoleteFlags.size() * sizeof(decltype(nodeLinksObsoleteFlags)::value_type));
-		memFootPrint += ((fCost.size() + gCost.size()) * sizeof(decltype(fCost)::value_type));
 		memFootPrint += ((extraCosts[true].size() + extraCosts[false].size()) * sizeof(float));
 		return memFootPrint;
 	}
@@ -224,22 +309,27 @@ struct PathNodeStateBuffer {
 		er[synced].y = sz;
 	}
 
-public:
-	std::vector<float> fCost;
-	std::vector<float> gCost;
+private:
+	static PathNodeState UnvisitedNodeState(std::uint8_t gen) {
+		return {PATHCOST_INFINITY, PackCost(PATHCOST_INFINITY), 0, gen};
+	}
 
-	/// bitmask of PATHOPT_{OPEN, ..., OBSOLETE} flags
+public:
+	/// PathingState only; bitmask of PATHOPT_OBSOLETE flags (searches keep theirs in nodeStates)
 	std::vector<std::uint8_t> nodeMask;
 
-	/// Flag certain node directions as obsolete
+	/// PathingState only; flags certain node directions as obsolete
 	std::vector<std::uint8_t> nodeLinksObsoleteFlags;
 
-	/// for the PE, maintains an array of the best accessible
+private:
+	/// PF and PE only; indexed by node, see GetNodeState
+	std::vector<PathNodeState> nodeStates;
+
+	/// for the PE, maintains a flat array of the best accessible
 	/// offset (from a block's center position) per path-type
-	/// peNodeOffsets[pathType][blockIdx]
-	std::vector< std::vector<short2> > peNodeOffsets;
+	/// peNodeOffsets[pathType * GetSize() + blockIdx]
+	std::vector<short2> peNodeOffsets;
 
-private:
 	// overlay-cost modifiers for nodes (when non-zero, these
 	// modify the behavior of GetPath() and GetNextWaypoint())
 	//
@@ -266,6 +356,8 @@ private:
 	int2 br;    ///< buffer resolution (equal to mr / ps); ignored when extraCosts != NULL
 	int2 mr;    ///< heightmap resolution (equal to mapDims.map{x,y})
 	int2 er[2]; ///< extraCosts resolution
+
+	std::uint8_t searchGen = 0;
 };
 
 
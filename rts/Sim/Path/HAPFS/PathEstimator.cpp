@@ -253,7 +253,7 @@ IPath::SearchResult CPathEstimator::DoSearch(const MoveDef& moveDef, const CPath
 
 	// 	for (; x<limitX; ++x) {
 	// 		for (;y<limitY; ++y){
-	// 			const unsigned int pathOpt = blockStates.nodeMask[blockIdx] & PATHOPT_CARDINALS;
+	// 			const unsigned int pathOpt = blockStates.GetNodeMask(blockIdx) & PATHOPT_CARDINALS;
 	// 			const unsigned int pathDir = PathOpt2PathDir(pathOpt);
 
 	// 	// 		blockIdx  = BlockPosToIdx(BlockIdxToPos(blockIdx) - PE_DIRECTION_VECTORS[pathDir]);
@@ -268,11 +268,11 @@ IPath::SearchResult CPathEstimator::DoSearch(const MoveDef& moveDef, const CPath
 		openBlocks.pop();
 
 		// check if the block has been marked as unaccessible during its time in the queue
-		if (blockStates.nodeMask[ob->nodeNum] & (PATHOPT_BLOCKED | PATHOPT_CLOSED))
+		if (blockStates.GetNodeState(ob->nodeNum).mask & (PATHOPT_BLOCKED | PATHOPT_CLOSED))
 			continue;
 
 		// no, check if the goal is already reached
-		const int2 bSquare = (*psBlockStates).peNodeOffsets[moveDef.pathType][ob->nodeNum];
+		const int2 bSquare = (*psBlockStates).GetNodeOffset(moveDef.pathType, ob->nodeNum);
 		const int2 gSquare = ob->nodePos * BLOCK_SIZE + goalSqrOffset;
 
 		bool runBlkSearch = false;
@@ -309,7 +309,7 @@ IPath::SearchResult CPathEstimator::DoSearch(const MoveDef& moveDef, const CPath
 		TestBlock(moveDef, peDef, ob, owner, PATHDIR_LEFT_DOWN,  PATHOPT_OPEN, maxSpeedMod);
 
 		// mark this block as closed
-		blockStates.nodeMask[ob->nodeNum] |= PATHOPT_CLOSED;
+		blockStates.GetNodeState(ob->nodeNum).mask |= PATHOPT_CLOSED;
 	}
 
 	// {bool printMoveInfo = (owner != nullptr) && (selectedUnitsHandler.selectedUnits.size() == 1)
@@ -366,8 +366,10 @@ bool CPathEstimator::TestBlock(
 	const unsigned int openBlockIdx = BlockPosToIdx(openBlockPos);
 	const unsigned int testBlockIdx = BlockPosToIdx(testBlockPos);
 
+	PathNodeState& testNodeState = blockStates.GetNodeState(testBlockIdx);
+
 	// check if the block is unavailable
-	if (blockStates.nodeMask[testBlockIdx] & (PATHOPT_BLOCKED | PATHOPT_CLOSED))
+	if (testNodeState.mask & (PATHOPT_BLOCKED | PATHOPT_CLOSED))
 		return false;
 
 	const unsigned int vertexBaseIdx = moveDef.pathType * nbrOfBlocks.x * nbrOfBlocks.y * PATH_DIRECTION_VERTICES;
@@ -376,12 +378,11 @@ bool CPathEstimator::TestBlock(
 		openBlockIdx * PATH_DIRECTION_VERTICES +
 		GetBlockVertexOffset(pathDir, nbrOfBlocks.x);
 
-	assert(testBlockIdx < (*psBlockStates).peNodeOffsets[moveDef.pathType].size());
 	//assert(vertexCostIdx < vertexCosts.size());
 
 	// best accessible heightmap-coordinate within tested block
-	// [DBG] const int2 openBlockSquare = blockStates.peNodeOffsets[moveDef.pathType][openBlockIdx];
-	const int2 testBlockSquare = (*psBlockStates).peNodeOffsets[moveDef.pathType][testBlockIdx];
+	// [DBG] const int2 openBlockSquare = blockStates.GetNodeOffset(moveDef.pathType, openBlockIdx);
+	const int2 testBlockSquare = (*psBlockStates).GetNodeOffset(moveDef.pathType, testBlockIdx);
 
 	// transition-cost from parent to tested child
 	float testVertexCost = pathingState->GetVertexCost(vertexCostIdx);
@@ -413,8 +414,7 @@ bool CPathEstimator::TestBlock(
 		// etc. in the nodeMask but that is complicated and not
 		// worth it: would just save the vertexCosts[] lookup
 		//
-		// blockStates.nodeMask[testBlockIdx] |= (PathDir2PathOpt(pathDir) | PATHOPT_BLOCKED);
-		// dirtyBlocks.push_back(testBlockIdx);
+		// testNodeState.mask |= (PathDir2PathOpt(pathDir) | PATHOPT_BLOCKED);
 		if (blockedSearch || DoBlockSearch(owner, moveDef, peDef.wsStartPos, SquareToFloat3(testBlockSquare)) != IPath::Ok)
 			return false;
 
@@ -426,8 +426,7 @@ bool CPathEstimator::TestBlock(
 
 	// check if the block is outside constraints
 	if (!peDef.WithinConstraints(testBlockSquare)) {
-		blockStates.nodeMask[testBlockIdx] |= PATHOPT_BLOCKED;
-		dirtyBlocks.push_back(testBlockIdx);
+		testNodeState.mask |= PATHOPT_BLOCKED;
 		return false;
 	}
 
@@ -463,8 +462,7 @@ bool CPathEstimator::TestBlock(
 					// we cannot set PATHOPT_BLOCKED here either, result
 					// depends on direction of entry from the parent node
 					//
-					// blockStates.nodeMask[testBlockIdx] |= PATHOPT_BLOCKED;
-					// dirtyBlocks.push_back(testBlockIdx);
+					// testNodeState.mask |= PATHOPT_BLOCKED;
 					return false;
 				}
 			}
@@ -491,13 +489,13 @@ bool CPathEstimator::TestBlock(
 	const float fCost = gCost + hCost;
 
 	// already in the open set?
-	if (blockStates.nodeMask[testBlockIdx] & PATHOPT_OPEN) {
+	if (testNodeState.mask & PATHOPT_OPEN) {
 		// check if new found path is better or worse than the old one
-		if (blockStates.fCost[testBlockIdx] <= fCost)
+		if (testNodeState.fCost <= fCost)
 			return true;
 
 		// no, clear old path data
-		blockStates.nodeMask[testBlockIdx] &= ~PATHOPT_CARDINALS;
+		testNodeState.mask &= ~PATHOPT_CARDINALS;
 	}
 
 	// look for improvements
@@ -521,11 +519,9 @@ bool CPathEstimator::TestBlock(
 	blockStates.SetMaxCost(NODE_COST_G, std::max(blockStates.GetMaxCost(NODE_COST_G), gCost));
 
 	// mark this block as open
-	blockStates.fCost[testBlockIdx] = fCost;
-	blockStates.gCost[testBlockIdx] = gCost;
-	blockStates.nodeMask[testBlockIdx] |= (PathDir2PathOpt(pathDir) | PATHOPT_OPEN);
-
-	dirtyBlocks.push_back(testBlockIdx);
+	testNodeState.fCost = fCost;
+	testNodeState.gCost = PathNodeStateBuffer::PackCost(gCost);
+	testNodeState.mask |= (PathDir2PathOpt(pathDir) | PATHOPT_OPEN);
 	return true;
 }
 
@@ -541,8 +537,7 @@ bool CPathEstimator::TestBlockReachability(
 	const CSolidObject* owner,
 	const unsigned int testBlockIdx
 ) {
-	assert(testBlockIdx < (*psBlockStates).peNodeOffsets[moveDef.pathType].size());
-	const int2 testBlockSquare = (*psBlockStates).peNodeOffsets[moveDef.pathType][testBlockIdx];
+	const int2 testBlockSquare = (*psBlockStates).GetNodeOffset(moveDef.pathType, testBlockIdx);
 
 	if (!peDef.WithinConstraints(testBlockSquare))
 		return false;
@@ -564,7 +559,7 @@ void CPathEstimator::FinishSearch(const MoveDef& moveDef, const CPathFinderDef&
 		{
 			#if 1
 			while (blockIdx != mStartBlockIdx) {
-				const unsigned int pathOpt = blockStates.nodeMask[blockIdx] & PATHOPT_CARDINALS;
+				const unsigned int pathOpt = blockStates.GetNodeMask(blockIdx) & PATHOPT_CARDINALS;
 				const unsigned int pathDir = PathOpt2PathDir(pathOpt);
 
 				blockIdx  = BlockPosToIdx(BlockIdxToPos(blockIdx) - PE_DIRECTION_VECTORS[pathDir]);
@@ -588,7 +583,7 @@ void CPathEstimator::FinishSearch(const MoveDef& moveDef, const CPathFinderDef&
 
 		while (true) {
 			// use offset defined by the block
-			const int2 square = (*psBlockStates).peNodeOffsets[moveDef.pathType][blockIdx];
+			const int2 square = (*psBlockStates).GetNodeOffset(moveDef.pathType, blockIdx);
 
 			// foundPath.squares.push_back(square);
 			foundPath.path.emplace_back(square.x * SQUARE_SIZE, CMoveMath::yLevel(moveDef, square.x, square.y), square.y * SQUARE_SIZE);
@@ -597,7 +592,7 @@ void CPathEstimator::FinishSearch(const MoveDef& moveDef, const CPathFinderDef&
 				break;
 
 			// next step backwards
-			const unsigned int pathOpt = blockStates.nodeMask[blockIdx] & PATHOPT_CARDINALS;
+			const unsigned int pathOpt = blockStates.GetNodeMask(blockIdx) & PATHOPT_CARDINALS;
 			const unsigned int pathDir = PathOpt2PathDir(pathOpt);
 
 			blockIdx = BlockPosToIdx(BlockIdxToPos(blockIdx) - PE_DIRECTION_VECTORS[pathDir]);
@@ -607,7 +602,7 @@ void CPathEstimator::FinishSearch(const MoveDef& moveDef, const CPathFinderDef&
 			foundPath.pathGoal = foundPath.path[0];
 	}
 
-	foundPath.pathCost = blockStates.fCost[mGoalBlockIdx] - mGoalHeuristic;
+	foundPath.pathCost = blockStates.GetNodeFCost(mGoalBlockIdx) - mGoalHeuristic;
 }
 
 
@@ -243,7 +243,7 @@ IPath::SearchResult CPathFinder::DoSearch(
 		// }
 
 		// check if this PathNode has become obsolete
-		if (blockStates.fCost[openSquare->nodeNum] != openSquare->fCost)
+		if (blockStates.GetNodeState(openSquare->nodeNum).fCost != openSquare->fCost)
 			continue;
 
 		// check if the goal has been reached
@@ -255,8 +255,7 @@ IPath::SearchResult CPathFinder::DoSearch(
 		}
 
 		if (!pfDef.WithinConstraints(openSquare->nodePos.x, openSquare->nodePos.y)) {
-			blockStates.nodeMask[openSquare->nodeNum] |= PATHOPT_CLOSED;
-			dirtyBlocks.push_back(openSquare->nodeNum);
+			blockStates.GetNodeState(openSquare->nodeNum).mask |= PATHOPT_CLOSED;
 			continue;
 		}
 
@@ -312,14 +311,15 @@ void CPathFinder::TestNeighborSquares(
 		if (!sqState.insideMap)
 			continue;
 
-		if (blockStates.nodeMask[ngbSquareIdx] & (PATHOPT_CLOSED | PATHOPT_BLOCKED)) //FIXME
+		PathNodeState& ngbNodeState = blockStates.GetNodeState(ngbSquareIdx);
+
+		if (ngbNodeState.mask & (PATHOPT_CLOSED | PATHOPT_BLOCKED)) //FIXME
 			continue;
 
 		// IsBlockedNoSpeedModCheck; very expensive call but with a ~20% (?) chance of early-out
 		sqState.blockMask = CMoveMath::IsBlockedNoSpeedModCheckDiff(moveDef, squarePos, ngbSquareCoors, owner, thread);
 		if (sqState.blockMask & MMBT::BLOCK_STRUCTURE) {
-			blockStates.nodeMask[ngbSquareIdx] |= PATHOPT_CLOSED;
-			dirtyBlocks.push_back(ngbSquareIdx);
+			ngbNodeState.mask |= PATHOPT_CLOSED;
 			continue;
 		}
 
@@ -335,8 +335,7 @@ void CPathFinder::TestNeighborSquares(
 			// only close node if search is directionally independent, since it
 			// might still be entered from another (better) direction otherwise
 			if ((sqState.speedMod = CMoveMath::GetPosSpeedMod(moveDef, ngbSquareCoors.x, ngbSquareCoors.y)) == 0.0f) {
-				blockStates.nodeMask[ngbSquareIdx] |= PATHOPT_CLOSED;
-				dirtyBlocks.push_back(ngbSquareIdx);
+				ngbNodeState.mask |= PATHOPT_CLOSED;
 			}
 		}
 
@@ -408,8 +407,7 @@ void CPathFinder::TestNeighborSquares(
 	#endif
 
 	// mark this square as closed
-	blockStates.nodeMask[square->nodeNum] |= PATHOPT_CLOSED;
-	dirtyBlocks.push_back(square->nodeNum);
+	blockStates.GetNodeState(square->nodeNum).mask |= PATHOPT_CLOSED;
 }
 
 bool CPathFinder::TestBlock(
@@ -430,7 +428,9 @@ bool CPathFinder::TestBlock(
 	// bounds-check
 	assert(static_cast<unsigned>(square.x) < nbrOfBlocks.x);
 	assert(static_cast<unsigned>(square.y) < nbrOfBlocks.y);
-	assert((blockStates.nodeMask[sqrIdx] & (PATHOPT_CLOSED | PATHOPT_BLOCKED)) == 0);
+	PathNodeState& nodeState = blockStates.GetNodeState(sqrIdx);
+
+	assert((nodeState.mask & (PATHOPT_CLOSED | PATHOPT_BLOCKED)) == 0);
 	assert((blockStatus & MMBT::BLOCK_STRUCTURE) == 0);
 	assert(speedMod != 0.0f);
 
@@ -468,12 +468,12 @@ bool CPathFinder::TestBlock(
 	const float hCost = pfDef.Heuristic(square.x, square.y, BLOCK_SIZE); // h
 	const float fCost = gCost + hCost;                                   // f
 
-	if (blockStates.nodeMask[sqrIdx] & PATHOPT_OPEN) {
+	if (nodeState.mask & PATHOPT_OPEN) {
 		// already in the open set, look for a cost-improvement
-		if (blockStates.fCost[sqrIdx] <= fCost)
+		if (nodeState.fCost <= fCost)
 			return true;
 
-		blockStates.nodeMask[sqrIdx] &= ~PATHOPT_CARDINALS;
+		nodeState.mask &= ~PATHOPT_CARDINALS;
 	}
 
 	// if heuristic says this node is closer to goal than previous h-estimate, keep it
@@ -496,11 +496,9 @@ bool CPathFinder::TestBlock(
 	blockStates.SetMaxCost(NODE_COST_F, std::max(blockStates.GetMaxCost(NODE_COST_F), fCost));
 	blockStates.SetMaxCost(NODE_COST_G, std::max(blockStates.GetMaxCost(NODE_COST_G), gCost));
 
-	blockStates.fCost[sqrIdx] = os->fCost;
-	blockStates.gCost[sqrIdx] = os->gCost;
-	blockStates.nodeMask[sqrIdx] |= (PATHOPT_OPEN | pathOptDir);
-
-	dirtyBlocks.push_back(sqrIdx);
+	nodeState.fCost = os->fCost;
+	nodeState.gCost = PathNodeStateBuffer::PackCost(os->gCost);
+	nodeState.mask |= (PATHOPT_OPEN | pathOptDir);
 	return true;
 }
 
@@ -516,9 +514,9 @@ void CPathFinder::FinishSearch(const MoveDef& moveDef, const CPathFinderDef& pfD
 
 		{
 			while (blockIdx != mStartBlockIdx) {
-				assert(PF_DIRECTION_VECTORS_2D[blockStates.nodeMask[blockIdx] & PATHOPT_CARDINALS] != int2(0, 0));
+				assert(PF_DIRECTION_VECTORS_2D[blockStates.GetNodeMask(blockIdx) & PATHOPT_CARDINALS] != int2(0, 0));
 
-				square   -= PF_DIRECTION_VECTORS_2D[blockStates.nodeMask[blockIdx] & PATHOPT_CARDINALS];
+				square   -= PF_DIRECTION_VECTORS_2D[blockStates.GetNodeMask(blockIdx) & PATHOPT_CARDINALS];
 				blockIdx  = BlockPosToIdx(square);
 				numNodes += 1;
 			}
@@ -548,7 +546,7 @@ void CPathFinder::FinishSearch(const MoveDef& moveDef, const CPathFinderDef& pfD
 			if (blockIdx == mStartBlockIdx)
 				break;
 
-			square -= PF_DIRECTION_VECTORS_2D[blockStates.nodeMask[blockIdx] & PATHOPT_CARDINALS];
+			square -= PF_DIRECTION_VECTORS_2D[blockStates.GetNodeMask(blockIdx) & PATHOPT_CARDINALS];
 			blockIdx = BlockPosToIdx(square);
 		}
 
@@ -556,7 +554,7 @@ void CPathFinder::FinishSearch(const MoveDef& moveDef, const CPathFinderDef& pfD
 			foundPath.pathGoal = foundPath.path[0];
 	}
 
-	foundPath.pathCost = blockStates.fCost[mGoalBlockIdx];
+	foundPath.pathCost = blockStates.GetNodeFCost(mGoalBlockIdx);
 }
 
 
@@ -589,9 +587,9 @@ void CPathFinder::SmoothMidWaypoint(
 	const int tstSqrIdx = BlockPosToIdx(testSqr);
 	const int prvSqrIdx = BlockPosToIdx(prevSqr);
 
-	if ((blockStates.nodeMask[tstSqrIdx] & PATHOPT_BLOCKED) != 0)
+	if ((blockStates.GetNodeMask(tstSqrIdx) & PATHOPT_BLOCKED) != 0)
 		return;
-	if (blockStates.fCost[tstSqrIdx] > (COSTMOD * blockStates.fCost[prvSqrIdx]))
+	if (blockStates.GetNodeFCost(tstSqrIdx) > (COSTMOD * blockStates.GetNodeFCost(prvSqrIdx)))
 		return;
 
 	const float3& p2 = foundPath.path[foundPath.path.size() - 3];
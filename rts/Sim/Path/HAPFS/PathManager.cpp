@@ -813,6 +813,8 @@ void CPathManager::Update()
 		// 		, medResUpdatesCount, lowResUpdatesCount, ratio, pathStateWorkloadRatio);
 
 		frameNumToRefreshPathStateWorkloadRatio = gs->frameNum + GAME_SPEED;
+
+		RefreshBlockPathUsage();
 	}
 
 	if (gs->frameNum % pathStateWorkloadRatio)
@@ -821,6 +823,36 @@ void CPathManager::Update()
 		lowPriorityResPS->Update();
 }
 
+// recounts the live paths crossing each block, which PathingState::Update uses
+// to decide which queued blocks get their vertex-costs re-estimated first
+void CPathManager::RefreshBlockPathUsage()
+{
+	auto medResPS = &pathingStates[PATH_MED_RES];
+	auto lowResPS = &pathingStates[PATH_LOW_RES];
+
+	if (medResPS->updatedBlocks.empty() && lowResPS->updatedBlocks.empty())
+		return;
+
+	medResPS->ClearBlockPathUsage();
+	lowResPS->ClearBlockPathUsage();
+
+	const std::lock_guard<std::mutex> lock(pathMapUpdate);
+
+	// per-block sums do not depend on the iteration order; unsynced requests
+	// (from AI's or unsynced Lua) do not exist on every client and must not count
+	for (const auto& p: pathMap) {
+		const MultiPath& mp = p.second;
+
+		if (!mp.peDef.synced)
+			continue;
+
+		for (const IPath::Path* path: {&mp.lowResPath, &mp.medResPath}) {
+			medResPS->AddBlockPathUsage(*path);
+			lowResPS->AddBlockPathUsage(*path);
+		}
+	}
+}
+
 // used to deposit heat on the heat-map as a unit moves along its path
 void CPathManager::UpdatePath(const CSolidObject* owner, unsigned int pathID)
 {
@@ -1034,6 +1066,17 @@ int2 CPathManager::GetNumQueuedUpdates() const {
 	return data;
 }
 
+int2 CPathManager::GetMaxQueuedUpdateAge() const {
+	int2 data;
+
+	if (IsFinalized()) {
+		data.x = pathingStates[PATH_MED_RES].GetMaxUpdateAge();
+		data.y = pathingStates[PATH_LOW_RES].GetMaxUpdateAge();
+	}
+
+	return data;
+}
+
 bool CPathManager::SupportsMultiThreadedRequests() const {
 	return !modInfo.pfForceSingleThreaded;
 }
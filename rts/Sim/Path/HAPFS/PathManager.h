@@ -174,6 +174,7 @@ public:
 	const float* GetNodeExtraCosts(bool) const override;
 
 	int2 GetNumQueuedUpdates() const override;
+	int2 GetMaxQueuedUpdateAge() const override;
 
 	const CPathFinder* GetMaxResPF() const;
 	const CPathEstimator* GetMedResPE() const;
@@ -248,6 +249,8 @@ private:
 	bool SupportsMultiThreadedRequests() const; //{ return true; }
 	void SavePathCacheForPathId(int pathIdToSave) override;
 
+	void RefreshBlockPathUsage();
+
 private:
 	mutable std::mutex pathMapUpdate;
 
@@ -2,13 +2,15 @@
 
 #include "PathingState.h"
 
-#include "zlib.h"
-#include "minizip/zip.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
 
 #include "Game/GlobalUnsynced.h"
 #include "Game/LoadScreen.h"
 #include "Net/Protocol/NetProtocol.h"
 
+#include "Sim/Misc/GlobalSynced.h"
 #include "Sim/Misc/ModInfo.h"
 #include "Sim/MoveTypes/MoveDefHandler.h"
 #include "Sim/MoveTypes/MoveMath/MoveMath.h"
@@ -21,18 +23,21 @@
 #include "PathMemPool.h"
 
 #include "System/Config/ConfigHandler.h"
-#include "System/FileSystem/Archives/IArchive.h"
-#include "System/FileSystem/ArchiveLoader.h"
+#include "System/CRC.h"
 #include "System/FileSystem/DataDirsAccess.h"
 #include "System/FileSystem/FileSystem.h"
 #include "System/FileSystem/FileQueryFlags.h"
+#include "System/Platform/MappedFile.h"
 #include "System/Platform/Threading.h"
 #include "System/StringUtil.h"
+#include "System/Sync/SHA512.hpp"
 #include "System/Threading/ThreadPool.h" // for_mt
 
 #define ENABLE_NETLOG_CHECKSUM 1
 
 static constexpr int BLOCK_UPDATE_DELAY_FRAMES = GAME_SPEED / 2;
+// a queued block gains one priority point (i.e. one path waypoint) per this many frames of waiting
+static constexpr int BLOCK_UPDATE_AGING_FRAMES = GAME_SPEED;
 
 namespace HAPFS {
 
@@ -44,12 +49,33 @@ static size_t pathingStates = 0;
 PCMemPool pcMemPool;
 // PEMemPool peMemPool;
 
+/**
+ * Cache-file layout: [CacheFileHeader] [block offsets, all path types] [vertex costs]
+ * Stored uncompressed in native byte order so it can be mapped and copied
+ * straight into the estimator arrays; short2 offsets keep the costs 4-aligned.
+ */
+static constexpr char CACHE_FILE_MAGIC[4] = {'S', 'P', 'E', 'C'};
+static constexpr std::uint32_t CACHE_FILE_VERSION = 1;
+
+struct CacheFileHeader {
+	char magic[4];
+	std::uint32_t version;
+	std::uint32_t hashCode;
+	std::uint32_t blockSize;
+	std::uint32_t numPathTypes;
+	std::uint32_t numBlocks;
+	std::uint32_t numVertexCosts;
+	std::uint32_t payloadCRC;
+};
+
+static_assert(sizeof(CacheFileHeader) == 32, "");
+
 static const std::string GetPathCacheDir() {
 	return (FileSystem::GetCacheDir() + "/paths/");
 }
 
 static const std::string GetCacheFileName(const std::string& fileHashCode, const std::string& peFileName, const std::string& mapFileName) {
-	return (GetPathCacheDir() + mapFileName + "." + peFileName + "-" + fileHashCode + ".zip");
+	return (GetPathCacheDir() + mapFileName + "." + peFileName + "-" + fileHashCode + ".pec");
 }
 
 void PathingState::KillStatic() { pathingStates = 0; }
@@ -110,6 +136,14 @@ void PathingState::Init(std::vector<IPathFinder*> pathFinderlist, PathingState*
 		updatedBlocks.clear();
 		consumedBlocks.clear();
 		offsetBlocksSortedByCost.clear();
+
+		blockPathUsage.clear();
+		blockPathUsage.resize(mapBlockCount, 0);
+		blockQueueFrames.clear();
+		blockQueueFrames.resize(mapBlockCount, 0);
+
+		maxUpdateAge = 0;
+		sortUpdatedBlocks = false;
 	}
 
 	PathingState*  childPE = this;
@@ -142,9 +176,13 @@ void PathingState::Init(std::vector<IPathFinder*> pathFinderlist, PathingState*
 		for_mt(0, moveDefHandler.GetNumMoveDefs(), [&](unsigned int i) {
 			const MoveDef* md = moveDefHandler.GetMoveDefByPathType(i);
 
+			std::vector<float> rowSpeedMods(mapDims.mapx);
+
 			for (int y = 0; y < mapDims.mapy; y++) {
-				for (int x = 0; x < mapDims.mapx; x++) {
-					childPE->maxSpeedMods[i] = std::max(childPE->maxSpeedMods[i], CMoveMath::GetPosSpeedMod(*md, x, y));
+				CMoveMath::GetPosSpeedModRow(*md, 0, mapDims.mapx, y, rowSpeedMods.data());
+
+				for (const float speedMod: rowSpeedMods) {
+					childPE->maxSpeedMods[i] = std::max(childPE->maxSpeedMods[i], speedMod);
 				}
 			}
 		});
@@ -190,7 +228,7 @@ void PathingState::AllocStateBuffer()
 		nodeStateBuffers.emplace_back();
 
 	nodeStateBuffers[instanceIndex].Clear();
-	nodeStateBuffers[instanceIndex].Resize(nbrOfBlocks, int2(mapDims.mapx, mapDims.mapy));
+	nodeStateBuffers[instanceIndex].Resize(nbrOfBlocks, int2(mapDims.mapx, mapDims.mapy), false);
 
 	// steal memory, returned in dtor
 	blockStates = std::move(nodeStateBuffers[instanceIndex]);
@@ -256,11 +294,7 @@ void PathingState::InitEstimator(const std::string& peFileName, const std::strin
 void PathingState::InitBlocks()
 {
 	// TK NOTE: moveDefHandler.GetNumMoveDefs() == 47
-	blockStates.peNodeOffsets.resize(moveDefHandler.GetNumMoveDefs());
-	for (unsigned int idx = 0; idx < moveDefHandler.GetNumMoveDefs(); idx++) {
-		blockStates.peNodeOffsets[idx].resize(mapDimensionsInBlocks.x * mapDimensionsInBlocks.y);
-		//LOG("TK PathingState::InitBlocks: blockStates.peNodeOffsets %d now %d", idx, blockStates.peNodeOffsets[idx].size());
-	}
+	blockStates.AllocNodeOffsets(moveDefHandler.GetNumMoveDefs());
 }
 
 
@@ -298,11 +332,10 @@ void PathingState::CalculateBlockOffsets(unsigned int blockIdx, unsigned int thr
 	for (unsigned int i = 0; i < moveDefHandler.GetNumMoveDefs(); i++) {
 		const MoveDef* md = moveDefHandler.GetMoveDefByPathType(i);
 
-		//LOG("TK PathingState::InitBlocks: blockStates.peNodeOffsets %d now %d looking up %d", i, blockStates.peNodeOffsets[md->pathType].size(), blockIdx);
-		blockStates.peNodeOffsets[md->pathType][blockIdx] = FindBlockPosOffset(*md, blockPos.x, blockPos.y);
-		// LOG("UPDATED blockStates.peNodeOffsets[%d][%d] = (%d, %d) : (%d, %d)"
+		blockStates.SetNodeOffset(md->pathType, blockIdx, FindBlockPosOffset(*md, blockPos.x, blockPos.y));
+		// LOG("UPDATED blockStates.GetNodeOffset(%d, %d) = (%d, %d) : (%d, %d)"
 		// 		, md->pathType, blockIdx
-		// 		, blockStates.peNodeOffsets[md->pathType][blockIdx].x, blockStates.peNodeOffsets[md->pathType][blockIdx].y
+		// 		, blockStates.GetNodeOffset(md->pathType, blockIdx).x, blockStates.GetNodeOffset(md->pathType, blockIdx).y
 		// 		, blockPos.x, blockPos.y);
 	}
 }
@@ -444,8 +477,8 @@ void PathingState::CalcVertexPathCost(
 
 
 	// start position within parent block, goal position within child block
-	const int2 parentSquare = blockStates.peNodeOffsets[moveDef.pathType][parentBlockIdx];
-	const int2  childSquare = blockStates.peNodeOffsets[moveDef.pathType][ childBlockIdx];
+	const int2 parentSquare = blockStates.GetNodeOffset(moveDef.pathType, parentBlockIdx);
+	const int2  childSquare = blockStates.GetNodeOffset(moveDef.pathType,  childBlockIdx);
 
 	const float3 startPos = SquareToFloat3(parentSquare.x, parentSquare.y);
 	const float3  goalPos = SquareToFloat3( childSquare.x,  childSquare.y);
@@ -523,58 +556,47 @@ bool PathingState::ReadFile(const std::string& peFileName, const std::string& ma
 	if (!FileSystem::FileExists(cacheFileName))
 		return false;
 
-	std::unique_ptr<IArchive> upfile(archiveLoader.OpenArchive(dataDirsAccess.LocateFile(cacheFileName), "sdz"));
-
-	if (upfile == nullptr || !upfile->IsOpen()) {
-		FileSystem::Remove(cacheFileName);
-		return false;
-	}
-
 	char calcMsg[512];
 	sprintf(calcMsg, "Reading Estimate PathCosts [%d]", BLOCK_SIZE);
 	loadscreen->SetLoadMessage(calcMsg);
 
-	const unsigned fid = upfile->FindFile("pathinfo");
-	if (fid >= upfile->NumFiles()) {
-		FileSystem::Remove(cacheFileName);
-		return false;
-	}
-
-	std::vector<std::uint8_t> buffer;
-
-	if (!upfile->GetFile(fid, buffer) || buffer.size() < 4) {
-		FileSystem::Remove(cacheFileName);
-		return false;
-	}
-
-	const unsigned int filehash = *(reinterpret_cast<unsigned int*>(&buffer[0]));
-	const unsigned int blockSize = blockStates.GetSize() * sizeof(short2);
-	unsigned int pos = sizeof(unsigned);
-
-	if (filehash != fileHashCode) {
-		FileSystem::Remove(cacheFileName);
-		return false;
-	}
+	auto& nodeOffsets = blockStates.GetAllNodeOffsets();
 
-	if (buffer.size() < (pos + blockSize * moveDefHandler.GetNumMoveDefs())) {
-		FileSystem::Remove(cacheFileName);
-		return false;
-	}
-
-	// read center-offset data
-	for (int pathType = 0; pathType < moveDefHandler.GetNumMoveDefs(); ++pathType) {
-		std::memcpy(&blockStates.peNodeOffsets[pathType][0], &buffer[pos], blockSize);
-		pos += blockSize;
-	}
+	const size_t offsetBytes = nodeOffsets.size() * sizeof(short2);
+	const size_t costBytes = vertexCosts.size() * sizeof(float);
 
-	// read vertex-cost data
-	if (buffer.size() < (pos + vertexCosts.size() * sizeof(float))) {
-		FileSystem::Remove(cacheFileName);
-		return false;
+	{
+		const MappedFile file(dataDirsAccess.LocateFile(cacheFileName));
+
+		if (file.IsOpen() && file.GetSize() == (sizeof(CacheFileHeader) + offsetBytes + costBytes)) {
+			CacheFileHeader header;
+			std::memcpy(&header, file.GetData(), sizeof(header));
+
+			const std::uint8_t* payload = file.GetData() + sizeof(header);
+
+			const bool validHeader =
+				(std::memcmp(header.magic, CACHE_FILE_MAGIC, sizeof(header.magic)) == 0) &&
+				(header.version == CACHE_FILE_VERSION) &&
+				(header.hashCode == fileHashCode) &&
+				(header.blockSize == BLOCK_SIZE) &&
+				(header.numPathTypes == moveDefHandler.GetNumMoveDefs()) &&
+				(header.numBlocks == blockStates.GetSize()) &&
+				(header.numVertexCosts == vertexCosts.size());
+
+			// the payload CRC is only computed once the cheap header tests pass
+			if (validHeader && CRC::CalcDigest(payload, offsetBytes + costBytes) == header.payloadCRC) {
+				// vertex-costs are patched by terrain updates, so copy out of
+				// the mapping rather than aliasing the vectors onto it
+				std::memcpy(nodeOffsets.data(), payload, offsetBytes);
+				std::memcpy(vertexCosts.data(), payload + offsetBytes, costBytes);
+				return true;
+			}
+		}
 	}
 
-	std::memcpy(&vertexCosts[0], &buffer[pos], vertexCosts.size() * sizeof(float));
-	return true;
+	// stale (other version or BLOCK_SIZE) or corrupt; recreated by the caller
+	FileSystem::Remove(cacheFileName);
+	return false;
 }
 
 
@@ -592,44 +614,64 @@ bool PathingState::WriteFile(const std::string& peFileName, const std::string& m
 
 	LOG("[PathEstimator::%s] hash=%s file=\"%s\" (exists=%d)", __func__, hashHexString.c_str(), cacheFileName.c_str(), FileSystem::FileExists(cacheFileName));
 
-	// open file for writing in a suitable location
-	zipFile file = zipOpen(dataDirsAccess.LocateFile(cacheFileName, FileQueryFlags::WRITE).c_str(), APPEND_STATUS_CREATE);
+	const auto& nodeOffsets = blockStates.GetAllNodeOffsets();
 
-	if (file == nullptr)
-		return false;
+	const size_t offsetBytes = nodeOffsets.size() * sizeof(short2);
+	const size_t costBytes = vertexCosts.size() * sizeof(float);
 
-	zipOpenNewFileInZip(file, "pathinfo", nullptr, nullptr, 0, nullptr, 0, nullptr, Z_DEFLATED, Z_BEST_COMPRESSION);
+	CacheFileHeader header;
+	std::memcpy(header.magic, CACHE_FILE_MAGIC, sizeof(header.magic));
 
-	// write hash-code (NOTE: this also affects the CRC!)
-	zipWriteInFileInZip(file, (const void*) &fileHashCode, 4);
+	header.version = CACHE_FILE_VERSION;
+	header.hashCode = fileHashCode;
+	header.blockSize = BLOCK_SIZE;
+	header.numPathTypes = moveDefHandler.GetNumMoveDefs();
+	header.numBlocks = blockStates.GetSize();
+	header.numVertexCosts = vertexCosts.size();
 
-	// write center-offsets
-	for (int pathType = 0; pathType < moveDefHandler.GetNumMoveDefs(); ++pathType) {
-		zipWriteInFileInZip(file, (const void*) &blockStates.peNodeOffsets[pathType][0], blockStates.peNodeOffsets[pathType].size() * sizeof(short2));
+	{
+		CRC crc;
+		crc.Update(nodeOffsets.data(), offsetBytes);
+		crc.Update(vertexCosts.data(), costBytes);
+		header.payloadCRC = crc.GetDigest();
 	}
 
-	// write vertex-costs
-	zipWriteInFileInZip(file, vertexCosts.data(), vertexCosts.size() * sizeof(float));
+	// write to a temporary first so that another process mapping the
+	// same cache-file never observes it half-written
+	const std::string filePath = dataDirsAccess.LocateFile(cacheFileName, FileQueryFlags::WRITE);
+	const std::string tempPath = filePath + ".tmp";
+
+	{
+		std::ofstream ofs(tempPath, std::ios::out | std::ios::binary | std::ios::trunc);
 
-	zipCloseFileInZip(file);
-	zipClose(file, nullptr);
+		if (!ofs.good())
+			return false;
 
+		ofs.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		ofs.write(reinterpret_cast<const char*>(nodeOffsets.data()), offsetBytes);
+		ofs.write(reinterpret_cast<const char*>(vertexCosts.data()), costBytes);
 
-	// get the CRC over the written path data
-	std::unique_ptr<IArchive> upfile(archiveLoader.OpenArchive(dataDirsAccess.LocateFile(cacheFileName), "sdz"));
+		if (!ofs.good()) {
+			ofs.close();
+			std::remove(tempPath.c_str());
+			return false;
+		}
+	}
 
-	if (upfile == nullptr || !upfile->IsOpen()) {
-		FileSystem::Remove(cacheFileName);
+	// rename does not replace existing files on every platform
+	std::remove(filePath.c_str());
+
+	if (std::rename(tempPath.c_str(), filePath.c_str()) != 0) {
+		std::remove(tempPath.c_str());
 		return false;
 	}
 
-	assert(upfile->FindFile("pathinfo") < upfile->NumFiles());
 	return true;
 }
 
 
 /**
- * Update some obsolete blocks using the FIFO-principle
+ * Update some obsolete blocks, those crossed by the most live paths first
  */
 void PathingState::Update()
 {
@@ -643,8 +685,10 @@ void PathingState::Update()
 	if (numMoveDefs == 0)
 		return;
 
-	if (updatedBlocks.empty())
+	if (updatedBlocks.empty()) {
+		maxUpdateAge = 0;
 		return;
+	}
 
 	// determine how many blocks we should update
 	int blocksToUpdate = 0;
@@ -667,7 +711,61 @@ void PathingState::Update()
 	//LOG("PathingState::Update updatedBlocks.empty == %d", (int)updatedBlocks.empty());
 	//LOG("PathingState::Update updatedBlocksDelayActive %d", (int)updatedBlocksDelayActive);
 
+	// order only matters if the queue can not be drained this frame
+	if (sortUpdatedBlocks && (updatedBlocks.size() * numMoveDefs) > size_t(blocksToUpdate))
+		SortUpdatedBlocks();
+
 	UpdateVertexPathCosts(blocksToUpdate);
+	CalcMaxUpdateAge();
+}
+
+void PathingState::ClearBlockPathUsage()
+{
+	std::fill(blockPathUsage.begin(), blockPathUsage.end(), 0);
+	sortUpdatedBlocks = true;
+}
+
+void PathingState::AddBlockPathUsage(const IPath::Path& path)
+{
+	for (const float3& waypoint: path.path) {
+		const int bx = Clamp(int(waypoint.x / BLOCK_PIXEL_SIZE), 0, mapDimensionsInBlocks.x - 1);
+		const int bz = Clamp(int(waypoint.z / BLOCK_PIXEL_SIZE), 0, mapDimensionsInBlocks.y - 1);
+
+		blockPathUsage[BlockPosToIdx(int2(bx, bz))] += 1;
+	}
+}
+
+void PathingState::SortUpdatedBlocks()
+{
+	// usage counts and queue-frames are synced, and std::stable_sort keeps the
+	// FIFO order among equal priorities, so all clients consume the same blocks
+	const auto BlockPriority = [this](const int2& pos) {
+		const int idx = BlockPosToIdx(pos);
+		const int age = gs->frameNum - blockQueueFrames[idx];
+
+		return (int(blockPathUsage[idx]) + age / BLOCK_UPDATE_AGING_FRAMES);
+	};
+
+	std::stable_sort(updatedBlocks.begin(), updatedBlocks.end(), [&](const int2& a, const int2& b) {
+		return (BlockPriority(a) > BlockPriority(b));
+	});
+
+	sortUpdatedBlocks = false;
+}
+
+void PathingState::CalcMaxUpdateAge()
+{
+	maxUpdateAge = 0;
+
+	for (const int2& pos: updatedBlocks) {
+		const int idx = BlockPosToIdx(pos);
+
+		// already consumed, popped lazily by UpdateVertexPathCosts
+		if ((blockStates.nodeMask[idx] & PATHOPT_OBSOLETE) == 0)
+			continue;
+
+		maxUpdateAge = std::max(maxUpdateAge, gs->frameNum - blockQueueFrames[idx]);
+	}
 }
 
 void PathingState::UpdateVertexPathCosts(int blocksToUpdate)
@@ -725,7 +823,7 @@ void PathingState::UpdateVertexPathCosts(int blocksToUpdate)
 				const SingleBlock sb = consumedBlocks[n];
 				const int blockN = BlockPosToIdx(sb.blockPos);
 				const MoveDef* currBlockMD = sb.moveDef;
-				blockStates.peNodeOffsets[currBlockMD->pathType][blockN] = FindBlockPosOffset(*currBlockMD, sb.blockPos.x, sb.blockPos.y);
+				blockStates.SetNodeOffset(currBlockMD->pathType, blockN, FindBlockPosOffset(*currBlockMD, sb.blockPos.x, sb.blockPos.y));
 			};
 
 		if (modInfo.pfForceUpdateSingleThreaded) {
@@ -738,10 +836,10 @@ void PathingState::UpdateVertexPathCosts(int blocksToUpdate)
 		// 	const SingleBlock sb = consumedBlocks[n];
 		// 	const int blockN = BlockPosToIdx(sb.blockPos);
 		// 	const MoveDef* currBlockMD = sb.moveDef;
-		// 	LOG("UPDATED consumed blockStates.peNodeOffsets[%d][%d] = (%d, %d) :(%d, %d)"
+		// 	LOG("UPDATED consumed blockStates.GetNodeOffset(%d, %d) = (%d, %d) :(%d, %d)"
 		// 		, currBlockMD->pathType, blockN
-		// 		, blockStates.peNodeOffsets[currBlockMD->pathType][blockN].x
-		// 		, blockStates.peNodeOffsets[currBlockMD->pathType][blockN].y
+		// 		, blockStates.GetNodeOffset(currBlockMD->pathType, blockN).x
+		// 		, blockStates.GetNodeOffset(currBlockMD->pathType, blockN).y
 		// 		, sb.blockPos.x, sb.blockPos.y);
 		// }
 	}
@@ -835,6 +933,8 @@ void PathingState::MapChanged(unsigned int x1, unsigned int z1, unsigned int x2,
 
 			updatedBlocks.emplace_back(x, z);
 			blockStates.nodeMask[idx] |= PATHOPT_OBSOLETE;
+			blockQueueFrames[idx] = gs->frameNum;
+			sortUpdatedBlocks = true;
 		}
 	}
 }
@@ -855,28 +955,20 @@ std::uint32_t PathingState::CalcChecksum() const
 	#endif
 
 	#if (ENABLE_NETLOG_CHECKSUM == 1)
-	for (const auto& pathTypeOffsets: blockStates.peNodeOffsets) {
-		nbytes += (pathTypeOffsets.size() * sizeof(short2));
-	}
+	const std::vector<short2>& nodeOffsets = blockStates.GetAllNodeOffsets();
+
+	nbytes += (nodeOffsets.size() * sizeof(short2));
 
 	rawBytes.clear();
 	rawBytes.resize(nbytes);
 
-	for (const auto& pathTypeOffsets: blockStates.peNodeOffsets) {
-		nbytes = pathTypeOffsets.size() * sizeof(short2);
+	{
+		nbytes = nodeOffsets.size() * sizeof(short2);
 		offset += nbytes;
 
-		std::memcpy(&rawBytes[offset - nbytes], pathTypeOffsets.data(), nbytes);
+		std::memcpy(&rawBytes[offset - nbytes], nodeOffsets.data(), nbytes);
 	}
 
-	// for (int i=0; i<blockStates.peNodeOffsets.size(); i++){
-	// 	for (int j =0; j<blockStates.peNodeOffsets[i].size(); j++){
-	// 		LOG("blockStates.peNodeOffsets[%d][%d] = (%d %d)", i, j
-	// 		, blockStates.peNodeOffsets[i][j].x
-	// 		, blockStates.peNodeOffsets[i][j].y);
-	// 	}
-	// }
-
 	{
 		nbytes = vertexCosts.size() * sizeof(float);
 		offset += nbytes;
@@ -43,6 +43,9 @@ public:
 	const std::vector<float>& GetVertexCosts() const { return vertexCosts; }
 	const std::deque<int2>& GetUpdatedBlocks() const { return updatedBlocks; }
 
+	/// number of sim-frames the longest-waiting queued block has been obsolete
+	int GetMaxUpdateAge() const { return maxUpdateAge; }
+
 	struct SOffsetBlock {
 		float cost;
 		int2 offset;
@@ -143,6 +146,11 @@ private:
 
 	std::size_t getCountOfUpdates() const { return updatedBlocks.size(); }
 
+	void ClearBlockPathUsage();
+	void AddBlockPathUsage(const IPath::Path& path);
+	void SortUpdatedBlocks();
+	void CalcMaxUpdateAge();
+
 private:
 	friend class HAPFS::CPathEstimator;
 
@@ -179,6 +187,14 @@ private:
     std::vector<float> vertexCosts;
     std::deque<int2> updatedBlocks;
 
+	// number of live synced path waypoints inside each block, refreshed by CPathManager
+	std::vector<std::uint32_t> blockPathUsage;
+	// sim-frame at which each queued block was marked obsolete
+	std::vector<int> blockQueueFrames;
+
+	int maxUpdateAge = 0;
+	bool sortUpdatedBlocks = false;
+
     PathNodeStateBuffer blockStates;
 
 	struct SingleBlock {
@@ -171,6 +171,8 @@ public:
 	virtual const float* GetNodeExtraCosts(bool synced) const { return nullptr; }
 
 	virtual int2 GetNumQueuedUpdates() const { return (int2(0, 0)); }
+	/// sim-frames the oldest still-queued update has been waiting, per update queue
+	virtual int2 GetMaxQueuedUpdateAge() const { return (int2(0, 0)); }
 
 	virtual bool SupportsMultiThreadedRequests() const { return false; }
 	virtual void SavePathCacheForPathId(int pathIdToSave) {};
@@ -1,5 +1,7 @@
 /* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
 
+#include <algorithm>
+#include <functional>
 #include <limits>
 
 #include "NodeLayer.hpp"
@@ -57,6 +59,18 @@ void QTPFS::NodeLayer::Init(unsigned int layerNum) {
 	oldSpeedMods.resize(xsize * zsize,  0);
 	oldSpeedBins.resize(xsize * zsize, -1);
 	curSpeedBins.resize(xsize * zsize, -1);
+
+	xregions = (xsize + QTPFS_REGION_SIZE - 1) / QTPFS_REGION_SIZE;
+	zregions = (zsize + QTPFS_REGION_SIZE - 1) / QTPFS_REGION_SIZE;
+	regionSearchState = 0;
+
+	// filled in by the initial (global) Update
+	regionMoveCosts.resize(xregions * zregions, QTPFS_POSITIVE_INFINITY);
+	regionLinkMasks.resize(xregions * zregions, 0);
+	regionCorridor.resize(xregions * zregions, 0);
+	regionGCosts.resize(xregions * zregions, 0.0f);
+	regionPrevs.resize(xregions * zregions, -1u);
+	regionStates.resize(xregions * zregions, 0);
 }
 
 void QTPFS::NodeLayer::Clear() {
@@ -67,6 +81,14 @@ void QTPFS::NodeLayer::Clear() {
 	oldSpeedBins.clear();
 	curSpeedBins.clear();
 
+	regionMoveCosts.clear();
+	regionLinkMasks.clear();
+	regionCorridor.clear();
+	regionGCosts.clear();
+	regionPrevs.clear();
+	regionStates.clear();
+	regionQueue.clear();
+
 	#ifdef QTPFS_STAGGERED_LAYER_UPDATES
 	layerUpdates.clear();
 	#endif
@@ -88,13 +110,14 @@ void QTPFS::NodeLayer::QueueUpdate(const SRectangle& r, const MoveDef* md) {
 
 	// make a snapshot of the terrain-state within <r>
 	for (unsigned int hmz = r.z1; hmz < r.z2; hmz++) {
+		CMoveMath::GetPosSpeedModRow(*md, r.x1, r.x2, hmz, &layerUpdate.speedMods[(hmz - r.z1) * r.GetWidth()]);
+
 		for (unsigned int hmx = r.x1; hmx < r.x2; hmx++) {
 			const unsigned int recIdx = (hmz - r.z1) * r.GetWidth() + (hmx - r.x1);
 
 			const unsigned int chmx = Clamp(int(hmx), md->xsizeh, r.x2 - md->xsizeh - 1);
 			const unsigned int chmz = Clamp(int(hmz), md->zsizeh, r.z2 - md->zsizeh - 1);
 
-			layerUpdate.speedMods[recIdx] = CMoveMath::GetPosSpeedMod(*md, hmx, hmz);
 			layerUpdate.blockBits[recIdx] = CMoveMath::IsBlockedNoSpeedModCheck(*md, chmx, chmz, nullptr);
 			// layerUpdate.blockBits[recIdx] = CMoveMath::SquareIsBlocked(*md, hmx, hmz, nullptr);
 		}
@@ -124,6 +147,7 @@ bool QTPFS::NodeLayer::Update(
 
 	unsigned int numNewBinSquares = 0;
 	unsigned int numClosedSquares = 0;
+	unsigned int numNewSpeedModSquares = 0;
 
 	const bool globalUpdate =
 		((r.x1 == 0 && r.x2 == mapDims.mapx) &&
@@ -134,8 +158,14 @@ bool QTPFS::NodeLayer::Update(
 		avgRelSpeedMod = 0.0f;
 	}
 
+	// without a snapshot, speed-modifiers are evaluated a row at a time
+	std::vector<float> rowSpeedMods((luSpeedMods == nullptr)? r.GetWidth(): 0);
+
 	// divide speed-modifiers into bins
 	for (unsigned int hmz = r.z1; hmz < r.z2; hmz++) {
+		if (luSpeedMods == nullptr)
+			CMoveMath::GetPosSpeedModRow(*md, r.x1, r.x2, hmz, rowSpeedMods.data());
+
 		for (unsigned int hmx = r.x1; hmx < r.x2; hmx++) {
 			const unsigned int sqrIdx = hmz * xsize + hmx;
 			const unsigned int recIdx = (hmz - r.z1) * r.GetWidth() + (hmx - r.x1);
@@ -144,7 +174,7 @@ bool QTPFS::NodeLayer::Update(
 			const unsigned int chmx = Clamp(int(hmx), md->xsizeh, r.x2 - md->xsizeh - 1);
 			const unsigned int chmz = Clamp(int(hmz), md->zsizeh, r.z2 - md->zsizeh - 1);
 
-			const float minSpeedMod = (luSpeedMods == nullptr)? CMoveMath::GetPosSpeedMod(*md, hmx, hmz): (*luSpeedMods)[recIdx];
+			const float minSpeedMod = (luSpeedMods == nullptr)? rowSpeedMods[hmx - r.x1]: (*luSpeedMods)[recIdx];
 			const   int maxBlockBit = (luBlockBits == nullptr)? CMoveMath::IsBlockedNoSpeedModCheck(*md, chmx, chmz, nullptr): (*luBlockBits)[recIdx];
 			// NOTE:
 			//   movetype code checks ONLY the *CENTER* square of a unit's footprint
@@ -177,6 +207,8 @@ bool QTPFS::NodeLayer::Update(
 			oldSpeedMods[sqrIdx] = curRelSpeedMod * float(MaxSpeedModTypeValue());
 			curSpeedMods[sqrIdx] = newRelSpeedMod * float(MaxSpeedModTypeValue());
 
+			numNewSpeedModSquares += int(curSpeedMods[sqrIdx] != oldSpeedMods[sqrIdx]);
+
 			oldSpeedBins[sqrIdx] = curSpeedModBin;
 			curSpeedBins[sqrIdx] = newSpeedModBin;
 
@@ -192,6 +224,10 @@ bool QTPFS::NodeLayer::Update(
 	if (globalUpdate && maxRelSpeedMod > 0.0f)
 		avgRelSpeedMod /= ((xsize * zsize) - numClosedSquares);
 
+	// region costs average the speed-mods themselves, not just their bins
+	if (numNewBinSquares > 0 || numNewSpeedModSquares > 0)
+		UpdateRegions(r);
+
 	// if at least one square changed bin, we need to re-tesselate
 	// all nodes in the subtree of the deepest-level node that fully
 	// contains <r>
@@ -222,6 +258,225 @@ QTPFS::NodeLayer::SpeedBinType QTPFS::NodeLayer::GetSpeedModBin(float absSpeedMo
 
 
 
+void QTPFS::NodeLayer::UpdateRegions(const SRectangle& r) {
+	// links are stored on the -x/-z side, so the regions left of and above
+	// <r> must be refreshed as well
+	const unsigned int rx1 = (r.x1 / QTPFS_REGION_SIZE) - (r.x1 >= QTPFS_REGION_SIZE);
+	const unsigned int rz1 = (r.z1 / QTPFS_REGION_SIZE) - (r.z1 >= QTPFS_REGION_SIZE);
+	const unsigned int rx2 = std::min(unsigned(r.x2 + QTPFS_REGION_SIZE - 1) / QTPFS_REGION_SIZE, xregions);
+	const unsigned int rz2 = std::min(unsigned(r.z2 + QTPFS_REGION_SIZE - 1) / QTPFS_REGION_SIZE, zregions);
+
+	// nodes are not split below the minimum size and stay passable while any
+	// of their squares is open, so judge squares by their whole minimum-size
+	// block; links then exist wherever leaf-level searches could cross
+	const auto IsOpenSquare = [&](unsigned int x, unsigned int z) {
+		const unsigned int bx1 = x - (x % QTNode::MinSizeX()), bx2 = std::min(bx1 + QTNode::MinSizeX(), xsize);
+		const unsigned int bz1 = z - (z % QTNode::MinSizeZ()), bz2 = std::min(bz1 + QTNode::MinSizeZ(), zsize);
+
+		for (unsigned int bz = bz1; bz < bz2; bz++) {
+			for (unsigned int bx = bx1; bx < bx2; bx++) {
+				if (curSpeedMods[bz * xsize + bx] != 0)
+					return true;
+			}
+		}
+
+		return false;
+	};
+
+	for (unsigned int rz = rz1; rz < rz2; rz++) {
+		for (unsigned int rx = rx1; rx < rx2; rx++) {
+			const unsigned int x1 = rx * QTPFS_REGION_SIZE, x2 = std::min(x1 + QTPFS_REGION_SIZE, xsize);
+			const unsigned int z1 = rz * QTPFS_REGION_SIZE, z2 = std::min(z1 + QTPFS_REGION_SIZE, zsize);
+
+			float speedModSum = 0.0f;
+			unsigned int numOpenSquares = 0;
+			std::uint8_t linkMask = 0;
+
+			for (unsigned int z = z1; z < z2; z++) {
+				for (unsigned int x = x1; x < x2; x++) {
+					const SpeedModType speedMod = curSpeedMods[z * xsize + x];
+
+					speedModSum += (speedMod / float(MaxSpeedModTypeValue()));
+					numOpenSquares += (speedMod != 0);
+				}
+			}
+
+			if (x2 < xsize) {
+				for (unsigned int z = z1; z < z2 && (linkMask & 1) == 0; z++) {
+					linkMask |= (1 * (IsOpenSquare(x2 - 1, z) && IsOpenSquare(x2, z)));
+				}
+			}
+			if (z2 < zsize) {
+				for (unsigned int x = x1; x < x2 && (linkMask & 2) == 0; x++) {
+					linkMask |= (2 * (IsOpenSquare(x, z2 - 1) && IsOpenSquare(x, z2)));
+				}
+			}
+
+			regionMoveCosts[rz * xregions + rx] = (numOpenSquares == 0)? QTPFS_POSITIVE_INFINITY: (numOpenSquares / std::max(speedModSum, 0.001f));
+			regionLinkMasks[rz * xregions + rx] = linkMask;
+		}
+	}
+}
+
+int QTPFS::NodeLayer::FindRegionCorridor(const float3& srcPoint, const float3& tgtPoint) {
+	const unsigned int srx = Clamp(int(srcPoint.x / (SQUARE_SIZE * QTPFS_REGION_SIZE)), 0, int(xregions) - 1);
+	const unsigned int srz = Clamp(int(srcPoint.z / (SQUARE_SIZE * QTPFS_REGION_SIZE)), 0, int(zregions) - 1);
+	const unsigned int trx = Clamp(int(tgtPoint.x / (SQUARE_SIZE * QTPFS_REGION_SIZE)), 0, int(xregions) - 1);
+	const unsigned int trz = Clamp(int(tgtPoint.z / (SQUARE_SIZE * QTPFS_REGION_SIZE)), 0, int(zregions) - 1);
+
+	if (std::max(std::abs(int(srx - trx)), std::abs(int(srz - trz))) < QTPFS_MIN_REGION_SEARCH_DIST)
+		return REGION_SEARCH_SKIPPED;
+
+	const unsigned int srcIdx = srz * xregions + srx;
+	const unsigned int tgtIdx = trz * xregions + trx;
+
+	// leave searches from or to closed regions to the leaf-level (these can
+	// still succeed, eg. when starting inside a factory's footprint)
+	if (regionMoveCosts[srcIdx] == QTPFS_POSITIVE_INFINITY || regionMoveCosts[tgtIdx] == QTPFS_POSITIVE_INFINITY)
+		return REGION_SEARCH_SKIPPED;
+
+	// open regions are marked by (state + 0), closed regions by (state + 1)
+	regionSearchState += 2;
+
+	const float hCostMult = QTPFS_REGION_SIZE / std::max(maxRelSpeedMod, 0.001f);
+	const auto HeuristicCost = [&](unsigned int idx) {
+		const float dx = float(int(idx % xregions) - int(trx));
+		const float dz = float(int(idx / xregions) - int(trz));
+		return (math::sqrt(dx * dx + dz * dz) * hCostMult);
+	};
+
+	regionQueue.clear();
+	regionQueue.emplace_back(HeuristicCost(srcIdx), srcIdx);
+
+	regionGCosts[srcIdx] = 0.0f;
+	regionPrevs[srcIdx] = -1u;
+	regionStates[srcIdx] = regionSearchState;
+
+	// closest region to the target reached so far, for partial corridors
+	unsigned int minIdx = srcIdx;
+	float minHCost = HeuristicCost(srcIdx);
+
+	while (!regionQueue.empty()) {
+		std::pop_heap(regionQueue.begin(), regionQueue.end(), std::greater< std::pair<float, unsigned int> >());
+
+		const unsigned int curIdx = regionQueue.back().second;
+		regionQueue.pop_back();
+
+		// skip stale queue entries
+		if (regionStates[curIdx] == (regionSearchState + 1))
+			continue;
+
+		regionStates[curIdx] = regionSearchState + 1;
+
+		if (curIdx == tgtIdx)
+			break;
+
+		if (HeuristicCost(curIdx) < minHCost) {
+			minIdx = curIdx;
+			minHCost = HeuristicCost(curIdx);
+		}
+
+		const unsigned int crx = curIdx % xregions;
+		const unsigned int crz = curIdx / xregions;
+
+		// {neighbor index, link present}; -x/-z links live in the neighbor
+		const std::pair<unsigned int, bool> ngbs[4] = {
+			{curIdx - 1       , (crx >            0) && ((regionLinkMasks[curIdx - 1       ] & 1) != 0)},
+			{curIdx + 1       , (crx < xregions - 1) && ((regionLinkMasks[curIdx           ] & 1) != 0)},
+			{curIdx - xregions, (crz >            0) && ((regionLinkMasks[curIdx - xregions] & 2) != 0)},
+			{curIdx + xregions, (crz < zregions - 1) && ((regionLinkMasks[curIdx           ] & 2) != 0)},
+		};
+
+		for (const auto& ngb: ngbs) {
+			if (!ngb.second)
+				continue;
+			if (regionStates[ngb.first] == (regionSearchState + 1))
+				continue;
+
+			// half of each region is crossed when moving between their centers
+			const float gCost = regionGCosts[curIdx] + (regionMoveCosts[curIdx] + regionMoveCosts[ngb.first]) * (QTPFS_REGION_SIZE * 0.5f);
+
+			if (regionStates[ngb.first] == regionSearchState && gCost >= regionGCosts[ngb.first])
+				continue;
+
+			regionGCosts[ngb.first] = gCost;
+			regionPrevs[ngb.first] = curIdx;
+			regionStates[ngb.first] = regionSearchState;
+
+			regionQueue.emplace_back(gCost + HeuristicCost(ngb.first), ngb.first);
+			std::push_heap(regionQueue.begin(), regionQueue.end(), std::greater< std::pair<float, unsigned int> >());
+		}
+	}
+
+	// the region graph only over-approximates leaf-level connectivity, so no
+	// region-path means no path at all; the corridor then leads towards the
+	// region closest to the target, where a partial path would end anyway
+	const bool haveRegionPath = (regionStates[tgtIdx] == (regionSearchState + 1));
+
+	std::fill(regionCorridor.begin(), regionCorridor.end(), 0);
+
+	for (unsigned int idx = haveRegionPath? tgtIdx: minIdx; idx != -1u; idx = regionPrevs[idx]) {
+		const int rx = idx % xregions;
+		const int rz = idx / xregions;
+
+		for (int z = std::max(rz - QTPFS_REGION_CORRIDOR_RADIUS, 0); z <= std::min(rz + QTPFS_REGION_CORRIDOR_RADIUS, int(zregions) - 1); z++) {
+			for (int x = std::max(rx - QTPFS_REGION_CORRIDOR_RADIUS, 0); x <= std::min(rx + QTPFS_REGION_CORRIDOR_RADIUS, int(xregions) - 1); x++) {
+				regionCorridor[z * xregions + x] = 1;
+			}
+		}
+	}
+
+	return (haveRegionPath? REGION_SEARCH_PATH: REGION_SEARCH_NO_PATH);
+}
+
+void QTPFS::NodeLayer::MarkReachableRegions(const float3& point) {
+	const unsigned int srcIdx = GetRegionIndex(point);
+
+	// reached regions are marked by (state + 1), as closed ones are by FindRegionCorridor
+	regionSearchState += 2;
+	regionStates[srcIdx] = regionSearchState + 1;
+
+	regionQueue.clear();
+	regionQueue.emplace_back(0.0f, srcIdx);
+
+	while (!regionQueue.empty()) {
+		const unsigned int curIdx = regionQueue.back().second;
+		regionQueue.pop_back();
+
+		const unsigned int crx = curIdx % xregions;
+		const unsigned int crz = curIdx / xregions;
+
+		const std::pair<unsigned int, bool> ngbs[4] = {
+			{curIdx - 1       , (crx >            0) && ((regionLinkMasks[curIdx - 1       ] & 1) != 0)},
+			{curIdx + 1       , (crx < xregions - 1) && ((regionLinkMasks[curIdx           ] & 1) != 0)},
+			{curIdx - xregions, (crz >            0) && ((regionLinkMasks[curIdx - xregions] & 2) != 0)},
+			{curIdx + xregions, (crz < zregions - 1) && ((regionLinkMasks[curIdx           ] & 2) != 0)},
+		};
+
+		for (const auto& ngb: ngbs) {
+			if (!ngb.second)
+				continue;
+			if (regionStates[ngb.first] == (regionSearchState + 1))
+				continue;
+
+			regionStates[ngb.first] = regionSearchState + 1;
+			regionQueue.emplace_back(0.0f, ngb.first);
+		}
+	}
+}
+
+bool QTPFS::NodeLayer::IsReachableRegion(const float3& point) const {
+	return (regionStates[GetRegionIndex(point)] == (regionSearchState + 1));
+}
+
+unsigned int QTPFS::NodeLayer::GetRegionIndex(const float3& point) const {
+	const unsigned int rx = Clamp(int(point.x / (SQUARE_SIZE * QTPFS_REGION_SIZE)), 0, int(xregions) - 1);
+	const unsigned int rz = Clamp(int(point.z / (SQUARE_SIZE * QTPFS_REGION_SIZE)), 0, int(zregions) - 1);
+	return (rz * xregions + rx);
+}
+
+
+
 // update the neighbor-cache for (a chunk of) the leaf
 // nodes in this layer; this amortizes (in theory) the
 // cost of doing it "on-demand" in PathSearch::Iterate
@@ -114,6 +114,30 @@ namespace QTPFS {
 
 		SpeedBinType GetSpeedModBin(float absSpeedMod, float relSpeedMod) const;
 
+		enum {
+			REGION_SEARCH_SKIPPED = 0, // points too close for this to pay off, or in closed regions (corridor is stale)
+			REGION_SEARCH_PATH    = 1,
+			REGION_SEARCH_NO_PATH = 2, // no leaf-level path exists either
+		};
+
+		// runs A* over the region graph and marks the regions along the path
+		// (and around it) as corridor; if none exists, the corridor leads to
+		// the reachable region closest to the target instead
+		int FindRegionCorridor(const float3& srcPoint, const float3& tgtPoint);
+
+		// flood-fills the region graph from <point>'s region; leaf-level searches
+		// starting there can not reach points in regions left unmarked by this
+		void MarkReachableRegions(const float3& point);
+		bool IsReachableRegion(const float3& point) const;
+
+		bool InRegionCorridor(const INode* n) const {
+			// nodes larger than a region are rare and would need a range test
+			if (n->xsize() > QTPFS_REGION_SIZE || n->zsize() > QTPFS_REGION_SIZE)
+				return true;
+
+			return (regionCorridor[(n->zmid() / QTPFS_REGION_SIZE) * xregions + (n->xmid() / QTPFS_REGION_SIZE)] != 0);
+		}
+
 		std::uint64_t GetMemFootPrint() const {
 			std::uint64_t memFootPrint = sizeof(NodeLayer);
 			memFootPrint += (curSpeedMods.size() * sizeof(SpeedModType));
@@ -126,12 +150,32 @@ namespace QTPFS {
 				memFootPrint += (poolNodes[i].size() * sizeof(QTNode));
 			}
 			memFootPrint += (nodeIndcs.size() * sizeof(decltype(nodeIndcs)::value_type));
+			memFootPrint += (regionMoveCosts.size() * (sizeof(float) * 2 + sizeof(unsigned int) * 2 + sizeof(std::uint8_t) * 2));
 			return memFootPrint;
 		}
 
+	private:
+		void UpdateRegions(const SRectangle& r);
+
+		unsigned int GetRegionIndex(const float3& point) const;
+
 	private:
 		std::vector<INode*> nodeGrid;
 
+		// abstract graph; each region stores the average move-cost of its open
+		// squares (infinite if none) and whether it connects to its +x and +z
+		// neighbors (bits 0 and 1), which holds if any pair of squares facing
+		// each other across the shared border is open (see UpdateRegions)
+		std::vector<float> regionMoveCosts;
+		std::vector<std::uint8_t> regionLinkMasks;
+		std::vector<std::uint8_t> regionCorridor;
+
+		// scratch-space for FindRegionCorridor
+		std::vector<float> regionGCosts;
+		std::vector<unsigned int> regionPrevs;
+		std::vector<unsigned int> regionStates;
+		std::vector< std::pair<float, unsigned int> > regionQueue;
+
 		std::vector<QTNode> poolNodes[16];
 		std::vector<unsigned int> nodeIndcs;
 
@@ -166,6 +210,10 @@ namespace QTPFS {
 		unsigned int xsize = 0;
 		unsigned int zsize = 0;
 
+		unsigned int xregions = 0;
+		unsigned int zregions = 0;
+		unsigned int regionSearchState = 0;
+
 		float maxRelSpeedMod = 0.0f;
 		float avgRelSpeedMod = 0.0f;
 	};
@@ -111,6 +111,7 @@ void QTPFS::PathCache::DelPath(unsigned int pathID) {
 	if ((it = deadPaths.find(pathID)) != deadPaths.end()) {
 		delete (it->second);
 		deadPaths.erase(it);
+		deadPathSpans.erase(pathID);
 	}
 }
 
@@ -131,29 +132,25 @@ bool QTPFS::PathCache::MarkDeadPaths(const SRectangle& r) {
 
 	GetRectangleCollisionVolume(r, rv, rm);
 
-	// "mark" any live path crossing the area of a terrain
-	// deformation, for which some or all of its waypoints
-	// might now be invalid and need to be recomputed
-	std::vector<PathMapIt> livePathIts;
-	livePathIts.reserve(livePaths.size());
-
-	for (PathMapIt it = livePaths.begin(); it != livePaths.end(); ++it) {
-		IPath* path = it->second;
-
+	// finds the first and last not yet visited segment of <path> crossing <r>
+	const auto GetCrossedSpan = [&](const IPath* path, unsigned int& minSegIdx, unsigned int& maxSegIdx) {
 		const float3& pathMins = path->GetBoundingBoxMins();
 		const float3& pathMaxs = path->GetBoundingBoxMaxs();
 
 		// if rectangle does not overlap bounding-box, skip this path
-		if ((r.x2 * SQUARE_SIZE) < pathMins.x) { continue; }
-		if ((r.z2 * SQUARE_SIZE) < pathMins.z) { continue; }
-		if ((r.x1 * SQUARE_SIZE) > pathMaxs.x) { continue; }
-		if ((r.z1 * SQUARE_SIZE) > pathMaxs.z) { continue; }
+		if ((r.x2 * SQUARE_SIZE) < pathMins.x) { return false; }
+		if ((r.z2 * SQUARE_SIZE) < pathMins.z) { return false; }
+		if ((r.x1 * SQUARE_SIZE) > pathMaxs.x) { return false; }
+		if ((r.z1 * SQUARE_SIZE) > pathMaxs.z) { return false; }
 
 		// figure out if <path> has at least one edge crossing <r>
 		// we only care about the segments we have not yet visited
 		const unsigned int minIdx = std::max(path->GetNextPointIndex(), 2U) - 2;
 		const unsigned int maxIdx = std::max(path->NumPoints(), 1u) - 1;
 
+		minSegIdx = -1u;
+		maxSegIdx = 0;
+
 		for (unsigned int i = minIdx; i < maxIdx; i++) {
 			const float3& p0 = path->GetPoint(i    );
 			const float3& p1 = path->GetPoint(i + 1);
@@ -180,14 +177,45 @@ bool QTPFS::PathCache::MarkDeadPaths(const SRectangle& r) {
 				(xRangeInRect && zRangeExRect) ||
 				CCollisionHandler::IntersectBox(&rv, p0 - rm, p1 - rm, NULL);
 
-			// remember the ID of each path affected by the deformation
 			if (havePointInRect || edgeCrossesRect) {
-				assert(tempPaths.find(path->GetID()) == tempPaths.end());
-				deadPaths.insert(std::pair<unsigned int, IPath*>(path->GetID(), path));
-				livePathIts.push_back(it);
-				break;
+				minSegIdx = std::min(minSegIdx, i);
+				maxSegIdx = std::max(maxSegIdx, i);
 			}
 		}
+
+		return (minSegIdx != -1u);
+	};
+
+	unsigned int minSegIdx = -1u;
+	unsigned int maxSegIdx = 0;
+
+	// paths that died from an earlier change might cross this one elsewhere,
+	// widen their spans so a repair covers every affected segment
+	for (auto& pair: deadPathSpans) {
+		if (!GetCrossedSpan(deadPaths[pair.first], minSegIdx, maxSegIdx))
+			continue;
+
+		pair.second.first  = std::min(pair.second.first , minSegIdx);
+		pair.second.second = std::max(pair.second.second, maxSegIdx);
+	}
+
+	// "mark" any live path crossing the area of a terrain
+	// deformation, for which some or all of its waypoints
+	// might now be invalid and need to be recomputed
+	std::vector<PathMapIt> livePathIts;
+	livePathIts.reserve(livePaths.size());
+
+	for (PathMapIt it = livePaths.begin(); it != livePaths.end(); ++it) {
+		IPath* path = it->second;
+
+		if (!GetCrossedSpan(path, minSegIdx, maxSegIdx))
+			continue;
+
+		// remember the ID of each path affected by the deformation
+		assert(tempPaths.find(path->GetID()) == tempPaths.end());
+		deadPaths.insert(std::pair<unsigned int, IPath*>(path->GetID(), path));
+		deadPathSpans.insert({path->GetID(), {minSegIdx, maxSegIdx}});
+		livePathIts.push_back(it);
 	}
 
 	for (auto it = livePathIts.begin(); it != livePathIts.end(); ++it) {
@@ -206,5 +234,17 @@ void QTPFS::PathCache::KillDeadPaths() {
 	}
 
 	deadPaths.clear();
+	deadPathSpans.clear();
+}
+
+bool QTPFS::PathCache::GetDeadPathSpan(unsigned int pathID, unsigned int& minSegIdx, unsigned int& maxSegIdx) const {
+	const auto it = deadPathSpans.find(pathID);
+
+	if (it == deadPathSpans.end())
+		return false;
+
+	minSegIdx = it->second.first;
+	maxSegIdx = it->second.second;
+	return true;
 }
 
@@ -25,10 +25,14 @@ namespace QTPFS {
 
 		typedef spring::unordered_map<unsigned int, IPath*> PathMap;
 		typedef spring::unordered_map<unsigned int, IPath*>::iterator PathMapIt;
+		// {first, last} index of the segments of a dead path crossed by changes
+		typedef spring::unordered_map<unsigned int, std::pair<unsigned int, unsigned int> > SpanMap;
 
 		bool MarkDeadPaths(const SRectangle& r);
 		void KillDeadPaths();
 
+		bool GetDeadPathSpan(unsigned int pathID, unsigned int& minSegIdx, unsigned int& maxSegIdx) const;
+
 		const IPath* GetTempPath(unsigned int pathID) const { return (GetConstPath(pathID, PATH_TYPE_TEMP)); }
 		const IPath* GetLivePath(unsigned int pathID) const { return (GetConstPath(pathID, PATH_TYPE_LIVE)); }
 		const IPath* GetDeadPath(unsigned int pathID) const { return (GetConstPath(pathID, PATH_TYPE_DEAD)); }
@@ -53,6 +57,8 @@ namespace QTPFS {
 		PathMap livePaths;
 		PathMap deadPaths;
 
+		SpanMap deadPathSpans;
+
 		std::vector<unsigned int> numCacheHits;
 		std::vector<unsigned int> numCacheMisses;
 	};
@@ -7,6 +7,10 @@
 #define QTPFS_SUPPORT_PARTIAL_SEARCHES
 // #define QTPFS_TRACE_PATH_SEARCHES
 #define QTPFS_SEARCH_SHARED_PATHS
+#define QTPFS_GROUP_PATH_SEARCHES
+#define QTPFS_REGION_CORRIDOR_SEARCHES
+#define QTPFS_REPAIR_DEAD_PATHS
+#define QTPFS_BUDGETED_SEARCHES
 #define QTPFS_SMOOTH_PATHS
 // #define QTPFS_CONSERVATIVE_NODE_SPLITS
 // #define QTPFS_DEBUG_NODE_HEAP
@@ -23,6 +27,30 @@
 // #define QTPFS_CONSERVATIVE_NEIGHBOR_CACHE_UPDATES
 
 #define QTPFS_MAX_SMOOTHING_ITERATIONS 8
+// queued searches sharing a target node are served by one reverse search
+// (see PathSearch::ExecuteGroup) if at least this many of them are pending
+#define QTPFS_MIN_GROUP_SEARCH_SIZE 4
+
+// size (in heightmap squares) of the regions making up the abstract graph
+// that long-distance searches are first run on; their leaf-level search
+// is then restricted to the corridor of regions found (plus a rim of
+// QTPFS_REGION_CORRIDOR_RADIUS regions), see NodeLayer::FindRegionCorridor
+#define QTPFS_REGION_SIZE 32
+#define QTPFS_REGION_CORRIDOR_RADIUS 1
+#define QTPFS_MIN_REGION_SEARCH_DIST 8
+
+// how far (in heightmap squares) a local repair of a dead path may detour
+// around the span of segments invalidated by a terrain change
+#define QTPFS_REPAIR_SEARCH_MARGIN 64
+
+// maximum number of nodes that queued searches may expand per layer-update
+// (at least one search always runs); the rest wait for the next update in
+// order of priority, see PathManager::SortQueuedSearches
+// priorities are sim-frame deadlines: queue-frame + CLASS_FRAMES per step
+// of SEARCH_PRIORITY_* class + one frame per DIST_SQUARES squares of range
+#define QTPFS_SEARCH_NODE_BUDGET 32768
+#define QTPFS_SEARCH_PRIORITY_CLASS_FRAMES 15
+#define QTPFS_SEARCH_PRIORITY_DIST_SQUARES 64
 
 #define QTPFS_MAX_NETPOINTS_PER_NODE_EDGE 3
 #define QTPFS_NETPOINT_EDGE_SPACING_SCALE (1.0f / (QTPFS_MAX_NETPOINTS_PER_NODE_EDGE + 1))
@@ -40,6 +40,11 @@ namespace QTPFS {
 		PATH_SEARCH_ASTAR    = 0,
 		PATH_SEARCH_DIJKSTRA = 1,
 	};
+	enum {
+		SEARCH_PRIORITY_REPATH = 0, // re-search of a dead path its owner is still following
+		SEARCH_PRIORITY_PLAYER = 1, // new request for a unit of a player-controlled team
+		SEARCH_PRIORITY_AI     = 2, // new request for a unit of an AI-controlled team
+	};
 	enum {
 		PATH_TYPE_TEMP = 0,
 		PATH_TYPE_LIVE = 1,
@@ -10,6 +10,7 @@
 #include "PathDefines.hpp"
 #include "PathManager.hpp"
 
+#include "ExternalAI/SkirmishAIHandler.h"
 #include "Game/GameSetup.h"
 #include "Game/LoadScreen.h"
 #include "Map/MapInfo.h"
@@ -145,6 +146,7 @@ QTPFS::PathManager::~PathManager() {
 	pathSearches.clear();
 	pathTypes.clear();
 	pathTraces.clear();
+	pathRepairs.clear();
 
 	numCurrExecutedSearches.clear();
 	numPrevExecutedSearches.clear();
@@ -190,12 +192,14 @@ void QTPFS::PathManager::Load() {
 	searchStateOffset = NODE_STATE_OFFSET;
 	numTerrainChanges = 0;
 	numPathRequests   = 0;
+	numExpandedSearchNodes = 0;
 	maxNumLeafNodes   = 0;
 
 	nodeTrees.resize(moveDefHandler.GetNumMoveDefs(), nullptr);
 	nodeLayers.resize(moveDefHandler.GetNumMoveDefs());
 	pathCaches.resize(moveDefHandler.GetNumMoveDefs());
 	pathSearches.resize(moveDefHandler.GetNumMoveDefs());
+	pathRepairs.resize(moveDefHandler.GetNumMoveDefs());
 
 	// add one extra element for object-less requests
 	numCurrExecutedSearches.resize(teamHandler.ActiveTeams() + 1, 0);
@@ -461,6 +465,7 @@ void QTPFS::PathManager::UpdateNodeLayer(unsigned int layerNum, const SRectangle
 	if (needTesselation && wantTesselation) {
 		nodeTrees[layerNum]->PreTesselate(nodeLayers[layerNum], mr, ur, 0);
 		pathCaches[layerNum].MarkDeadPaths(mr);
+		CancelPathRepairs(mr, layerNum);
 
 		#ifndef QTPFS_CONSERVATIVE_NEIGHBOR_CACHE_UPDATES
 		nodeLayers[layerNum].ExecNodeNeighborCacheUpdates(ur, numTerrainChanges);
@@ -507,6 +512,7 @@ void QTPFS::PathManager::ExecQueuedNodeLayerUpdates(unsigned int layerNum, bool
 		if (nodeLayers[layerNum].ExecQueuedUpdate()) {
 			nodeTrees[layerNum]->PreTesselate(nodeLayers[layerNum], mr, ur, 0);
 			pathCaches[layerNum].MarkDeadPaths(mr);
+			CancelPathRepairs(mr, layerNum);
 
 			#ifndef QTPFS_CONSERVATIVE_NEIGHBOR_CACHE_UPDATES
 			// NOTE:
@@ -753,19 +759,58 @@ void QTPFS::PathManager::ExecuteQueuedSearches(unsigned int pathType) {
 	PathCache& pathCache = pathCaches[pathType];
 
 	std::vector<IPathSearch*>& searches = pathSearches[pathType];
+
+	numExpandedSearchNodes = 0;
+
+	#ifdef QTPFS_BUDGETED_SEARCHES
+	// groups are served first, everything else in order of priority
+	SortQueuedSearches(pathType);
+	#endif
+
+	#ifdef QTPFS_GROUP_PATH_SEARCHES
+	// serve groups of requests (e.g. from a mass move-order) first, this
+	// shrinks <searches> to those that still need an individual search
+	ExecuteGroupSearches(pathType);
+	#endif
+
 	std::vector<IPathSearch*>::iterator searchesIt = searches.begin();
 
 	if (!searches.empty()) {
 		// execute pending searches collected via
 		// RequestPath and QueueDeadPathSearches
 		while (searchesIt != searches.end()) {
+			#ifdef QTPFS_BUDGETED_SEARCHES
+			// remaining searches keep their place in the queue; numExpandedSearchNodes
+			// only depends on synced state, so every client stops at the same search
+			if (numExpandedSearchNodes >= QTPFS_SEARCH_NODE_BUDGET)
+				break;
+			#endif
+
 			if (ExecuteSearch(searches, searchesIt, nodeLayer, pathCache, pathType)) {
 				searchStateOffset += NODE_STATE_OFFSET;
 			}
 		}
+
+		// ExecuteSearch leaves holes to preserve the queue order
+		searches.erase(std::remove(searches.begin(), searches.end(), nullptr), searches.end());
 	}
 }
 
+void QTPFS::PathManager::SortQueuedSearches(unsigned int pathType) {
+	std::vector<IPathSearch*>& searches = pathSearches[pathType];
+
+	// earliest deadline first, ties go to the oldest request; IDs are unique
+	// among queued searches so the order is the same on every client
+	const auto SearchCmp = [](const IPathSearch* a, const IPathSearch* b) {
+		if (a->GetPriority() != b->GetPriority())
+			return (a->GetPriority() < b->GetPriority());
+
+		return (a->GetID() < b->GetID());
+	};
+
+	std::sort(searches.begin(), searches.end(), SearchCmp);
+}
+
 bool QTPFS::PathManager::ExecuteSearch(
 	PathSearchVect& searches,
 	PathSearchVectIt& searchesIt,
@@ -779,10 +824,12 @@ bool QTPFS::PathManager::ExecuteSearch(
 	assert(search != nullptr);
 	assert(path != nullptr);
 
-	const auto DeleteSearch = [](IPathSearch* s, PathSearchVect& v, PathSearchVectIt& it) {
-		// ordering of still-queued searches is not relevant
-		*it = v.back();
-		v.pop_back();
+	const auto DeleteSearch = [&](IPathSearch* s, PathSearchVect& v, PathSearchVectIt& it) {
+		// keep the (priority) order of still-queued searches, the
+		// holes are removed by ExecuteQueuedSearches
+		numExpandedSearchNodes += s->GetNumExpandedNodes();
+
+		*(it++) = nullptr;
 		delete s;
 	};
 
@@ -799,9 +846,16 @@ bool QTPFS::PathManager::ExecuteSearch(
 	search->Initialize(&nodeLayer, &pathCache, path->GetSourcePoint(), path->GetTargetPoint(), MAP_RECTANGLE);
 	path->SetHash(search->GetHash(mapDims.mapx * mapDims.mapy, pathType));
 
+	#ifdef QTPFS_REPAIR_DEAD_PATHS
+	const bool isPathRepair = (pathRepairs[pathType].find(path->GetID()) != pathRepairs[pathType].end());
+	#else
+	const bool isPathRepair = false;
+	#endif
+
 	{
 		#ifdef QTPFS_SEARCH_SHARED_PATHS
-		SharedPathMap::const_iterator sharedPathsIt = sharedPaths.find(path->GetHash());
+		// a repair's hash only covers its local end-points
+		SharedPathMap::const_iterator sharedPathsIt = isPathRepair? sharedPaths.end(): sharedPaths.find(path->GetHash());
 
 		if (sharedPathsIt != sharedPaths.end()) {
 			if (search->SharedFinalize(sharedPathsIt->second, path)) {
@@ -823,8 +877,45 @@ bool QTPFS::PathManager::ExecuteSearch(
 		#endif
 	}
 
+	if (isPathRepair && ExecuteRepairSearch(search, path, nodeLayer, pathCache, pathType)) {
+		DeleteSearch(search, searches, searchesIt);
+		return true;
+	}
+
+	bool haveSearchResult = false;
+
+	#ifdef QTPFS_REGION_CORRIDOR_SEARCHES
+	// long searches are first run on the region graph and only expand leaf
+	// nodes within the corridor it yields; the graph is coarse and regions
+	// can be internally disconnected, so fall back to an unrestricted search
+	// if the restricted one does not reach the target, unless the graph has
+	// already ruled out any path (the partial one found in the corridor then
+	// ends as close to the target as an unrestricted search would get)
+	const int regionSearchResult = nodeLayer.FindRegionCorridor(path->GetSourcePoint(), path->GetTargetPoint());
+
+	if (regionSearchResult != NodeLayer::REGION_SEARCH_SKIPPED) {
+		// QueueSearch only ever creates PathSearch instances
+		PathSearch* corridorSearch = static_cast<PathSearch*>(search);
+
+		corridorSearch->SetUseRegionCorridor(true);
+		haveSearchResult = corridorSearch->Execute(searchStateOffset, numTerrainChanges);
+		haveSearchResult &= (corridorSearch->HaveFullPath() || regionSearchResult == NodeLayer::REGION_SEARCH_NO_PATH);
+		corridorSearch->SetUseRegionCorridor(false);
+
+		if (!haveSearchResult && regionSearchResult == NodeLayer::REGION_SEARCH_PATH) {
+			searchStateOffset += NODE_STATE_OFFSET;
+			search->Initialize(&nodeLayer, &pathCache, path->GetSourcePoint(), path->GetTargetPoint(), MAP_RECTANGLE);
+		}
+	}
+
+	if (!haveSearchResult && regionSearchResult != NodeLayer::REGION_SEARCH_NO_PATH)
+		haveSearchResult = search->Execute(searchStateOffset, numTerrainChanges);
+	#else
+	haveSearchResult = search->Execute(searchStateOffset, numTerrainChanges);
+	#endif
+
 	// removes path from temp-paths, adds it to live-paths
-	if (search->Execute(searchStateOffset, numTerrainChanges)) {
+	if (haveSearchResult) {
 		search->Finalize(path);
 
 		#ifdef QTPFS_SEARCH_SHARED_PATHS
@@ -842,6 +933,132 @@ bool QTPFS::PathManager::ExecuteSearch(
 	return true;
 }
 
+void QTPFS::PathManager::ExecuteGroupSearches(unsigned int pathType) {
+	NodeLayer& nodeLayer = nodeLayers[pathType];
+	PathCache& pathCache = pathCaches[pathType];
+
+	std::vector<IPathSearch*>& searches = pathSearches[pathType];
+
+	if (searches.size() < QTPFS_MIN_GROUP_SEARCH_SIZE)
+		return;
+
+	// {target-node number, search index}; sorting these makes both the
+	// grouping and the order in which groups are executed deterministic
+	std::vector< std::pair<unsigned int, unsigned int> > searchKeys;
+	searchKeys.reserve(searches.size());
+
+	for (unsigned int i = 0; i < searches.size(); i++) {
+		// QueueSearch only ever creates PathSearch instances
+		PathSearch* search = static_cast<PathSearch*>(searches[i]);
+		const IPath* path = pathCache.GetTempPath(search->GetID());
+
+		// dead temp-paths are cleaned up by ExecuteSearch
+		if (path->GetID() == 0)
+			continue;
+		// repairs have local end-points and need their own splicing
+		if (pathRepairs[pathType].find(path->GetID()) != pathRepairs[pathType].end())
+			continue;
+
+		search->Initialize(&nodeLayer, &pathCache, path->GetSourcePoint(), path->GetTargetPoint(), MAP_RECTANGLE);
+		searchKeys.emplace_back(search->GetTargetNode()->GetNodeNumber(), i);
+	}
+
+	std::sort(searchKeys.begin(), searchKeys.end());
+
+	std::vector<PathSearch*> members;
+	std::vector<IPath*> paths;
+	std::vector<bool> finalized;
+	std::vector<unsigned int> memberIdcs;
+
+	bool haveFinalized = false;
+
+	for (size_t i = 0, j = 0; i < searchKeys.size(); i = j) {
+		for (j = i + 1; j < searchKeys.size() && searchKeys[j].first == searchKeys[i].first; j++);
+
+		if ((j - i) < QTPFS_MIN_GROUP_SEARCH_SIZE)
+			continue;
+
+		#ifdef QTPFS_BUDGETED_SEARCHES
+		// groups are ordered by target rather than priority, but only run
+		// while the budget lasts so that individual searches are not starved
+		if (numExpandedSearchNodes >= QTPFS_SEARCH_NODE_BUDGET)
+			break;
+		#endif
+
+		members.clear();
+		paths.clear();
+		memberIdcs.clear();
+
+		for (size_t k = i; k < j; k++) {
+			PathSearch* search = static_cast<PathSearch*>(searches[searchKeys[k].second]);
+
+			#ifdef QTPFS_LIMIT_TEAM_SEARCHES
+			// members of teams that are out of searches wait like any other
+			// request would, and may still join a group in a later update
+			const unsigned int numCurrSearches = numCurrExecutedSearches[search->GetTeam()];
+			const unsigned int numPrevSearches = numPrevExecutedSearches[search->GetTeam()];
+
+			if ((numCurrSearches - numPrevSearches) >= MAX_TEAM_SEARCHES)
+				continue;
+			#endif
+
+			IPath* path = pathCache.GetTempPath(search->GetID());
+
+			path->SetHash(search->GetHash(mapDims.mapx * mapDims.mapy, pathType));
+			members.push_back(search);
+			paths.push_back(path);
+			memberIdcs.push_back(searchKeys[k].second);
+		}
+
+		if (members.size() < QTPFS_MIN_GROUP_SEARCH_SIZE)
+			continue;
+
+		#ifdef QTPFS_LIMIT_TEAM_SEARCHES
+		// the group counts as one search for each team taking part in it
+		for (size_t k = 0; k < members.size(); k++) {
+			const unsigned int searchTeam = members[k]->GetTeam();
+
+			if (std::find_if(members.begin(), members.begin() + k, [&](const PathSearch* s) { return (s->GetTeam() == searchTeam); }) != (members.begin() + k))
+				continue;
+
+			numCurrExecutedSearches[searchTeam] += 1;
+		}
+		#endif
+
+		finalized.clear();
+		finalized.resize(members.size(), false);
+
+		PathSearch groupSearch(PATH_SEARCH_DIJKSTRA);
+
+		const unsigned int numFinalized = groupSearch.ExecuteGroup(members, paths, finalized, searchStateOffset, numTerrainChanges);
+
+		searchStateOffset += NODE_STATE_OFFSET;
+		numExpandedSearchNodes += groupSearch.GetNumExpandedNodes();
+
+		if (numFinalized == 0)
+			continue;
+
+		for (size_t k = 0; k < members.size(); k++) {
+			if (!finalized[k])
+				continue;
+
+			#ifdef QTPFS_SEARCH_SHARED_PATHS
+			sharedPaths[paths[k]->GetHash()] = paths[k];
+			#endif
+
+			delete searches[memberIdcs[k]];
+			searches[memberIdcs[k]] = nullptr;
+		}
+
+		haveFinalized = true;
+	}
+
+	// members that were not reached stay queued for an individual search
+	if (haveFinalized) {
+		searches.erase(std::remove(searches.begin(), searches.end(), nullptr), searches.end());
+	}
+}
+
 void QTPFS::PathManager::QueueDeadPathSearches(unsigned int pathType) {
 	PathCache& pathCache = pathCaches[pathType];
 	PathCache::PathMap::const_iterator deadPathsIt;
@@ -853,13 +1070,156 @@ void QTPFS::PathManager::QueueDeadPathSearches(unsigned int pathType) {
 		// re-request LIVE paths that were marked as DEAD by a TerrainChange
 		// for each of these now-dead paths, reset the active point-idx to 0
 		for (deadPathsIt = deadPaths.begin(); deadPathsIt != deadPaths.end(); ++deadPathsIt) {
-			QueueSearch(deadPathsIt->second, nullptr, moveDef, ZeroVector, ZeroVector, -1.0f, true);
+			const unsigned int pathID = QueueSearch(deadPathsIt->second, nullptr, moveDef, ZeroVector, ZeroVector, -1.0f, true);
+
+			#ifdef QTPFS_REPAIR_DEAD_PATHS
+			unsigned int minSegIdx = 0;
+			unsigned int maxSegIdx = 0;
+
+			// patch only the invalidated span instead of searching the whole path again
+			if (pathCache.GetDeadPathSpan(deadPathsIt->first, minSegIdx, maxSegIdx))
+				QueuePathRepair(deadPathsIt->second, pathCache.GetTempPath(pathID), minSegIdx, maxSegIdx, pathType);
+			#endif
 		}
 
 		pathCache.KillDeadPaths();
 	}
 }
 
+void QTPFS::PathManager::QueuePathRepair(const IPath* deadPath, IPath* tempPath, unsigned int minSegIdx, unsigned int maxSegIdx, unsigned int pathType) {
+	assert(tempPath->GetID() == deadPath->GetID());
+	assert(minSegIdx <= maxSegIdx);
+
+	const std::vector<float3>& points = deadPath->GetPoints();
+
+	const unsigned int nxtPointIdx = deadPath->GetNextPointIndex();
+	const unsigned int tgtPointIdx = std::min(maxSegIdx + 1, deadPath->NumPoints() - 1);
+
+	PathRepair& repair = pathRepairs[pathType][tempPath->GetID()];
+
+	repair.prefix.clear();
+	repair.suffix.assign(points.begin() + tgtPointIdx + 1, points.end());
+
+	repair.sourcePoint = tempPath->GetSourcePoint();
+	repair.targetPoint = tempPath->GetTargetPoint();
+	repair.nextPointIndex = 0;
+
+	// if the span starts behind the owner (ie. it is already traversing an
+	// invalidated segment) the repair starts from its current position and
+	// the visited waypoints are dropped, as they would be by a re-search
+	if (minSegIdx >= nxtPointIdx) {
+		repair.prefix.assign(points.begin(), points.begin() + minSegIdx);
+		repair.nextPointIndex = nxtPointIdx;
+
+		tempPath->SetSourcePoint(points[minSegIdx]);
+	}
+
+	tempPath->SetTargetPoint(points[tgtPointIdx]);
+
+	float3 mins = tempPath->GetSourcePoint();
+	float3 maxs = tempPath->GetSourcePoint();
+
+	for (unsigned int i = minSegIdx; i <= tgtPointIdx; i++) {
+		mins = float3::min(mins, points[i]);
+		maxs = float3::max(maxs, points[i]);
+	}
+
+	repair.searchRect.x1 = std::max(int(mins.x / SQUARE_SIZE) - QTPFS_REPAIR_SEARCH_MARGIN, 0);
+	repair.searchRect.z1 = std::max(int(mins.z / SQUARE_SIZE) - QTPFS_REPAIR_SEARCH_MARGIN, 0);
+	repair.searchRect.x2 = std::min(int(maxs.x / SQUARE_SIZE) + QTPFS_REPAIR_SEARCH_MARGIN, mapDims.mapx);
+	repair.searchRect.z2 = std::min(int(maxs.z / SQUARE_SIZE) + QTPFS_REPAIR_SEARCH_MARGIN, mapDims.mapy);
+}
+
+void QTPFS::PathManager::CancelPathRepairs(const SRectangle& r, unsigned int pathType) {
+	#ifdef QTPFS_REPAIR_DEAD_PATHS
+	PathCache& pathCache = pathCaches[pathType];
+	PathRepairMap& repairs = pathRepairs[pathType];
+
+	// the waypoints kept by a queued repair are not in the live-cache, so a
+	// change crossing them would go unnoticed; turn those into re-searches
+	for (auto it = repairs.begin(); it != repairs.end(); ) {
+		const PathRepair& repair = it->second;
+
+		float3 mins = { 1e6f, 0.0f,  1e6f};
+		float3 maxs = {-1e6f, 0.0f, -1e6f};
+
+		for (unsigned int i = repair.nextPointIndex; i < repair.prefix.size(); i++) {
+			mins = float3::min(mins, repair.prefix[i]);
+			maxs = float3::max(maxs, repair.prefix[i]);
+		}
+		for (const float3& p: repair.suffix) {
+			mins = float3::min(mins, p);
+			maxs = float3::max(maxs, p);
+		}
+
+		const bool overlap =
+			((r.x2 * SQUARE_SIZE) >= mins.x && (r.x1 * SQUARE_SIZE) <= maxs.x) &&
+			((r.z2 * SQUARE_SIZE) >= mins.z && (r.z1 * SQUARE_SIZE) <= maxs.z);
+
+		if (!overlap) {
+			++it;
+			continue;
+		}
+
+		IPath* path = pathCache.GetTempPath(it->first);
+
+		path->SetNextPointIndex(0);
+		path->AllocPoints(2);
+		path->SetSourcePoint(repair.sourcePoint);
+		path->SetTargetPoint(repair.targetPoint);
+
+		it = repairs.erase(it);
+	}
+	#endif
+}
+
+bool QTPFS::PathManager::ExecuteRepairSearch(IPathSearch* search, IPath* path, NodeLayer& nodeLayer, PathCache& pathCache, unsigned int pathType) {
+	const auto repairIt = pathRepairs[pathType].find(path->GetID());
+	const PathRepair& repair = repairIt->second;
+
+	// QueueSearch only ever creates PathSearch instances
+	PathSearch* repairSearch = static_cast<PathSearch*>(search);
+
+	repairSearch->Initialize(&nodeLayer, &pathCache, path->GetSourcePoint(), path->GetTargetPoint(), repair.searchRect);
+
+	// a partial result would leave a gap between the patch and the suffix
+	if (repairSearch->Execute(searchStateOffset, numTerrainChanges) && repairSearch->HaveFullPath()) {
+		repairSearch->Finalize(path);
+
+		std::vector<float3> points;
+		points.reserve(repair.prefix.size() + path->NumPoints() + repair.suffix.size());
+		points.insert(points.end(), repair.prefix.begin(), repair.prefix.end());
+		points.insert(points.end(), path->GetPoints().begin(), path->GetPoints().end());
+		points.insert(points.end(), repair.suffix.begin(), repair.suffix.end());
+
+		path->AllocPoints(points.size());
+
+		for (unsigned int i = 0; i < points.size(); i++) {
+			path->SetPoint(i, points[i]);
+		}
+
+		path->SetNextPointIndex(repair.nextPointIndex);
+		path->SetBoundingBox();
+
+		pathRepairs[pathType].erase(repairIt);
+		return true;
+	}
+
+	// fall back to a full re-search from the owner's current position
+	searchStateOffset += NODE_STATE_OFFSET;
+
+	path->SetNextPointIndex(0);
+	path->AllocPoints(2);
+	path->SetSourcePoint(repair.sourcePoint);
+	path->SetTargetPoint(repair.targetPoint);
+
+	search->Initialize(&nodeLayer, &pathCache, path->GetSourcePoint(), path->GetTargetPoint(), MAP_RECTANGLE);
+	path->SetHash(search->GetHash(mapDims.mapx * mapDims.mapy, pathType));
+
+	pathRepairs[pathType].erase(repairIt);
+	return false;
+}
+
 unsigned int QTPFS::PathManager::QueueSearch(
 	const IPath* oldPath,
 	const CSolidObject* object,
@@ -930,6 +1290,20 @@ unsigned int QTPFS::PathManager::QueueSearch(
 		newSearch->SetTeam((object != nullptr)? object->team: teamHandler.ActiveTeams());
 	}
 
+	{
+		// see QTPFS_SEARCH_PRIORITY_*; a re-search keeps its owner going, other
+		// requests are ranked by who issued them and the distance to cover
+		unsigned int searchClass = SEARCH_PRIORITY_REPATH;
+
+		if (oldPath == nullptr)
+			searchClass = (object != nullptr && skirmishAIHandler.HasSkirmishAIsInTeam(object->team))? SEARCH_PRIORITY_AI: SEARCH_PRIORITY_PLAYER;
+
+		const float3 searchDir = newPath->GetTargetPoint() - newPath->GetSourcePoint();
+		const unsigned int searchDist = searchDir.Length2D() / SQUARE_SIZE;
+
+		newSearch->SetPriority(std::max(gs->frameNum, 0) + searchClass * QTPFS_SEARCH_PRIORITY_CLASS_FRAMES + searchDist / QTPFS_SEARCH_PRIORITY_DIST_SQUARES);
+	}
+
 	assert((pathCaches[moveDef->pathType].GetTempPath(newPath->GetID()))->GetID() == 0);
 
 	// map the path-ID to the index of the cache that stores it
@@ -963,6 +1337,7 @@ void QTPFS::PathManager::DeletePath(unsigned int pathID) {
 		PathCache& pathCache = pathCaches[pathTypeIt->second];
 		pathCache.DelPath(pathID);
 
+		pathRepairs[pathTypeIt->second].erase(pathID);
 		pathTypes.erase(pathTypeIt);
 	}
 
@@ -9,10 +9,10 @@
 #include "NodeLayer.hpp"
 #include "PathCache.hpp"
 #include "PathSearch.hpp"
+#include "System/Rectangle.h"
 #include "System/UnorderedMap.hpp"
 
 struct MoveDef;
-struct SRectangle;
 class CSolidObject;
 
 #ifdef QTPFS_ENABLE_THREADED_UPDATE
@@ -122,8 +122,14 @@ namespace QTPFS {
 		#endif
 
 		void ExecuteQueuedSearches(unsigned int pathType);
+		void ExecuteGroupSearches(unsigned int pathType);
+		void SortQueuedSearches(unsigned int pathType);
 		void QueueDeadPathSearches(unsigned int pathType);
 
+		void QueuePathRepair(const IPath* deadPath, IPath* tempPath, unsigned int minSegIdx, unsigned int maxSegIdx, unsigned int pathType);
+		void CancelPathRepairs(const SRectangle& r, unsigned int pathType);
+		bool ExecuteRepairSearch(IPathSearch* search, IPath* path, NodeLayer& nodeLayer, PathCache& pathCache, unsigned int pathType);
+
 		unsigned int QueueSearch(
 			const IPath* oldPath,
 			const CSolidObject* object,
@@ -159,6 +165,27 @@ namespace QTPFS {
 		// maps "hashes" of executed searches to the found paths
 		spring::unordered_map<std::uint64_t, IPath*> sharedPaths;
 
+		// a dead path being repaired is searched only between the waypoints
+		// bounding its invalidated span; the result is spliced in between
+		// the untouched <prefix> and <suffix> waypoints
+		struct PathRepair {
+			std::vector<float3> prefix;
+			std::vector<float3> suffix;
+
+			SRectangle searchRect;
+
+			// end-points of the full re-search used if the repair fails
+			float3 sourcePoint;
+			float3 targetPoint;
+
+			unsigned int nextPointIndex;
+		};
+
+		typedef spring::unordered_map<unsigned int, PathRepair> PathRepairMap;
+
+		// per path-type, so layers updated concurrently never share a map
+		std::vector<PathRepairMap> pathRepairs;
+
 		std::vector<unsigned int> numCurrExecutedSearches;
 		std::vector<unsigned int> numPrevExecutedSearches;
 
@@ -169,6 +196,8 @@ namespace QTPFS {
 		unsigned int numTerrainChanges;
 		unsigned int numPathRequests;
 		unsigned int maxNumLeafNodes;
+		// nodes expanded by the searches of the layer being updated
+		unsigned int numExpandedSearchNodes;
 
 		std::uint32_t pfsCheckSum;
 
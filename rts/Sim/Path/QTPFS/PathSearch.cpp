@@ -1,5 +1,6 @@
 /* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
 
+#include <algorithm>
 #include <cassert>
 #include <limits>
 
@@ -16,6 +17,7 @@
 #include "System/float3.h"
 
 QTPFS::binary_heap<QTPFS::INode*> QTPFS::PathSearch::openNodes;
+std::vector<QTPFS::INode*> QTPFS::PathSearch::pathNodes;
 
 
 
@@ -155,6 +157,7 @@ void QTPFS::PathSearch::UpdateNode(INode* nextNode, INode* prevNode, unsigned in
 void QTPFS::PathSearch::IterateNodes(const std::vector<INode*>& allNodes) {
 	curNode = openNodes.top();
 	curNode->SetSearchState(searchState | NODE_STATE_CLOSED);
+	numExpandedNodes += 1;
 	#ifdef QTPFS_CONSERVATIVE_NEIGHBOR_CACHE_UPDATES
 	// in the non-conservative case, this is done from
 	// NodeLayer::ExecNodeNeighborCacheUpdates instead
@@ -214,6 +217,8 @@ void QTPFS::PathSearch::IterateNodeNeighbors(const std::vector<INode*>& nxtNodes
 
 		if (nxtNode->AllSquaresImpassable())
 			continue;
+		if (useRegionCorridor && !nodeLayer->InRegionCorridor(nxtNode))
+			continue;
 
 		const bool isCurrent = (nxtNode->GetSearchState() >= searchState);
 		const bool isClosed = ((nxtNode->GetSearchState() & 1) == NODE_STATE_CLOSED);
@@ -362,32 +367,33 @@ void QTPFS::PathSearch::TracePath(IPath* path) {
 	path->SetTargetPoint(tgtPoint);
 }
 
-void QTPFS::PathSearch::SmoothPath(IPath* path) const {
+void QTPFS::PathSearch::SmoothPath(IPath* path) {
 	if (path->NumPoints() == 2)
 		return;
 
 	assert(srcNode->GetPrevNode() == NULL);
 
+	pathNodes.clear();
+	pathNodes.push_back(tgtNode);
+
+	while (pathNodes.back() != srcNode) {
+		pathNodes.push_back(pathNodes.back()->GetPrevNode());
+	}
+
 	for (unsigned int k = 0; k < QTPFS_MAX_SMOOTHING_ITERATIONS; k++) {
-		if (!SmoothPathIter(path)) {
+		if (!SmoothPathIter(path, pathNodes)) {
 			// all waypoints stopped moving
 			break;
 		}
 	}
 
-	INode* n0 = tgtNode;
-	INode* n1 = tgtNode;
-
-	while (n1 != srcNode) {
-		n0 = n1;
-		n1 = n0->GetPrevNode();
-
-		// reset back-pointers
-		n0->SetPrevNode(NULL);
+	// reset back-pointers
+	for (INode* n: pathNodes) {
+		n->SetPrevNode(NULL);
 	}
 }
 
-bool QTPFS::PathSearch::SmoothPathIter(IPath* path) const {
+bool QTPFS::PathSearch::SmoothPathIter(IPath* path, const std::vector<INode*>& nodes) const {
 	// smooth in reverse order (target to source)
 	//
 	// should terminate when waypoints stop moving,
@@ -395,12 +401,9 @@ bool QTPFS::PathSearch::SmoothPathIter(IPath* path) const {
 	unsigned int ni = path->NumPoints();
 	unsigned int nm = 0;
 
-	INode* n0 = tgtNode;
-	INode* n1 = tgtNode;
-
-	while (n1 != srcNode) {
-		n0 = n1;
-		n1 = n0->GetPrevNode();
+	for (size_t k = 1; k < nodes.size(); k++) {
+		INode* n0 = nodes[k - 1];
+		INode* n1 = nodes[k    ];
 		ni -= 1;
 
 		assert(n1->GetNeighborRelation(n0) != 0);
@@ -538,6 +541,150 @@ bool QTPFS::PathSearch::SmoothPathIter(IPath* path) const {
 
 
 
+unsigned int QTPFS::PathSearch::ExecuteGroup(
+	const std::vector<PathSearch*>& members,
+	const std::vector<IPath*>& paths,
+	std::vector<bool>& finalized,
+	unsigned int searchStateOffset,
+	unsigned int searchMagicNumber
+) {
+	assert(searchType == PATH_SEARCH_DIJKSTRA);
+	assert(!members.empty());
+	assert(members.size() == paths.size());
+
+	const PathSearch* leader = members[0];
+
+	// search outward from the shared target; the (per-member) source nodes
+	// are what we need to reach, so there is no single node to aim for and
+	// the search only stops once all of them have been closed
+	nodeLayer = leader->nodeLayer;
+	pathCache = leader->pathCache;
+
+	searchRect = leader->searchRect;
+	searchExec = nullptr;
+
+	srcPoint = leader->tgtPoint;
+	tgtPoint = leader->tgtPoint;
+
+	srcNode = leader->tgtNode;
+	tgtNode = nullptr;
+	curNode = nullptr;
+	nxtNode = nullptr;
+	minNode = srcNode;
+
+	searchState = searchStateOffset;
+	searchMagic = searchMagicNumber;
+	hCostMult = 0.0f;
+
+	// source nodes not yet reached, kept sorted for binary searches; those
+	// the search can never close are left out, otherwise a single member
+	// stuck on an island would make it flood everything else that is open
+	std::vector<const INode*> openMemberNodes;
+	openMemberNodes.reserve(members.size());
+
+	nodeLayer->MarkReachableRegions(srcPoint);
+
+	for (const PathSearch* member: members) {
+		assert(member->tgtNode == srcNode);
+
+		if (member->srcNode->AllSquaresImpassable())
+			continue;
+		if (!nodeLayer->IsReachableRegion(member->srcPoint))
+			continue;
+
+		openMemberNodes.push_back(member->srcNode);
+	}
+
+	std::sort(openMemberNodes.begin(), openMemberNodes.end());
+
+	// see Execute
+	if (srcNode->GetMoveCost() == QTPFS_POSITIVE_INFINITY)
+		srcNode->SetMoveCost(0.0f);
+
+	ResetState(srcNode);
+	UpdateNode(srcNode, nullptr, 0);
+
+	while (!openNodes.empty() && !openMemberNodes.empty()) {
+		IterateNodes(nodeLayer->GetNodes());
+
+		const auto range = std::equal_range(openMemberNodes.begin(), openMemberNodes.end(), curNode);
+		openMemberNodes.erase(range.first, range.second);
+	}
+
+	openNodes.reset();
+
+	if (srcNode->GetMoveCost() == 0.0f)
+		srcNode->SetMoveCost(QTPFS_POSITIVE_INFINITY);
+
+	unsigned int numFinalized = 0;
+
+	for (size_t i = 0; i < members.size(); i++) {
+		const INode* memberNode = members[i]->srcNode;
+
+		// any node touched by this search has a chain of back-pointers to the root
+		if (memberNode->GetSearchState() < searchState)
+			continue;
+
+		TraceGroupPath(members[i], paths[i]);
+
+		paths[i]->SetBoundingBox();
+		pathCache->AddLivePath(paths[i]);
+
+		finalized[i] = true;
+		numFinalized += 1;
+	}
+
+	// reset back-pointers only after all members traced their (shared) chains
+	for (const PathSearch* member: members) {
+		for (INode* n = member->srcNode; n != nullptr; ) {
+			INode* p = n->GetPrevNode();
+			n->SetPrevNode(nullptr);
+			n = p;
+		}
+	}
+
+	return numFinalized;
+}
+
+void QTPFS::PathSearch::TraceGroupPath(const PathSearch* member, IPath* path) {
+	// back-pointers lead from the member's source toward our root (its target)
+	pathNodes.clear();
+
+	for (INode* n = member->srcNode; n != srcNode; n = n->GetPrevNode()) {
+		assert(n != nullptr);
+		pathNodes.push_back(n);
+	}
+
+	path->AllocPoints(pathNodes.size() + 2);
+
+	// set waypoints with indices [1, N - 2] (if any)
+	for (size_t i = 0; i < pathNodes.size(); i++) {
+		const float2& p = pathNodes[i]->GetNeighborEdgeTransitionPoint(0);
+
+		assert(!math::isinf(p.x) && !math::isinf(p.y));
+		assert(!math::isnan(p.x) && !math::isnan(p.y));
+		path->SetPoint(i + 1, {p.x, 0.0f, p.y});
+	}
+
+	path->SetSourcePoint(member->srcPoint);
+	path->SetTargetPoint(member->tgtPoint);
+
+	#ifdef QTPFS_SMOOTH_PATHS
+	if (path->NumPoints() > 2) {
+		// SmoothPathIter expects nodes in target-to-source order
+		pathNodes.push_back(srcNode);
+		std::reverse(pathNodes.begin(), pathNodes.end());
+
+		for (unsigned int k = 0; k < QTPFS_MAX_SMOOTHING_ITERATIONS; k++) {
+			if (!SmoothPathIter(path, pathNodes))
+				break;
+		}
+	}
+	#endif
+}
+
+
+
 bool QTPFS::PathSearch::SharedFinalize(const IPath* srcPath, IPath* dstPath) {
 	assert(dstPath->GetID() != 0);
 	assert(dstPath->GetID() != srcPath->GetID());
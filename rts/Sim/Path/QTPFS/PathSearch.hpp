@@ -78,6 +78,7 @@ namespace QTPFS {
 		IPathSearch(unsigned int pathSearchType)
 			: searchID(0)
 			, searchTeam(0)
+			, searchPriority(0)
 			, searchType(pathSearchType)
 			, searchState(0)
 			, searchMagic(0)
@@ -103,16 +104,22 @@ namespace QTPFS {
 
 		void SetID(unsigned int n) { searchID = n; }
 		void SetTeam(unsigned int n) { searchTeam = n; }
+		void SetPriority(unsigned int n) { searchPriority = n; }
 		unsigned int GetID() const { return searchID; }
 		unsigned int GetTeam() const { return searchTeam; }
+		unsigned int GetPriority() const { return searchPriority; }
+
+		// number of nodes expanded over all executions of this search
+		virtual unsigned int GetNumExpandedNodes() const { return 0; }
 
 	protected:
-		unsigned int searchID;     // links us to the temp-path that this search will finalize
-		unsigned int searchTeam;   // which team queued this search
+		unsigned int searchID;       // links us to the temp-path that this search will finalize
+		unsigned int searchTeam;     // which team queued this search
+		unsigned int searchPriority; // sim-frame by which the search should run, lower runs first
 
-		unsigned int searchType;   // indicates if Dijkstra (h==0) or A* (h!=0) search is employed
-		unsigned int searchState;  // offset that identifies nodes as part of current search
-		unsigned int searchMagic;  // used to signal nodes they should update their neighbor-set
+		unsigned int searchType;     // indicates if Dijkstra (h==0) or A* (h!=0) search is employed
+		unsigned int searchState;    // offset that identifies nodes as part of current search
+		unsigned int searchMagic;    // used to signal nodes they should update their neighbor-set
 	};
 
 
@@ -129,8 +136,10 @@ namespace QTPFS {
 			, nxtNode(NULL)
 			, minNode(NULL)
 			, hCostMult(0.0f)
+			, numExpandedNodes(0)
 			, haveFullPath(false)
 			, havePartPath(false)
+			, useRegionCorridor(false)
 			{}
 		~PathSearch() { openNodes.reset(); }
 
@@ -148,6 +157,29 @@ namespace QTPFS {
 		void Finalize(IPath* path);
 		bool SharedFinalize(const IPath* srcPath, IPath* dstPath);
 		PathSearchTrace::Execution* GetExecutionTrace() { return searchExec; }
+		unsigned int GetNumExpandedNodes() const { return numExpandedNodes; }
+
+		// runs a single Dijkstra search rooted at the target node common to
+		// all (initialized) <members>; the resulting tree of back-pointers
+		// leads from every reached source node to the target, so each such
+		// member can trace its path without a search of its own; members the
+		// region graph rules out are not waited for (see MarkReachableRegions)
+		// sets <finalized[i]> for every members[i] whose paths[i] was added
+		// to the live-cache, returns the number of those
+		unsigned int ExecuteGroup(
+			const std::vector<PathSearch*>& members,
+			const std::vector<IPath*>& paths,
+			std::vector<bool>& finalized,
+			unsigned int searchStateOffset,
+			unsigned int searchMagicNumber
+		);
+
+		// restricts Execute to the nodes within the layer's current region-corridor
+		void SetUseRegionCorridor(bool b) { useRegionCorridor = b; }
+		bool HaveFullPath() const { return haveFullPath; }
+
+		const INode* GetSourceNode() const { return srcNode; }
+		const INode* GetTargetNode() const { return tgtNode; }
 
 		const std::uint64_t GetHash(std::uint64_t N, std::uint32_t k) const;
 
@@ -162,12 +194,15 @@ namespace QTPFS {
 		void IterateNodeNeighbors(const std::vector<INode*>& nxtNodes);
 
 		void TracePath(IPath* path);
-		void SmoothPath(IPath* path) const;
-		bool SmoothPathIter(IPath* path) const;
+		void TraceGroupPath(const PathSearch* member, IPath* path);
+		void SmoothPath(IPath* path);
+		bool SmoothPathIter(IPath* path, const std::vector<INode*>& nodes) const;
 
 		// global queue: allocated once, re-used by all searches without clear()'s
 		// this relies on INode::operator< to sort the INode*'s by increasing f-cost
 		static binary_heap<INode*> openNodes;
+		// nodes of the path being smoothed, in target-to-source order
+		static std::vector<INode*> pathNodes;
 
 		NodeLayer* nodeLayer;
 		PathCache* pathCache;
@@ -194,8 +229,11 @@ namespace QTPFS {
 
 		float hCostMult;
 
+		unsigned int numExpandedNodes;
+
 		bool haveFullPath;
 		bool havePartPath;
+		bool useRegionCorridor;
 	};
 }
 
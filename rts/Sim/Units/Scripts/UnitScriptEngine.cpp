@@ -122,7 +122,12 @@ void CUnitScriptEngine::Tick(int deltaTime)
 	for (size_t i = 0; i < animating.size(); ) {
 		currentScript = animating[i];
 
-		if (!currentScript->Tick(deltaTime)) {
+		const bool keepAnimating = currentScript->Tick(deltaTime);
+
+		// refit here so that hit-tests later this frame can cull pieces
+		currentScript->GetUnit()->localModel.UpdatePieceBounds();
+
+		if (!keepAnimating) {
 			animating[i] = animating.back();
 			animating.pop_back();
 			continue;
@@ -2,6 +2,7 @@
 
 #include <stdio.h>
 #include <algorithm>
+#include <cassert>
 #include <iostream>
 #include <locale>
 #include <cctype>
@@ -42,12 +43,45 @@ void CUnitDefHandler::Init(LuaParser* defsParser)
 	unitDefsVector.reserve(unitDefNames.size() + 1);
 	unitDefsVector.emplace_back();
 
+	std::vector<ParsedUnitDef> parsedDefs(unitDefNames.size());
+	std::vector<std::string> reparseNames;
+	std::vector<size_t> reparseIndices;
+
+	// parse the unitdef data (but don't load buildpics, etc...); this only
+	// depends on each def's own table and runs concurrently where possible
+	ParseDefTables(defsParser, "UnitDefs", unitDefNames, [&](const LuaTable& udTable, size_t i) {
+		ParseUnitDef(parsedDefs[i], udTable, StringToLower(unitDefNames[i]));
+	});
+
+	// category bits are handed out in order of first use, so register them
+	// by replaying each def's queries in ID order (as a serial parse would)
+	for (const ParsedUnitDef& parsedDef: parsedDefs) {
+		CCategoryHandler::Instance()->ReplayQueryLog(parsedDef.categoryLog);
+	}
+
+	// defs which queried a category before it existed saw 0 for its bits
+	for (size_t i = 0; i < parsedDefs.size(); i++) {
+		if (!parsedDefs[i].error.empty() || !parsedDefs[i].categoryLog.incomplete)
+			continue;
+
+		reparseNames.push_back(unitDefNames[i]);
+		reparseIndices.push_back(i);
+	}
+
+	ParseDefTables(defsParser, "UnitDefs", reparseNames, [&](const LuaTable& udTable, size_t j) {
+		ParsedUnitDef& parsedDef = parsedDefs[reparseIndices[j]];
+
+		parsedDef.categoryLog = {};
+		ParseUnitDef(parsedDef, udTable, StringToLower(reparseNames[j]));
+		assert(!parsedDef.categoryLog.incomplete);
+	});
+
+	// assign IDs, load sounds, etc. serially
 	for (unsigned int a = 0; a < unitDefNames.size(); ++a) {
 		const string& unitName = unitDefNames[a];
 		const LuaTable& udTable = rootTable.SubTable(unitName);
 
-		// parse the unitdef data (but don't load buildpics, etc...)
-		PushNewUnitDef(StringToLower(unitName), udTable);
+		PushNewUnitDef(StringToLower(unitName), udTable, parsedDefs[a]);
 	}
 
 	CleanBuildOptions();
@@ -56,7 +90,21 @@ void CUnitDefHandler::Init(LuaParser* defsParser)
 
 
 
-int CUnitDefHandler::PushNewUnitDef(const std::string& unitName, const LuaTable& udTable)
+void CUnitDefHandler::ParseUnitDef(ParsedUnitDef& parsedDef, const LuaTable& udTable, const std::string& unitName)
+{
+	CCategoryHandler::SetThreadQueryLog(&parsedDef.categoryLog);
+
+	try {
+		// the real ID is assigned by PushNewUnitDef
+		parsedDef.def = UnitDef(udTable, unitName, 0);
+	} catch (const content_error& err) {
+		parsedDef.error = err.what();
+	}
+
+	CCategoryHandler::SetThreadQueryLog(nullptr);
+}
+
+int CUnitDefHandler::PushNewUnitDef(const std::string& unitName, const LuaTable& udTable, ParsedUnitDef& parsedDef)
 {
 	if (std::find_if(unitName.begin(), unitName.end(), isblank) != unitName.end())
 		LOG_L(L_WARNING, "[%s] UnitDef name \"%s\" contains white-spaces", __func__, unitName.c_str());
@@ -64,8 +112,12 @@ int CUnitDefHandler::PushNewUnitDef(const std::string& unitName, const LuaTable&
 	const int defID = unitDefsVector.size();
 
 	try {
-		unitDefsVector.emplace_back(udTable, unitName, defID);
+		if (!parsedDef.error.empty())
+			throw content_error(parsedDef.error);
+
+		unitDefsVector.emplace_back(std::move(parsedDef.def));
 		UnitDef& newDef = unitDefsVector.back();
+		newDef.id = defID;
 		UnitDefLoadSounds(&newDef, udTable);
 
 		// map unitName to newDef.decoyName
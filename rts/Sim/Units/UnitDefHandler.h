@@ -7,6 +7,7 @@
 #include <vector>
 
 #include "UnitDef.h"
+#include "Sim/Misc/CategoryHandler.h"
 #include "Sim/Misc/CommonDefHandler.h"
 #include "System/UnorderedMap.hpp"
 
@@ -52,7 +53,14 @@ public:
 	// id=0 is not a valid UnitDef, hence the -1
 	unsigned int NumUnitDefs() const { return (unitDefsVector.size() - 1); }
 
-	int PushNewUnitDef(const std::string& unitName, const LuaTable& udTable);
+	struct ParsedUnitDef {
+		UnitDef def;
+		CCategoryHandler::QueryLog categoryLog;
+		std::string error;
+	};
+
+	void ParseUnitDef(ParsedUnitDef& parsedDef, const LuaTable& udTable, const std::string& unitName);
+	int PushNewUnitDef(const std::string& unitName, const LuaTable& udTable, ParsedUnitDef& parsedDef);
 
 	const std::vector<UnitDef>& GetUnitDefsVec() const { return unitDefsVector; }
 	const spring::unordered_map<std::string, int>& GetUnitDefIDs() const { return unitDefIDs; }
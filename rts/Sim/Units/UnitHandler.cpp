@@ -13,7 +13,9 @@
 #include "CommandAI/BuilderCAI.h"
 #include "Sim/Misc/GlobalSynced.h"
 #include "Sim/Misc/ModInfo.h"
+#include "Sim/Misc/QuadField.h"
 #include "Sim/Misc/TeamHandler.h"
+#include "Sim/Misc/UnitBroadphase.h"
 #include "Sim/MoveTypes/MoveType.h"
 #include "Sim/Path/IPathManager.h"
 #include "Sim/Weapons/Weapon.h"
@@ -319,6 +321,9 @@ void CUnitHandler::UpdateUnitMoveTypes()
 			moveType->UpdatePreCollisions();
 		}
 	} else {
+		// positions are fixed until stage 2, so avoidance can use a snapshot
+		unitBroadphase.Build(activeUnits);
+
 		{
 		SCOPED_TIMER("Sim::Unit::MoveType::1::UpdatePreCollisionsMT");
 		for_mt(0, activeUnits.size(), [this](const int i){
@@ -332,6 +337,8 @@ void CUnitHandler::UpdateUnitMoveTypes()
 		});
 		}
 
+		unitBroadphase.Clear();
+
 		{
 		SCOPED_TIMER("Sim::Unit::MoveType::2::UpdatePreCollisionsST");
 		std::size_t len = activeUnits.size();
@@ -344,6 +351,9 @@ void CUnitHandler::UpdateUnitMoveTypes()
 		}
 	}
 
+	// collision handling only accumulates forces, positions do not change
+	unitBroadphase.Build(activeUnits);
+
 	if (modInfo.forceCollisionsSingleThreaded) {
 		{
 		SCOPED_TIMER("Sim::Unit::MoveType::3::CollisionDetectionST");
@@ -367,6 +377,8 @@ void CUnitHandler::UpdateUnitMoveTypes()
 		}
 	}
 
+	unitBroadphase.Clear();
+
 	{
 	// SCOPED_TIMER("Sim::Unit::MoveType::4::ProcessCollisionEvents");
 	for (activeUpdateUnit = 0; activeUpdateUnit < activeUnits.size(); ++activeUpdateUnit) {
@@ -386,6 +398,11 @@ void CUnitHandler::UpdateUnitMoveTypes()
 		if (moveType->Update())
 			eventHandler.UnitMoved(unit);
 
+		// wake up parked units around anything that moved this frame, one
+		// frame late since their collision detection already ran (stage 3)
+		if (unit->pos != unit->preFramePos || unit->speed.w != 0.0f)
+			quadField.MarkActivity(unit->pos, unit->radius, gs->frameNum);
+
 		// this unit is not coming back, kill it now without any death
 		// sequence (s.t. deathScriptFinished becomes true immediately)
 		if (!unit->pos.IsInBounds() && (unit->speed.w > MAX_UNIT_SPEED))
@@ -543,6 +560,8 @@ void CUnitHandler::UpdateUnits()
 		unit->moveType->UpdateCollisionMap();
 		// unsynced; done on-demand when drawing unit
 		// unit->UpdateLocalModel();
+		// synced; picks up pieces moved outside of animation ticks
+		unit->localModel.UpdatePieceBounds();
 		unit->SanityCheck();
 
 		assert(activeUnits[i] == unit);
@@ -376,9 +376,8 @@ WeaponDef::WeaponDef(const LuaTable& wdTable, const std::string& name_, int id_)
 			damages.paralyzeDamageTime = 0;
 
 
-		static std::vector<std::pair<std::string, float>> dmgs;
+		std::vector<std::pair<std::string, float>> dmgs;
 
-		dmgs.clear();
 		dmgs.reserve(32);
 		dmgTable.GetPairs(dmgs);
 
@@ -500,8 +499,6 @@ WeaponDef::WeaponDef(const LuaTable& wdTable, const std::string& name_, int id_)
 		interceptedByShieldType = wdTable.GetInt("interceptedByShieldType", defInterceptType);
 	}
 
-	ParseWeaponSounds(wdTable);
-
 	// custom parameters table
 	wdTable.SubTable("customParams").GetMap(customParams);
 
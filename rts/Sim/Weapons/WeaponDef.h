@@ -21,6 +21,9 @@ public:
 	WeaponDef();
 	WeaponDef(const LuaTable& wdTable, const std::string& name, int id);
 
+	// called by the handler after construction, sound-sets must be added in ID order
+	void ParseWeaponSounds(const LuaTable& wdTable);
+
 	S3DModel* LoadModel();
 	S3DModel* LoadModel() const;
 	void PreloadModel() const;
@@ -273,7 +276,6 @@ public:
 	Visuals visuals;
 
 private:
-	void ParseWeaponSounds(const LuaTable& wdTable);
 	void LoadSound(const LuaTable& wdTable, const std::string& soundKey, GuiSoundSet& soundSet);
 };
 
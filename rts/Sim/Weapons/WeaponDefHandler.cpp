@@ -27,13 +27,27 @@ void CWeaponDefHandler::Init(LuaParser* defsParser)
 	std::vector<std::string> weaponNames;
 	rootTable.GetKeys(weaponNames);
 
-	weaponDefsVector.reserve(weaponNames.size());
+	std::vector<std::string> parseErrors(weaponNames.size());
+
+	weaponDefsVector.resize(weaponNames.size());
 	weaponDefIDs.reserve(weaponNames.size());
 
+	// IDs are fixed by the sorted names, only sound-sets need serial loading
+	ParseDefTables(defsParser, "WeaponDefs", weaponNames, [&](const LuaTable& wdTable, size_t wid) {
+		try {
+			weaponDefsVector[wid] = WeaponDef(wdTable, weaponNames[wid], wid);
+		} catch (const content_error& err) {
+			parseErrors[wid] = err.what();
+		}
+	});
+
 	for (int wid = 0; wid < weaponNames.size(); wid++) {
 		const std::string& name = weaponNames[wid];
-		const LuaTable wdTable = rootTable.SubTable(name);
-		weaponDefsVector.emplace_back(wdTable, name, wid);
+
+		if (!parseErrors[wid].empty())
+			throw content_error(parseErrors[wid]);
+
+		weaponDefsVector[wid].ParseWeaponSounds(rootTable.SubTable(name));
 		weaponDefIDs[name] = wid;
 	}
 }
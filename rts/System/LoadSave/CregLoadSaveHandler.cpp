@@ -1,7 +1,9 @@
 /* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
 
+#include <cstdio>
+#include <fstream>
+#include <memory>
 #include <sstream>
-#include <zlib.h>
 
 #include "ExternalAI/SkirmishAIHandler.h"
 #include "ExternalAI/EngineOutHandler.h"
@@ -28,6 +30,7 @@
 #include "Sim/Misc/QuadField.h"
 #include "Sim/Misc/CategoryHandler.h"
 #include "Sim/MoveTypes/MoveDefHandler.h"
+#include "Sim/MoveTypes/MoveMath/MoveMath.h"
 #include "Sim/Misc/TeamHandler.h"
 #include "Sim/Misc/Wind.h"
 #include "Sim/Projectiles/ProjectileHandler.h"
@@ -42,6 +45,7 @@
 #include "System/FileSystem/FileQueryFlags.h"
 #include "System/FileSystem/GZFileHandler.h"
 #include "System/Threading/ThreadPool.h"
+#include "System/creg/ChunkedStreamBuf.h"
 #include "System/creg/SerializeLuaState.h"
 #include "System/creg/Serializer.h"
 #include "System/Exceptions.h"
@@ -210,7 +214,7 @@ static void ReadString(std::istream& s, std::string& str)
 }
 
 
-static void SaveLuaState(CSplitLuaHandle* handle, creg::COutputStreamSerializer& os, std::stringstream& oss)
+static void SaveLuaState(CSplitLuaHandle* handle, creg::COutputStreamSerializer& os, std::ostream& oss)
 {
 	CLuaStateCollector lsc;
 	lsc.Read(handle);
@@ -218,7 +222,7 @@ static void SaveLuaState(CSplitLuaHandle* handle, creg::COutputStreamSerializer&
 }
 
 
-static void LoadLuaState(CSplitLuaHandle* handle, creg::CInputStreamSerializer& is, std::stringstream& iss)
+static void LoadLuaState(CSplitLuaHandle* handle, creg::CInputStreamSerializer& is, std::istream& iss)
 {
 	void* plsc;
 	creg::Class* plsccls = nullptr;
@@ -246,65 +250,57 @@ void CCregLoadSaveHandler::SaveGame(const std::string& path)
 	selectedUnitsHandler.ClearSelected();
 
 	try {
-		std::stringstream oss;
+		// written to a temporary file which only replaces <path> once complete,
+		// so a failed save can not destroy an existing one
+		const std::string filePath = dataDirsAccess.LocateFile(path, FileQueryFlags::WRITE);
+		const std::string tempPath = filePath + ".tmp";
 
-		// write our own header. SavePackage() will add its own
-		WriteString(oss, SpringVersion::GetSync());
-		WriteString(oss, gameSetup->setupText);
-		WriteString(oss, modName);
-		WriteString(oss, mapName);
+		auto ofs = std::make_unique<std::ofstream>(tempPath, std::ios::out | std::ios::binary | std::ios::trunc);
 
+		if (!ofs->is_open()) {
+			LOG_L(L_ERROR, "[LSH::%s] could not open save-file", __func__);
+			return;
+		}
 
-		{
-			creg::COutputStreamSerializer os;
-
-			// save lua state first as lua unit scripts depend on it
-			const int luaStart = oss.tellp();
-			SaveLuaState(luaGaia, os, oss);
-			SaveLuaState(luaRules, os, oss);
-			PrintSize("Lua", ((int)oss.tellp()) - luaStart);
-
-			// save creg state
-			const int gameStart = oss.tellp();
-			CGameStateCollector gsc;
-			os.SavePackage(&oss, &gsc, gsc.GetClass());
-			PrintSize("Game", ((int)oss.tellp()) - gameStart);
-
+		// state is streamed into the file as compressed chunks instead of
+		// first being collected in memory as a whole; compression and I/O
+		// already run in the background while serializing
+		auto osb = std::make_unique<creg::ChunkedOutputStreamBuf>(ofs.get());
+
+		try {
+			std::ostream oss(osb.get());
+			SaveState(oss);
+		} catch (...) {
+			osb.reset();
+			ofs.reset();
+			std::remove(tempPath.c_str());
+			throw;
+		}
 
-			// save AI state
-			const int aiStart = oss.tellp();
+		const auto finishFunc = [](std::unique_ptr<std::ofstream> ofs, std::unique_ptr<creg::ChunkedOutputStreamBuf> osb, const std::string& tempPath, const std::string& filePath) {
+			const bool finished = osb->Finish();
 
-			for (const auto& ai: skirmishAIHandler.GetAllSkirmishAIs()) {
-				std::stringstream aiData;
-				eoh->Save(&aiData, ai.first);
+			ofs->close();
 
-				std::uint64_t aiSize = aiData.tellp();
-				creg::WriteUInt(&oss, aiSize);
-				if (aiSize > 0)
-					oss << aiData.rdbuf();
+			if (!finished || ofs->fail()) {
+				LOG_L(L_ERROR, "[LSH::SaveGame] could not write save-file \"%s\"", tempPath.c_str());
+				std::remove(tempPath.c_str());
+				return;
 			}
-			PrintSize("AIs", ((int)oss.tellp()) - aiStart);
-		}
 
-		{
-			gzFile file = gzopen(dataDirsAccess.LocateFile(path, FileQueryFlags::WRITE).c_str(), "wb5");
+			std::remove(filePath.c_str());
 
-			if (file == nullptr) {
-				LOG_L(L_ERROR, "[LSH::%s] could not open save-file", __func__);
+			if (std::rename(tempPath.c_str(), filePath.c_str()) != 0) {
+				LOG_L(L_ERROR, "[LSH::SaveGame] could not rename \"%s\" to \"%s\"", tempPath.c_str(), filePath.c_str());
 				return;
 			}
 
-			std::string data = std::move(oss.str());
-			std::function<void(gzFile, std::string&&)> func = [](gzFile file, std::string&& data) {
-				gzwrite(file, data.c_str(), data.size());
-				gzflush(file, Z_FINISH);
-				gzclose(file);
-			};
+			PrintSize("Total (compressed)", int(osb->GetCompressedSize()));
+		};
 
-			// gzFile is just a plain typedef (struct gzFile_s {}* gzFile), can be copied
-			// need to keep a reference to the future around or its destructor will block
-			ThreadPool::AddExtJob(std::move(std::async(std::launch::async, std::move(func), file, std::move(data))));
-		}
+		// only the remaining chunks and the index are left, no need to wait for them
+		// need to keep a reference to the future around or its destructor will block
+		ThreadPool::AddExtJob(std::move(std::async(std::launch::async, finishFunc, std::move(ofs), std::move(osb), tempPath, filePath)));
 
 		//FIXME add lua state
 	} catch (const content_error& ex) {
@@ -323,19 +319,85 @@ void CCregLoadSaveHandler::SaveGame(const std::string& path)
 #endif //USING_CREG
 }
 
+/// writes the complete savegame contents to <oss>, throws on serialization errors
+void CCregLoadSaveHandler::SaveState(std::ostream& oss)
+{
+#ifdef USING_CREG
+	// write our own header. SavePackage() will add its own
+	WriteString(oss, SpringVersion::GetSync());
+	WriteString(oss, gameSetup->setupText);
+	WriteString(oss, modName);
+	WriteString(oss, mapName);
+
+	creg::COutputStreamSerializer os;
+
+	// save lua state first as lua unit scripts depend on it
+	const int luaStart = oss.tellp();
+	SaveLuaState(luaGaia, os, oss);
+	SaveLuaState(luaRules, os, oss);
+
+	// save creg state
+	const int gameStart = oss.tellp();
+	CGameStateCollector gsc;
+	os.SavePackage(&oss, &gsc, gsc.GetClass());
+
+	// save AI state
+	const int aiStart = oss.tellp();
+
+	for (const auto& ai: skirmishAIHandler.GetAllSkirmishAIs()) {
+		std::stringstream aiData;
+		eoh->Save(&aiData, ai.first);
+
+		std::uint64_t aiSize = aiData.tellp();
+		creg::WriteUInt(&oss, aiSize);
+		if (aiSize > 0)
+			oss << aiData.rdbuf();
+	}
+
+	PrintSize("Lua", gameStart - luaStart);
+	PrintSize("Game", aiStart - gameStart);
+	PrintSize("AIs", ((int)oss.tellp()) - aiStart);
+#endif //USING_CREG
+}
+
 /// loads the data (map&mod-name,setup-script) needed by PreGame
 bool CCregLoadSaveHandler::LoadGameStartInfo(const std::string& path)
 {
-	CGZFileHandler saveFile(dataDirsAccess.LocateFile(FindSaveFile(path)), SPRING_VFS_RAW_FIRST);
+	const std::string saveFilePath = dataDirsAccess.LocateFile(FindSaveFile(path));
 
-	std::stringbuf* sbuf = iss.rdbuf();
 	std::string saveVersion;
 	std::string syncVersion = SpringVersion::GetSync();
 
-	char buf[4096];
-	int len;
-	while ((len = saveFile.Read(buf, sizeof(buf))) > 0)
-		sbuf->sputn(buf, len);
+	saveFile.open(saveFilePath, std::ios::in | std::ios::binary);
+
+	if (saveFile.is_open() && creg::ChunkedStream::IsChunkedStream(&saveFile)) {
+		// chunks are inflated on demand while loading
+		auto* chunkBuf = new creg::ChunkedInputStreamBuf(&saveFile);
+
+		saveBuf.reset(chunkBuf);
+
+		// unlike a version mismatch this can not be overridden by LoadBadSaves
+		if (!chunkBuf->IsValid()) {
+			saveBuf.reset();
+			saveFile.close();
+			throw content_error("[LSH::LoadGameStartInfo] save-file \"" + path + "\" has a corrupt chunk index");
+		}
+	} else {
+		// legacy gzip'ed savegame, needs to be fully decompressed up-front
+		CGZFileHandler gzSaveFile(saveFilePath, SPRING_VFS_RAW_FIRST);
+
+		auto* sbuf = new std::stringbuf();
+
+		char buf[4096];
+		int len;
+		while ((len = gzSaveFile.Read(buf, sizeof(buf))) > 0)
+			sbuf->sputn(buf, len);
+
+		saveFile.close();
+		saveBuf.reset(sbuf);
+	}
+
+	iss.rdbuf(saveBuf.get());
 
 	ReadString(iss, saveVersion);
 
@@ -376,6 +438,10 @@ void CCregLoadSaveHandler::LoadGame()
 		// the only job of gsc is to collect gamestate data
 		CGameStateCollector* gsc = static_cast<CGameStateCollector*>(pGSC);
 		spring::SafeDelete(gsc);
+
+		// MoveDefs and the typemap were just restored, rasters built during
+		// MoveDefHandler::Init still reflect the state the map started with
+		CMoveMath::InitSpeedModRasters();
 	}
 
 	LEAVE_SYNCED_CODE();
@@ -404,7 +470,9 @@ void CCregLoadSaveHandler::LoadAIData()
 	}
 
 	// cleanup
-	iss.str("");
+	iss.rdbuf(nullptr);
+	saveBuf.reset();
+	saveFile.close();
 
 	gs->paused = false;
 	if (gameServer != nullptr) {
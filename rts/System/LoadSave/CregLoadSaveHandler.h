@@ -4,7 +4,10 @@
 #define CREG_LOAD_SAVE_HANDLER_H
 
 #include <string>
-#include <sstream>
+#include <fstream>
+#include <istream>
+#include <ostream>
+#include <memory>
 #include "LoadSaveHandler.h"
 
 class CCregLoadSaveHandler : public ILoadSaveHandler
@@ -19,7 +22,13 @@ public:
 	void SaveGame(const std::string& path) override;
 
 protected:
-	std::stringstream iss;
+	/// serializes the full game state into <oss>, in savegame format
+	void SaveState(std::ostream& oss);
+
+protected:
+	std::ifstream saveFile;
+	std::unique_ptr<std::streambuf> saveBuf;
+	std::istream iss{nullptr};
 };
 
 #endif // CREG_LOAD_SAVE_HANDLER_H
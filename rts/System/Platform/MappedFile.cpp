@@ -0,0 +1,94 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifdef _WIN32
+	#include "System/Platform/Win/win32.h"
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+#include "MappedFile.h"
+
+/**
+ * @brief map filePath
+ *
+ * Leaves the object closed (IsOpen() == false) if the file does not
+ * exist, is empty or can not be mapped.
+ */
+MappedFile::MappedFile(const std::string& filePath)
+{
+#ifdef _WIN32
+	HANDLE hFile = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+
+	if (hFile == INVALID_HANDLE_VALUE)
+		return;
+
+	LARGE_INTEGER fileSize;
+
+	if (!GetFileSizeEx(hFile, &fileSize) || fileSize.QuadPart <= 0) {
+		CloseHandle(hFile);
+		return;
+	}
+
+	HANDLE hMap = CreateFileMappingA(hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+	if (hMap == nullptr) {
+		CloseHandle(hFile);
+		return;
+	}
+
+	void* view = MapViewOfFile(hMap, FILE_MAP_READ, 0, 0, 0);
+
+	if (view == nullptr) {
+		CloseHandle(hMap);
+		CloseHandle(hFile);
+		return;
+	}
+
+	fileHandle = hFile;
+	mapHandle = hMap;
+	data = static_cast<const std::uint8_t*>(view);
+	size = static_cast<size_t>(fileSize.QuadPart);
+#else
+	const int fd = open(filePath.c_str(), O_RDONLY);
+
+	if (fd < 0)
+		return;
+
+	struct stat st;
+
+	if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+		close(fd);
+		return;
+	}
+
+	void* addr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+	// the mapping keeps its own reference to the file
+	close(fd);
+
+	if (addr == MAP_FAILED)
+		return;
+
+	data = static_cast<const std::uint8_t*>(addr);
+	size = static_cast<size_t>(st.st_size);
+#endif
+}
+
+/**
+ * @brief unmap
+ */
+MappedFile::~MappedFile()
+{
+	if (data == nullptr)
+		return;
+
+#ifdef _WIN32
+	UnmapViewOfFile(data);
+	CloseHandle(mapHandle);
+	CloseHandle(fileHandle);
+#else
+	munmap(const_cast<std::uint8_t*>(data), size);
+#endif
+}
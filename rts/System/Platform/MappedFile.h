@@ -0,0 +1,38 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief read-only memory mapping of a whole file
+ * Pages are faulted in on access, so only the parts actually read cost I/O.
+ */
+class MappedFile
+{
+public:
+	MappedFile(const std::string& filePath);
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator = (const MappedFile&) = delete;
+
+	bool IsOpen() const { return (data != nullptr); }
+
+	const std::uint8_t* GetData() const { return data; }
+	size_t GetSize() const { return size; }
+
+private:
+	const std::uint8_t* data = nullptr;
+	size_t size = 0;
+
+#ifdef _WIN32
+	void* fileHandle = nullptr;
+	void* mapHandle = nullptr;
+#endif
+};
+
+#endif // MAPPED_FILE_H
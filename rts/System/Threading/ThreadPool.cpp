@@ -97,7 +97,7 @@ std::atomic_uint ITaskGroup::lastId(0);
 namespace ThreadPool {
 
 int GetThreadNum() { return threadnum; }
-static void SetThreadNum(const int idx) { threadnum = idx; }
+void SetThreadNum(const int idx) { threadnum = idx; }
 
 static int GetConfigNumWorkers() {
 	#ifndef UNIT_TEST
@@ -108,7 +108,7 @@ static int GetConfigNumWorkers() {
 }
 
 static int GetDefaultNumWorkers() {
-	const int maxNumThreads = GetMaxThreads(); // min(MAX_THREADS, logicalCpus)
+	const int maxNumThreads = GetMaxThreads(); // min(RESERVED_THREAD_NUM, logicalCpus)
 	const int cfgNumWorkers = GetConfigNumWorkers();
 
 	if (cfgNumWorkers < 0) {
@@ -127,7 +127,7 @@ static int GetDefaultNumWorkers() {
 // FIXME: mutex/atomic?
 // NOTE: +1 because we also count the main thread, workers start at 1
 int GetNumThreads() { return (workerThreads[false].size() + 1); }
-int GetMaxThreads() { return std::min(MAX_THREADS, Threading::GetLogicalCpuCores()); }
+int GetMaxThreads() { return std::min(RESERVED_THREAD_NUM, Threading::GetLogicalCpuCores()); }
 
 bool HasThreads() { return !workerThreads[false].empty(); }
 
@@ -22,12 +22,14 @@ namespace ThreadPool {
 	static inline void SetDefaultThreadCount() {}
 	static inline void SetThreadCount(int num) {}
 	static inline int GetThreadNum() { return 0; }
+	static inline void SetThreadNum(int idx) {}
 	static inline int GetMaxThreads() { return 1; }
 	static inline int GetNumThreads() { return 1; }
 	static inline void NotifyWorkerThreads(bool force, bool async) {}
 	static inline bool HasThreads() { return false; }
 
 	static constexpr int MAX_THREADS = 1;
+	static constexpr int RESERVED_THREAD_NUM = 0;
 }
 
 template <typename F>
@@ -104,6 +106,7 @@ namespace ThreadPool {
 	void SetDefaultThreadCount();
 	void SetThreadCount(int num);
 	int GetThreadNum();
+	void SetThreadNum(int idx);
 	bool HasThreads();
 	int GetMaxThreads();
 	int GetNumThreads();
@@ -112,6 +115,11 @@ namespace ThreadPool {
 	extern bool inMultiThreadedSection;
 
 	static constexpr int MAX_THREADS = 32;
+	// index into per-thread arrays that is never given to a pool worker
+	// (async or not); code running concurrently with the sim outside of
+	// the pool's own tasks claims it via SetThreadNum so it can not race
+	// with worker i over the same per-thread caches and query stamps
+	static constexpr int RESERVED_THREAD_NUM = MAX_THREADS - 1;
 }
 
 
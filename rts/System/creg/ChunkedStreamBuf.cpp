@@ -0,0 +1,590 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "ChunkedStreamBuf.h"
+#include "Serializer.h"
+
+#include "System/Log/ILog.h"
+#include "System/Platform/byteorder.h"
+#include "System/Threading/ThreadPool.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+#include <zlib.h>
+
+using namespace creg;
+
+
+// batches that may be compressed or written concurrently; the writing thread
+// blocks when it gets further ahead, which bounds the raw data held in memory
+static constexpr size_t MAX_PENDING_BATCHES = 2;
+
+// smallest possible encodings of an index entry (see ReadUInt)
+static constexpr std::uint64_t MIN_CHUNK_ENTRY_SIZE = 2;
+static constexpr std::uint64_t MIN_PATCH_ENTRY_SIZE = 2;
+
+
+struct ChunkedStreamHeader {
+	char magic[4];
+	std::uint32_t version;
+	std::uint32_t chunkSize;
+
+	void SwapBytes() {
+		swabDWordInPlace(version);
+		swabDWordInPlace(chunkSize);
+	}
+};
+
+struct ChunkedStreamTrailer {
+	std::uint64_t indexOffset;
+	char magic[4];
+
+	void SwapBytes() {
+		swab64InPlace(indexOffset);
+	}
+};
+
+
+bool ChunkedStream::IsChunkedStream(std::istream* src)
+{
+	char magic[sizeof(ChunkedStream::MAGIC)] = {0};
+
+	const std::streampos pos = src->tellg();
+	src->read(magic, sizeof(magic));
+	src->clear();
+	src->seekg(pos);
+
+	return (memcmp(magic, ChunkedStream::MAGIC, sizeof(magic)) == 0);
+}
+
+
+
+//-------------------------------------------------------------------------
+// ChunkedOutputStreamBuf
+//-------------------------------------------------------------------------
+
+ChunkedOutputStreamBuf::ChunkedOutputStreamBuf(std::ostream* sink_, std::uint32_t chunkSize_, int compressionLevel_)
+	: sink(sink_)
+	, chunkSize(std::max(chunkSize_, 1u))
+	, compressionLevel(compressionLevel_)
+	// one batch keeps every worker busy while bounding the amount of raw data held
+	, batchSize(std::max(ThreadPool::GetNumThreads(), 1))
+{
+	ChunkedStreamHeader header = {};
+	memcpy(header.magic, ChunkedStream::MAGIC, sizeof(header.magic));
+	header.version = ChunkedStream::VERSION;
+	header.chunkSize = chunkSize;
+	header.SwapBytes();
+
+	sink->write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+	pendingChunks.reserve(batchSize);
+	curChunk.resize(chunkSize);
+	setp(curChunk.data(), curChunk.data() + chunkSize);
+}
+
+ChunkedOutputStreamBuf::~ChunkedOutputStreamBuf()
+{
+	// tasks reference this buffer and the sink, e.g. if an exception
+	// interrupted the writer before Finish was reached
+	WaitForChunkTasks(0);
+}
+
+std::uint64_t ChunkedOutputStreamBuf::AppendPos() const
+{
+	const std::uint64_t fill = appending? (pptr() - pbase()): curChunkFill;
+	return (flushedSize + pendingChunks.size() * chunkSize + fill);
+}
+
+
+void ChunkedOutputStreamBuf::EnterAppendMode()
+{
+	if (appending)
+		return;
+
+	setp(curChunk.data(), curChunk.data() + chunkSize);
+	pbump(curChunkFill);
+
+	appending = true;
+}
+
+void ChunkedOutputStreamBuf::EnterOverwriteMode(std::uint64_t pos)
+{
+	if (appending) {
+		curChunkFill = pptr() - pbase();
+		setp(nullptr, nullptr);
+	}
+
+	appending = false;
+	writePos = pos;
+}
+
+
+void ChunkedOutputStreamBuf::StartNextChunk()
+{
+	assert(appending);
+	assert(pptr() == epptr());
+
+	pendingChunks.emplace_back(std::move(curChunk));
+
+	if (pendingChunks.size() >= batchSize)
+		FlushChunks();
+
+	curChunk.resize(chunkSize);
+	setp(curChunk.data(), curChunk.data() + chunkSize);
+}
+
+void ChunkedOutputStreamBuf::FlushChunks()
+{
+	if (pendingChunks.empty())
+		return;
+
+	WaitForChunkTasks((MAX_PENDING_BATCHES - 1) * batchSize);
+
+	for (std::vector<char>& rawChunk: pendingChunks) {
+		ChunkJob* job = nullptr;
+
+		flushedSize += rawChunk.size();
+
+		{
+			std::lock_guard<spring::mutex> lock(writeMutex);
+
+			// deque::push_back keeps references to queued jobs valid
+			chunkJobs.push_back({std::move(rawChunk), {}, false});
+			job = &chunkJobs.back();
+		}
+
+		#ifdef THREADPOOL
+		chunkTasks.emplace_back(ThreadPool::Enqueue([this, job]() { CompressChunk(job); }));
+		#else
+		CompressChunk(job);
+		#endif
+	}
+
+	pendingChunks.clear();
+	pendingChunks.reserve(batchSize);
+}
+
+void ChunkedOutputStreamBuf::WaitForChunkTasks(size_t maxTasks)
+{
+	// tasks complete in any order, but once the oldest ones are done
+	// all of their chunks have also been written
+	while (chunkTasks.size() > maxTasks) {
+		chunkTasks.front()->wait();
+		chunkTasks.pop_front();
+	}
+}
+
+void ChunkedOutputStreamBuf::CompressChunk(ChunkJob* job)
+{
+	uLongf compSize = compressBound(job->rawData.size());
+
+	job->compData.resize(compSize);
+
+	if (compress2(reinterpret_cast<Bytef*>(job->compData.data()), &compSize, reinterpret_cast<const Bytef*>(job->rawData.data()), job->rawData.size(), compressionLevel) != Z_OK)
+		compSize = 0;
+
+	job->compData.resize(compSize);
+
+	std::lock_guard<spring::mutex> lock(writeMutex);
+
+	job->compressed = true;
+
+	WriteCompressedChunks();
+}
+
+void ChunkedOutputStreamBuf::WriteCompressedChunks()
+{
+	// write out in order; called with writeMutex held
+	while (!chunkJobs.empty() && chunkJobs.front().compressed) {
+		const ChunkJob& job = chunkJobs.front();
+
+		if (!failed && job.compData.empty()) {
+			LOG_L(L_ERROR, "[ChunkedOutputStreamBuf::%s] failed to compress chunk %u", __func__, unsigned(chunkIndex.size()));
+			failed = true;
+		}
+
+		if (!failed) {
+			sink->write(job.compData.data(), job.compData.size());
+			chunkIndex.emplace_back(job.rawData.size(), job.compData.size());
+
+			compressedSize += job.compData.size();
+			failed |= !sink->good();
+		}
+
+		chunkJobs.pop_front();
+	}
+}
+
+
+ChunkedOutputStreamBuf::int_type ChunkedOutputStreamBuf::overflow(int_type c)
+{
+	if (finished)
+		return traits_type::eof();
+	if (traits_type::eq_int_type(c, traits_type::eof()))
+		return traits_type::not_eof(c);
+
+	const char ch = traits_type::to_char_type(c);
+
+	if (!appending)
+		return ((OverwriteAt(&ch, 1) == 1)? c: traits_type::eof());
+
+	StartNextChunk();
+
+	*pptr() = ch;
+	pbump(1);
+	return c;
+}
+
+std::streamsize ChunkedOutputStreamBuf::xsputn(const char* s, std::streamsize n)
+{
+	if (finished)
+		return 0;
+	if (appending)
+		return (std::streambuf::xsputn(s, n));
+
+	return (OverwriteAt(s, n));
+}
+
+std::streamsize ChunkedOutputStreamBuf::OverwriteAt(const char* s, std::streamsize n)
+{
+	std::streamsize numWritten = 0;
+
+	while (numWritten < n) {
+		const std::uint64_t endPos = AppendPos();
+		const std::uint64_t remaining = n - numWritten;
+
+		if (writePos >= endPos) {
+			// caught up with the end of the stream, continue appending
+			EnterAppendMode();
+			return (numWritten + std::streambuf::xsputn(s + numWritten, n - numWritten));
+		}
+
+		if (writePos < flushedSize) {
+			// data is already compressed, record as patch (merged with the previous one if adjacent)
+			const size_t count = std::min(remaining, flushedSize - writePos);
+
+			if (patches.empty() || (patches.back().offset + patches.back().data.size()) != writePos)
+				patches.push_back({writePos, {}});
+
+			patches.back().data.insert(patches.back().data.end(), s + numWritten, s + numWritten + count);
+
+			writePos += count;
+			numWritten += count;
+			continue;
+		}
+
+		// data is still uncompressed, overwrite in place
+		const std::uint64_t relPos = writePos - flushedSize;
+		const size_t chunkIdx = relPos / chunkSize;
+		const size_t chunkOfs = relPos % chunkSize;
+		const size_t count = std::min(std::min(remaining, endPos - writePos), std::uint64_t(chunkSize - chunkOfs));
+
+		std::vector<char>& chunk = (chunkIdx < pendingChunks.size())? pendingChunks[chunkIdx]: curChunk;
+		memcpy(chunk.data() + chunkOfs, s + numWritten, count);
+
+		writePos += count;
+		numWritten += count;
+	}
+
+	return numWritten;
+}
+
+
+ChunkedOutputStreamBuf::pos_type ChunkedOutputStreamBuf::seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which)
+{
+	if ((which & std::ios_base::out) == 0)
+		return pos_type(off_type(-1));
+
+	switch (dir) {
+		case std::ios_base::beg: { return (seekpos(off, which)); } break;
+		case std::ios_base::cur: { return (seekpos((appending? AppendPos(): writePos) + off, which)); } break;
+		case std::ios_base::end: { return (seekpos(AppendPos() + off, which)); } break;
+		default: {} break;
+	}
+
+	return pos_type(off_type(-1));
+}
+
+ChunkedOutputStreamBuf::pos_type ChunkedOutputStreamBuf::seekpos(pos_type pos, std::ios_base::openmode which)
+{
+	if ((which & std::ios_base::out) == 0 || finished)
+		return pos_type(off_type(-1));
+
+	const off_type off = pos;
+	const std::uint64_t endPos = AppendPos();
+
+	if (off < 0 || std::uint64_t(off) > endPos)
+		return pos_type(off_type(-1));
+
+	if (std::uint64_t(off) == endPos) {
+		EnterAppendMode();
+	} else {
+		EnterOverwriteMode(off);
+	}
+
+	return pos;
+}
+
+
+bool ChunkedOutputStreamBuf::Finish()
+{
+	if (finished)
+		return false;
+
+	EnterAppendMode();
+
+	curChunk.resize(pptr() - pbase());
+	setp(nullptr, nullptr);
+
+	if (!curChunk.empty())
+		pendingChunks.emplace_back(std::move(curChunk));
+
+	FlushChunks();
+	WaitForChunkTasks(0);
+
+	finished = true;
+
+	if (failed || !chunkJobs.empty())
+		return false;
+
+	// index offset is relative to the start of the header
+	ChunkedStreamTrailer trailer = {};
+	trailer.indexOffset = sizeof(ChunkedStreamHeader) + compressedSize;
+	memcpy(trailer.magic, ChunkedStream::MAGIC, sizeof(trailer.magic));
+	trailer.SwapBytes();
+
+	WriteUInt(sink, chunkIndex.size());
+
+	for (const auto& p: chunkIndex) {
+		WriteUInt(sink, p.first);
+		WriteUInt(sink, p.second);
+	}
+
+	WriteUInt(sink, patches.size());
+
+	for (const Patch& p: patches) {
+		WriteUInt(sink, p.offset);
+		WriteUInt(sink, p.data.size());
+		sink->write(p.data.data(), p.data.size());
+	}
+
+	sink->write(reinterpret_cast<const char*>(&trailer), sizeof(trailer));
+	sink->flush();
+
+	LOG_L(L_DEBUG, "[ChunkedOutputStreamBuf::%s] %u chunks, %u patches, %lu raw bytes, %lu compressed bytes",
+		__func__, unsigned(chunkIndex.size()), unsigned(patches.size()), (unsigned long) flushedSize, (unsigned long) compressedSize);
+
+	return (sink->good());
+}
+
+
+
+//-------------------------------------------------------------------------
+// ChunkedInputStreamBuf
+//-------------------------------------------------------------------------
+
+ChunkedInputStreamBuf::ChunkedInputStreamBuf(std::istream* src_): src(src_)
+{
+	srcBase = src->tellg();
+	valid = ReadIndex();
+
+	setg(nullptr, nullptr, nullptr);
+}
+
+
+bool ChunkedInputStreamBuf::ReadIndex()
+{
+	ChunkedStreamHeader header;
+	ChunkedStreamTrailer trailer;
+
+	if (!src->read(reinterpret_cast<char*>(&header), sizeof(header)))
+		return false;
+
+	header.SwapBytes();
+
+	if (memcmp(header.magic, ChunkedStream::MAGIC, sizeof(header.magic)) != 0)
+		return false;
+	if (header.version != ChunkedStream::VERSION)
+		return false;
+
+	if (!src->seekg(-off_type(sizeof(trailer)), std::ios_base::end))
+		return false;
+
+	// everything below is bounded by the file length, so a corrupted index
+	// fails the load instead of making us allocate or read garbage sizes
+	const std::uint64_t indexEnd = src->tellg() - srcBase;
+
+	if (!src->read(reinterpret_cast<char*>(&trailer), sizeof(trailer)))
+		return false;
+
+	trailer.SwapBytes();
+
+	if (memcmp(trailer.magic, ChunkedStream::MAGIC, sizeof(trailer.magic)) != 0)
+		return false;
+	if (trailer.indexOffset < sizeof(ChunkedStreamHeader) || trailer.indexOffset > indexEnd)
+		return false;
+	if (!src->seekg(srcBase + off_type(trailer.indexOffset)))
+		return false;
+
+	const auto RemainingIndexSize = [&]() -> std::uint64_t {
+		const std::uint64_t pos = src->tellg() - srcBase;
+		return ((src->good() && pos <= indexEnd)? (indexEnd - pos): 0);
+	};
+
+	std::uint64_t numChunks = 0;
+	std::uint64_t numPatches = 0;
+	std::uint64_t srcOffset = sizeof(ChunkedStreamHeader);
+
+	ReadUInt(src, &numChunks);
+
+	if (numChunks > (RemainingIndexSize() / MIN_CHUNK_ENTRY_SIZE))
+		return false;
+
+	chunks.resize(numChunks);
+
+	for (ChunkInfo& ci: chunks) {
+		std::uint64_t sizes[2] = {0, 0};
+
+		ReadUInt(src, &sizes[0]);
+		ReadUInt(src, &sizes[1]);
+
+		if (sizes[0] > header.chunkSize || sizes[1] > (trailer.indexOffset - srcOffset))
+			return false;
+
+		ci.rawOffset = rawSize;
+		ci.srcOffset = srcOffset;
+		ci.rawSize = sizes[0];
+		ci.compSize = sizes[1];
+
+		rawSize += ci.rawSize;
+		srcOffset += ci.compSize;
+	}
+
+	ReadUInt(src, &numPatches);
+
+	if (numPatches > (RemainingIndexSize() / MIN_PATCH_ENTRY_SIZE))
+		return false;
+
+	patches.resize(numPatches);
+
+	for (Patch& p: patches) {
+		std::uint64_t size = 0;
+
+		ReadUInt(src, &p.offset);
+		ReadUInt(src, &size);
+
+		if (size > RemainingIndexSize() || p.offset > rawSize || size > (rawSize - p.offset))
+			return false;
+
+		p.data.resize(size);
+		src->read(p.data.data(), size);
+	}
+
+	return (src->good() && srcOffset == trailer.indexOffset);
+}
+
+bool ChunkedInputStreamBuf::LoadChunk(size_t chunkIdx)
+{
+	if (chunkIdx == curChunkIdx)
+		return true;
+	if (chunkIdx >= chunks.size())
+		return false;
+
+	const ChunkInfo& ci = chunks[chunkIdx];
+
+	compBuffer.resize(ci.compSize);
+	rawBuffer.resize(ci.rawSize);
+
+	src->clear();
+	src->seekg(srcBase + off_type(ci.srcOffset));
+
+	if (!src->read(compBuffer.data(), ci.compSize))
+		return false;
+
+	uLongf rawChunkSize = ci.rawSize;
+
+	if (uncompress(reinterpret_cast<Bytef*>(rawBuffer.data()), &rawChunkSize, reinterpret_cast<const Bytef*>(compBuffer.data()), ci.compSize) != Z_OK)
+		return false;
+	if (rawChunkSize != ci.rawSize)
+		return false;
+
+	// re-apply everything that was overwritten after this chunk had been compressed
+	for (const Patch& p: patches) {
+		const std::uint64_t beg = std::max(p.offset, ci.rawOffset);
+		const std::uint64_t end = std::min(p.offset + p.data.size(), ci.rawOffset + ci.rawSize);
+
+		if (beg >= end)
+			continue;
+
+		memcpy(rawBuffer.data() + (beg - ci.rawOffset), p.data.data() + (beg - p.offset), end - beg);
+	}
+
+	curChunkIdx = chunkIdx;
+
+	setg(rawBuffer.data(), rawBuffer.data(), rawBuffer.data() + ci.rawSize);
+	return true;
+}
+
+
+ChunkedInputStreamBuf::int_type ChunkedInputStreamBuf::underflow()
+{
+	if (gptr() < egptr())
+		return traits_type::to_int_type(*gptr());
+	if (!valid)
+		return traits_type::eof();
+
+	const size_t nextChunkIdx = (curChunkIdx < chunks.size())? curChunkIdx + 1: 0;
+
+	if (!LoadChunk(nextChunkIdx))
+		return traits_type::eof();
+
+	return traits_type::to_int_type(*gptr());
+}
+
+
+ChunkedInputStreamBuf::pos_type ChunkedInputStreamBuf::seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which)
+{
+	if ((which & std::ios_base::in) == 0)
+		return pos_type(off_type(-1));
+
+	std::uint64_t curPos = 0;
+
+	if (curChunkIdx < chunks.size())
+		curPos = chunks[curChunkIdx].rawOffset + (gptr() - eback());
+
+	switch (dir) {
+		case std::ios_base::beg: { return (seekpos(off, which)); } break;
+		case std::ios_base::cur: { return (seekpos(curPos + off, which)); } break;
+		case std::ios_base::end: { return (seekpos(rawSize + off, which)); } break;
+		default: {} break;
+	}
+
+	return pos_type(off_type(-1));
+}
+
+ChunkedInputStreamBuf::pos_type ChunkedInputStreamBuf::seekpos(pos_type pos, std::ios_base::openmode which)
+{
+	if ((which & std::ios_base::in) == 0 || !valid)
+		return pos_type(off_type(-1));
+
+	const off_type off = pos;
+
+	if (off < 0 || std::uint64_t(off) > rawSize)
+		return pos_type(off_type(-1));
+
+	if (chunks.empty())
+		return pos;
+
+	// find the last chunk starting at or before <off>; seeking to the very end lands in the last chunk
+	const auto pred = [](std::uint64_t o, const ChunkInfo& ci) { return (o < ci.rawOffset); };
+	const auto iter = std::upper_bound(chunks.begin(), chunks.end(), std::uint64_t(off), pred);
+	const size_t chunkIdx = (iter - chunks.begin()) - 1;
+
+	if (!LoadChunk(chunkIdx))
+		return pos_type(off_type(-1));
+
+	setg(eback(), eback() + (off - chunks[chunkIdx].rawOffset), egptr());
+	return pos;
+}
@@ -0,0 +1,180 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef CREG_CHUNKED_STREAM_BUF_H
+#define CREG_CHUNKED_STREAM_BUF_H
+
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <streambuf>
+#include <vector>
+
+#include "System/Threading/SpringThreading.h"
+
+namespace creg {
+
+	/**
+	 * Container layout shared by the chunked stream buffers:
+	 *
+	 *   [header] [deflated chunk 0] ... [deflated chunk N-1] [index] [trailer]
+	 *
+	 * The index lists raw and compressed sizes of every chunk plus any bytes
+	 * that were overwritten (via seekp) after their chunk had already been
+	 * compressed; these "patches" are re-applied by the reader on inflation.
+	 * The trailer holds the index offset so readers can locate it directly.
+	 */
+	namespace ChunkedStream {
+		static constexpr char MAGIC[4] = {'C', 'R', 'C', 'S'};
+		static constexpr std::uint32_t VERSION = 1;
+		static constexpr std::uint32_t DEFAULT_CHUNK_SIZE = 4 * 1024 * 1024;
+
+		/// true if <src> is positioned at the start of a chunked stream, does not consume anything
+		bool IsChunkedStream(std::istream* src);
+	}
+
+
+	/**
+	 * Write-side buffer which splits everything written to it into fixed-size
+	 * chunks; full chunks are handed off in batches to ThreadPool tasks which
+	 * deflate them, and whichever task completes the oldest outstanding chunk
+	 * appends it (and any completed successors) to the sink, so the writing
+	 * thread neither waits for compression or I/O nor has to hold the whole
+	 * serialized state in memory.
+	 * Seeking back into data that was already handed off is supported (the
+	 * creg package header is rewritten this way) and recorded as a patch.
+	 * The sink must not be touched by anyone else until Finish has returned.
+	 */
+	class ChunkedOutputStreamBuf : public std::streambuf
+	{
+	public:
+		ChunkedOutputStreamBuf(std::ostream* sink, std::uint32_t chunkSize = ChunkedStream::DEFAULT_CHUNK_SIZE, int compressionLevel = 5);
+		~ChunkedOutputStreamBuf();
+
+		/// compresses any remaining data, waits for all background jobs and
+		/// writes the index; must be called after the last write, but need
+		/// not be called from the thread that did the writing
+		bool Finish();
+
+		std::uint64_t GetRawSize() const { return (AppendPos()); }
+		std::uint64_t GetCompressedSize() const { return compressedSize; }
+
+	protected:
+		int_type overflow(int_type c) override;
+		std::streamsize xsputn(const char* s, std::streamsize n) override;
+		pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override;
+		pos_type seekpos(pos_type pos, std::ios_base::openmode which) override;
+
+	private:
+		struct Patch {
+			std::uint64_t offset;
+			std::vector<char> data;
+		};
+		struct ChunkJob {
+			std::vector<char> rawData;
+			std::vector<char> compData;
+			bool compressed;
+		};
+
+		std::uint64_t AppendPos() const;
+
+		void EnterAppendMode();
+		void EnterOverwriteMode(std::uint64_t pos);
+		void StartNextChunk();
+		void FlushChunks();
+		void WaitForChunkTasks(size_t maxTasks);
+		void CompressChunk(ChunkJob* job);
+		void WriteCompressedChunks();
+
+		std::streamsize OverwriteAt(const char* s, std::streamsize n);
+
+	private:
+		std::ostream* sink;
+
+		std::uint32_t chunkSize;
+		int compressionLevel;
+		size_t batchSize;
+
+		// full chunks waiting for the next compression batch
+		std::vector< std::vector<char> > pendingChunks;
+		std::vector<char> curChunk;
+
+		// chunks handed off but not yet written, oldest first; guarded by
+		// writeMutex, as are the sink, chunkIndex, compressedSize and failed
+		// until every task has finished
+		std::deque<ChunkJob> chunkJobs;
+		// compression tasks in the order they were queued, owned by the writer
+		std::deque< std::shared_ptr< std::future<void> > > chunkTasks;
+
+		spring::mutex writeMutex;
+
+		// {raw, compressed} size of each chunk written to the sink so far
+		std::vector< std::pair<std::uint32_t, std::uint32_t> > chunkIndex;
+		std::vector<Patch> patches;
+
+		// raw bytes handed off to compression tasks, and bytes they wrote out
+		std::uint64_t flushedSize = 0;
+		std::uint64_t compressedSize = 0;
+
+		// overwrite-mode state; put-area is disabled while !appending
+		std::uint64_t writePos = 0;
+		std::uint32_t curChunkFill = 0;
+
+		bool appending = true;
+		bool finished = false;
+		bool failed = false;
+	};
+
+
+	/**
+	 * Read-side counterpart of ChunkedOutputStreamBuf; chunks are inflated
+	 * on demand so only one of them is resident at any time. Supports
+	 * arbitrary seeking, as required by CInputStreamSerializer.
+	 */
+	class ChunkedInputStreamBuf : public std::streambuf
+	{
+	public:
+		ChunkedInputStreamBuf(std::istream* src);
+
+		bool IsValid() const { return valid; }
+		std::uint64_t GetRawSize() const { return rawSize; }
+
+	protected:
+		int_type underflow() override;
+		pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override;
+		pos_type seekpos(pos_type pos, std::ios_base::openmode which) override;
+
+	private:
+		struct ChunkInfo {
+			std::uint64_t rawOffset;
+			std::uint64_t srcOffset;
+			std::uint32_t rawSize;
+			std::uint32_t compSize;
+		};
+		struct Patch {
+			std::uint64_t offset;
+			std::vector<char> data;
+		};
+
+		bool ReadIndex();
+		bool LoadChunk(size_t chunkIdx);
+
+	private:
+		std::istream* src;
+		std::streamoff srcBase = 0;
+
+		std::vector<ChunkInfo> chunks;
+		std::vector<Patch> patches;
+		std::vector<char> rawBuffer;
+		std::vector<char> compBuffer;
+
+		std::uint64_t rawSize = 0;
+		size_t curChunkIdx = size_t(-1);
+
+		bool valid = false;
+	};
+}
+
+#endif // CREG_CHUNKED_STREAM_BUF_H
@@ -85,7 +85,8 @@ void ReadVarSizeUInt(std::istream* stream, T* buf)
 	std::uint64_t val = 0;
 	unsigned offset = 0;
 	while (true) {
-		unsigned char a;
+		// stays 0 if the read fails, so truncated input can not loop forever
+		unsigned char a = 0;
 		stream->read((char*)&a, sizeof(char));
 
 		val += ((std::uint64_t)(a & 0x7F)) << offset;
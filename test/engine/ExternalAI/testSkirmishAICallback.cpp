@@ -0,0 +1,109 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "ExternalAI/Interface/SSkirmishAICallback.h"
+
+#include <fstream>
+#include <regex>
+#include <string>
+#include <type_traits>
+
+#define CATCH_CONFIG_MAIN
+#include "lib/catch.hpp"
+
+
+static_assert(std::is_same<
+	decltype(SSkirmishAICallback::getUnitStates),
+	int (CALLING_CONV *)(int, const int*, int, float*, int)
+>::value, "getUnitStates has to follow the single-array fetcher layout");
+
+
+
+// the Java and C++ AI wrappers are generated from this header, and the
+// generators only understand array parameters following the conventions
+// ARRAY / FETCHER / REF annotated callbacks use; see AI/Wrappers/*/bin
+static int CheckCallbackEntry(const std::string& line)
+{
+	static const std::regex paramRegex("^\\s*(const\\s+)?(\\w+)\\s*\\*+\\s*(\\w+)\\s*$");
+
+	const size_t metaPos = line.find("//$");
+	const size_t paramsBeg = line.find(")(") + 2;
+	const size_t paramsEnd = line.rfind(')', metaPos);
+
+	const std::string params = line.substr(paramsBeg, paramsEnd - paramsBeg);
+	const std::string meta = (metaPos != std::string::npos)? line.substr(metaPos): "";
+
+	int numErrors = 0;
+	int numOutArrays = 0;
+
+	for (size_t beg = 0, end = 0; beg < params.size(); beg = end + 1) {
+		if ((end = params.find(',', beg)) == std::string::npos)
+			end = params.size();
+
+		std::smatch match;
+		const std::string param = params.substr(beg, end - beg);
+
+		if (!std::regex_match(param, match, paramRegex))
+			continue;
+
+		const std::string type = match[2];
+		const std::string name = match[3];
+
+		// strings, raw buffers and single vectors have their own rules
+		if (type == "char" || type == "void")
+			continue;
+		if (std::regex_search(name, std::regex("_(posF3|out)$")))
+			continue;
+
+		if (params.find("int " + name + "_sizeMax") == std::string::npos) {
+			INFO("missing " << name << "_sizeMax: " << line);
+			CHECK(false);
+			numErrors++;
+		}
+
+		if (match[1].matched)
+			continue;
+
+		numOutArrays++;
+
+		if (!std::regex_search(meta, std::regex("[:>]" + name + "\\b"))) {
+			INFO("missing //$ annotation for " << name << ": " << line);
+			CHECK(false);
+			numErrors++;
+		}
+	}
+
+	if (numOutArrays > 1) {
+		INFO("the wrapper generators handle one output array per callback: " << line);
+		CHECK(false);
+		numErrors++;
+	}
+
+	return numErrors;
+}
+
+
+
+TEST_CASE("SkirmishAICallback")
+{
+	std::ifstream header(AI_CALLBACK_HEADER);
+	std::string line;
+
+	REQUIRE(header.good());
+
+	int numEntries = 0;
+	int numErrors = 0;
+
+	while (std::getline(header, line)) {
+		if (line.find("(CALLING_CONV *") == std::string::npos)
+			continue;
+		// commented-out entries
+		if (line.find_first_not_of(" \t") == line.find("//"))
+			continue;
+
+		numEntries++;
+		numErrors += CheckCallbackEntry(line);
+	}
+
+	CHECK(numEntries > 0);
+	CHECK(numErrors == 0);
+}
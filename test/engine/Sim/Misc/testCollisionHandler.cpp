@@ -0,0 +1,99 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "Sim/Misc/CollisionHandler.h"
+#include "Sim/Misc/CollisionVolume.h"
+#include "Sim/Misc/GroundBlockingObjectMap.h"
+#include "Map/ReadMap.h"
+#include "Rendering/Models/3DModel.h"
+#include "Sim/Units/Unit.h"
+#include "System/float3.h"
+
+#include <cstring>
+#include <random>
+#include <vector>
+
+#define CATCH_CONFIG_MAIN
+#include "lib/catch.hpp"
+
+
+// link-time stand-ins for the parts of the engine the ray-volume tests never reach
+class CGlobalRendering;
+CGlobalRendering* globalRendering = nullptr;
+CGroundBlockingObjectMap groundBlockingObjectMap;
+MapDimensions mapDims;
+
+void LocalModelPiece::UpdateParentMatricesRec() const {}
+CMatrix44f CUnit::GetTransformMatrix(bool synced, bool fullread) const { return {}; }
+
+
+
+static constexpr int TEST_RUNS = 2000;
+static constexpr int MAX_BATCH_SIZE = 37; // not a multiple of any lane count
+
+static std::mt19937 rng(0x5EED);
+
+static inline float randf(float lo, float hi) { return std::uniform_real_distribution<float>(lo, hi)(rng); }
+static inline float3 randfloat3(float lo, float hi) { return {randf(lo, hi), randf(lo, hi), randf(lo, hi)}; }
+
+static float3 RandRayPoint(const CollisionVolume& v)
+{
+	float3 p = randfloat3(-2.0f, 2.0f) * v.GetHScales();
+
+	// exercise the axis-parallel and degenerate-direction special cases
+	switch (rng() % 8) {
+		case 0: { p.x = 0.0f; } break;
+		case 1: { p.y = 0.0f; } break;
+		case 2: { p.z = 0.0f; } break;
+		default: {} break;
+	}
+
+	return p;
+}
+
+static void CheckBatch(int volType, void (*batched)(const CollisionVolume* const*, const float3*, const float3*, CollisionQuery*, bool*, size_t), bool (*scalar)(const CollisionVolume*, const float3&, const float3&, CollisionQuery*))
+{
+	std::vector<CollisionVolume> vols(MAX_BATCH_SIZE);
+	std::vector<const CollisionVolume*> volPtrs(MAX_BATCH_SIZE);
+	std::vector<float3> pi0s(MAX_BATCH_SIZE);
+	std::vector<float3> pi1s(MAX_BATCH_SIZE);
+
+	CollisionQuery batchQueries[MAX_BATCH_SIZE];
+	bool batchHits[MAX_BATCH_SIZE];
+
+	int numMismatches = 0;
+
+	for (int n = 0; n < TEST_RUNS; ++n) {
+		const size_t batchSize = 1 + (rng() % MAX_BATCH_SIZE);
+
+		for (size_t i = 0; i < batchSize; i++) {
+			vols[i].InitShape(randfloat3(1.0f, 64.0f), ZeroVector, volType, CollisionVolume::COLVOL_HITTEST_CONT, rng() % 3);
+
+			volPtrs[i] = &vols[i];
+			pi0s[i] = RandRayPoint(vols[i]);
+			pi1s[i] = ((rng() % 16) == 0)? pi0s[i]: RandRayPoint(vols[i]);
+		}
+
+		std::fill(std::begin(batchQueries), std::end(batchQueries), CollisionQuery{});
+		batched(volPtrs.data(), pi0s.data(), pi1s.data(), batchQueries, batchHits, batchSize);
+
+		for (size_t i = 0; i < batchSize; i++) {
+			CollisionQuery scalarQuery;
+			const bool scalarHit = scalar(volPtrs[i], pi0s[i], pi1s[i], &scalarQuery);
+
+			// bit-wise, so NaNs and signed zeros have to match as well
+			numMismatches += (scalarHit != batchHits[i]);
+			numMismatches += (std::memcmp(&scalarQuery, &batchQueries[i], sizeof(CollisionQuery)) != 0);
+		}
+	}
+
+	CHECK(numMismatches == 0);
+}
+
+
+
+TEST_CASE("CollisionHandler")
+{
+	SECTION("Ellipsoids") { CheckBatch(CollisionVolume::COLVOL_TYPE_ELLIPSOID, CCollisionHandler::IntersectEllipsoids, CCollisionHandler::IntersectEllipsoid); }
+	SECTION("Cylinders" ) { CheckBatch(CollisionVolume::COLVOL_TYPE_CYLINDER , CCollisionHandler::IntersectCylinders , CCollisionHandler::IntersectCylinder ); }
+	SECTION("Boxes"     ) { CheckBatch(CollisionVolume::COLVOL_TYPE_BOX      , CCollisionHandler::IntersectBoxes     , CCollisionHandler::IntersectBox      ); }
+}
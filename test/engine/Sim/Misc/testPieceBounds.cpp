@@ -0,0 +1,165 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "Sim/Misc/PieceBounds.h"
+#include "System/Matrix44f.h"
+#include "System/SpringMath.h"
+#include "System/float3.h"
+
+#include <cstring>
+#include <random>
+#include <vector>
+
+#define CATCH_CONFIG_MAIN
+#include "lib/catch.hpp"
+
+
+static constexpr int TEST_RUNS = 500;
+static constexpr int MAX_NUM_PIECES = 41;
+static constexpr int NUM_SEGMENTS = 64;
+
+static std::mt19937 rng(0x5EED);
+
+static inline float randf(float lo, float hi) { return std::uniform_real_distribution<float>(lo, hi)(rng); }
+static inline float3 randfloat3(float lo, float hi) { return {randf(lo, hi), randf(lo, hi), randf(lo, hi)}; }
+
+struct TestPiece {
+	CMatrix44f mat;
+	float3 hs;
+	float3 offsets;
+	bool visible;
+
+	// a point inside the volume's box (which any volume type fits in)
+	float3 RandInnerPoint() const { return (mat * (offsets + randfloat3(-1.0f, 1.0f) * hs)); }
+};
+
+static void RandPiece(TestPiece& p)
+{
+	p.mat = CMatrix44f(randfloat3(-100.0f, 100.0f));
+	p.mat.RotateEulerXYZ(randfloat3(-math::PI, math::PI));
+
+	if ((rng() % 4) == 0)
+		p.mat.Scale(randfloat3(0.25f, 4.0f));
+
+	p.hs = randfloat3(0.5f, 32.0f);
+	p.offsets = randfloat3(-10.0f, 10.0f);
+	p.visible = ((rng() % 8) != 0);
+}
+
+// random tree in pre-order: each piece hangs off the current chain of ancestors
+static std::vector<int> RandParents(size_t numPieces)
+{
+	std::vector<int> parents(numPieces, -1);
+	std::vector<int> chain = {0};
+
+	for (size_t n = 1; n < numPieces; n++) {
+		chain.resize(1 + (rng() % chain.size()));
+		parents[n] = chain.back();
+		chain.push_back(n);
+	}
+
+	return parents;
+}
+
+static void Refit(PieceBoundsTree& tree, const std::vector<TestPiece>& pieces)
+{
+	tree.Refit([&](unsigned int i) {
+		PieceBounds b;
+
+		if (pieces[i].visible)
+			b.SetVolumeBox(pieces[i].mat, pieces[i].hs, pieces[i].offsets);
+
+		return b;
+	});
+}
+
+static bool Contains(const PieceBounds& b, const float3& p)
+{
+	return (p.x >= b.mins.x && p.y >= b.mins.y && p.z >= b.mins.z && p.x <= b.maxs.x && p.y <= b.maxs.y && p.z <= b.maxs.z);
+}
+
+
+
+TEST_CASE("PieceBounds")
+{
+	std::vector<TestPiece> pieces;
+	PieceBoundsTree tree;
+	PieceBoundsTree freshTree;
+
+	int numMissedPoints = 0;
+	int numCulledHits = 0;
+	int numMismatches = 0;
+	int numKeptMisses = 0;
+
+	for (int n = 0; n < TEST_RUNS; ++n) {
+		const size_t numPieces = 1 + (rng() % MAX_NUM_PIECES);
+		const std::vector<int> parents = RandParents(numPieces);
+
+		pieces.resize(numPieces);
+
+		for (TestPiece& p: pieces) {
+			RandPiece(p);
+		}
+
+		tree.Init(parents);
+		Refit(tree, pieces);
+
+		CHECK(!tree.IsStale());
+		CHECK(tree.GetSubtreeSize(0) == numPieces);
+
+		for (size_t i = 0; i < numPieces; i++) {
+			if (!pieces[i].visible)
+				continue;
+
+			for (int k = 0; k < NUM_SEGMENTS; k++) {
+				const float3 p = pieces[i].RandInnerPoint();
+				const float3 d = randfloat3(-200.0f, 200.0f);
+				const float3 p0 = p - d * randf(0.0f, 1.0f);
+				const float3 p1 = p0 + d;
+
+				// every subtree containing the piece must keep it, and may
+				// never cull a segment passing through its volume
+				for (int a = i; a != -1; a = parents[a]) {
+					numMissedPoints += !Contains(tree.GetSubtreeBounds(a), p);
+					numCulledHits += !tree.GetSubtreeBounds(a).SegmentHits(p0, p1);
+				}
+			}
+		}
+
+		{
+			// whereas segments beyond the root's bounds have to be culled
+			const PieceBounds& rb = tree.GetSubtreeBounds(0);
+			const float3 p0 = rb.maxs + randfloat3(1.0f, 50.0f);
+			const float3 p1 = p0 + randfloat3(0.0f, 100.0f);
+
+			numKeptMisses += rb.SegmentHits(p0, p1);
+		}
+
+		// move some pieces (as animations would) and refit incrementally
+		for (int k = rng() % 4; k >= 0; k--) {
+			const unsigned int i = rng() % numPieces;
+
+			RandPiece(pieces[i]);
+			tree.SetStale(i);
+
+			// subtrees move along with their root
+			for (unsigned int c = i + 1; c < i + tree.GetSubtreeSize(i); c++) {
+				if ((rng() % 2) == 0)
+					RandPiece(pieces[c]);
+			}
+		}
+
+		Refit(tree, pieces);
+
+		freshTree.Init(parents);
+		Refit(freshTree, pieces);
+
+		for (size_t i = 0; i < numPieces; i++) {
+			numMismatches += (std::memcmp(&tree.GetSubtreeBounds(i), &freshTree.GetSubtreeBounds(i), sizeof(PieceBounds)) != 0);
+		}
+	}
+
+	CHECK(numMissedPoints == 0);
+	CHECK(numCulledHits == 0);
+	CHECK(numMismatches == 0);
+	CHECK(numKeptMisses == 0);
+}
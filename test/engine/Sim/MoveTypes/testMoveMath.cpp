@@ -0,0 +1,116 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "Sim/MoveTypes/MoveMath/MoveMath.h"
+#include "Sim/MoveTypes/MoveDefHandler.h"
+#include "Sim/Misc/ModInfo.h"
+#include "Map/MapInfo.h"
+
+#include <cstring>
+#include <random>
+#include <vector>
+
+#define CATCH_CONFIG_MAIN
+#include "lib/catch.hpp"
+
+
+// link-time stand-ins for the parts of the engine the speed-mod kernels never reach
+CModInfo modInfo;
+void CModInfo::ResetState() {}
+MoveDef::MoveDef() {}
+
+bool CMoveMath::noHoverWaterMove = false;
+float CMoveMath::waterDamageCost = 0.0f;
+
+
+
+static constexpr int TEST_RUNS = 500;
+static constexpr int MAX_ROW_SIZE = 67; // not a multiple of the lane count
+
+static std::mt19937 rng(0x5EED);
+
+static inline float randf(float lo, float hi) { return std::uniform_real_distribution<float>(lo, hi)(rng); }
+
+static void RandMoveDef(MoveDef& md, MoveDef::SpeedModClass smc)
+{
+	md.speedModClass = smc;
+	md.depth = randf(0.0f, 50.0f);
+	md.maxSlope = randf(0.0f, 1.0f);
+	md.slopeMod = randf(0.0f, 10.0f);
+
+	md.depthModParams[MoveDef::DEPTHMOD_MIN_HEIGHT] = randf(0.0f, 20.0f);
+	md.depthModParams[MoveDef::DEPTHMOD_MAX_HEIGHT] = md.depthModParams[MoveDef::DEPTHMOD_MIN_HEIGHT] + randf(0.0f, 40.0f);
+	md.depthModParams[MoveDef::DEPTHMOD_MAX_SCALE ] = randf(0.01f, 10.0f);
+	md.depthModParams[MoveDef::DEPTHMOD_QUA_COEFF ] = randf(0.0f, 0.01f);
+	md.depthModParams[MoveDef::DEPTHMOD_LIN_COEFF ] = randf(0.0f, 0.2f);
+	md.depthModParams[MoveDef::DEPTHMOD_CON_COEFF ] = randf(0.0f, 2.0f);
+
+	CMoveMath::noHoverWaterMove = ((rng() % 2) == 0);
+	CMoveMath::waterDamageCost = randf(0.0f, 1.0f);
+}
+
+static void CheckRows(MoveDef::SpeedModClass smc)
+{
+	std::vector<CMapInfo::TerrainType> terrainTypes(CMapInfo::NUM_TERRAIN_TYPES);
+
+	for (CMapInfo::TerrainType& tt: terrainTypes) {
+		// some types are impassable for each class
+		tt.tankSpeed  = randf(0.0f, 2.0f) * ((rng() % 8) != 0);
+		tt.kbotSpeed  = randf(0.0f, 2.0f) * ((rng() % 8) != 0);
+		tt.hoverSpeed = randf(0.0f, 2.0f) * ((rng() % 8) != 0);
+		tt.shipSpeed  = randf(0.0f, 2.0f) * ((rng() % 8) != 0);
+	}
+
+	std::vector<float> heights(MAX_ROW_SIZE);
+	std::vector<float> slopes(MAX_ROW_SIZE);
+	std::vector<unsigned char> types(MAX_ROW_SIZE);
+	std::vector<float> rowSpeedMods(MAX_ROW_SIZE);
+
+	MoveDef md;
+
+	int numMismatches = 0;
+
+	for (int n = 0; n < TEST_RUNS; ++n) {
+		RandMoveDef(md, smc);
+
+		// start at an arbitrary offset so the lanes see unaligned rows
+		const unsigned int offset = rng() % 4;
+		const unsigned int count = rng() % (MAX_ROW_SIZE - offset + 1);
+
+		for (int i = 0; i < MAX_ROW_SIZE; i++) {
+			heights[i] = randf(-100.0f, 100.0f);
+			slopes[i] = randf(0.0f, 1.0f);
+			types[i] = rng() % CMapInfo::NUM_TERRAIN_TYPES;
+
+			// hit the comparison boundaries exactly
+			switch (rng() % 16) {
+				case 0: { heights[i] = 0.0f; } break;
+				case 1: { heights[i] = -md.depth; } break;
+				case 2: { heights[i] = -md.depthModParams[MoveDef::DEPTHMOD_MIN_HEIGHT]; } break;
+				case 3: { heights[i] = -md.depthModParams[MoveDef::DEPTHMOD_MAX_HEIGHT]; } break;
+				case 4: { slopes[i] = md.maxSlope; } break;
+				default: {} break;
+			}
+		}
+
+		CMoveMath::TerrainSpeedModRow(md, &heights[offset], &slopes[offset], &types[offset], terrainTypes.data(), count, rowSpeedMods.data());
+
+		for (unsigned int i = 0; i < count; i++) {
+			const float speedMod = CMoveMath::TerrainSpeedMod(md, heights[offset + i], slopes[offset + i], terrainTypes[types[offset + i]]);
+
+			// bit-wise, the rasters built from rows have to match the scalar path exactly
+			numMismatches += (std::memcmp(&speedMod, &rowSpeedMods[i], sizeof(float)) != 0);
+		}
+	}
+
+	CHECK(numMismatches == 0);
+}
+
+
+
+TEST_CASE("MoveMath")
+{
+	SECTION("Tank" ) { CheckRows(MoveDef::Tank ); }
+	SECTION("KBot" ) { CheckRows(MoveDef::KBot ); }
+	SECTION("Hover") { CheckRows(MoveDef::Hover); }
+	SECTION("Ship" ) { CheckRows(MoveDef::Ship ); }
+}
@@ -2,6 +2,11 @@
 
 #include "System/creg/creg_cond.h"
 #include "System/creg/Serializer.h"
+#include "System/creg/ChunkedStreamBuf.h"
+#include "System/Misc/SpringTime.h"
+#include "System/Platform/Threading.h"
+#include "System/Threading/ThreadPool.h"
+#include <cstring>
 #include <fstream>
 #include <sstream>
 #include <string>
@@ -12,6 +17,9 @@
 #include "lib/catch.hpp"
 
 
+InitSpringTime ist;
+
+
 
 struct EmbeddedObj {
 	CR_DECLARE_STRUCT(EmbeddedObj);
@@ -173,3 +181,124 @@ TEST_CASE("CregLoadSave")
 
 	delete root;
 }
+
+
+TEST_CASE("CregLoadSaveChunked")
+{
+	std::stringstream ss(std::ios::in | std::ios::out | std::ios::binary);
+
+	// save state; tiny chunks force the package header rewrite to become a patch
+	{
+		creg::ChunkedOutputStreamBuf osb(&ss, 16, 1);
+		std::ostream os(&osb);
+
+		savetest(&os);
+		CHECK(osb.Finish());
+		CHECK(osb.GetRawSize() > 16);
+	}
+
+	CHECK(creg::ChunkedStream::IsChunkedStream(&ss));
+
+	// load state
+	creg::ChunkedInputStreamBuf isb(&ss);
+	std::istream is(&isb);
+
+	INFO("test chunk index");
+	REQUIRE(isb.IsValid());
+
+	TestObj* root = (TestObj*)loadtest(&is);
+
+	INFO("test root obj");
+	CHECK(dynamic_cast<TestObj*>(root));
+	INFO("test class members");
+	CHECK(test_creg_members(root));
+	INFO("test class pointers");
+	CHECK(test_creg_pointers(root));
+
+	delete root;
+}
+
+
+static std::string WriteChunked(const std::vector<char>& data, std::uint32_t chunkSize)
+{
+	std::stringstream ss(std::ios::in | std::ios::out | std::ios::binary);
+	creg::ChunkedOutputStreamBuf osb(&ss, chunkSize, 1);
+	std::ostream os(&osb);
+
+	// uneven write sizes straddle chunk and batch boundaries
+	for (size_t i = 0, n = 1; i < data.size(); i += n, n = (n * 7) % 509 + 1)
+		os.write(data.data() + i, std::min(n, data.size() - i));
+
+	// rewrite a prefix that was already compressed (patch) and the tail
+	// that is still buffered (in place), then continue appending
+	os.seekp(3);
+	os.write(data.data() + 3, 100);
+	os.seekp(data.size() - 10);
+	os.write(data.data() + data.size() - 10, 10);
+	os.seekp(0, std::ios_base::end);
+
+	CHECK(os.good());
+	CHECK(osb.Finish());
+	CHECK(osb.GetRawSize() == data.size());
+	return ss.str();
+}
+
+TEST_CASE("ChunkedStreamBuf")
+{
+	Threading::DetectCores();
+	ThreadPool::SetThreadCount(4);
+
+	// each batch holds one chunk per thread; write 16 of them
+	std::vector<char> data(256 * ThreadPool::GetNumThreads() * 16);
+
+	for (size_t i = 0; i < data.size(); i++)
+		data[i] = char((i * 2654435761u) >> 13);
+
+	const std::string file = WriteChunked(data, 256);
+
+	{
+		INFO("round-trip");
+		std::stringstream ss(file, std::ios::in | std::ios::binary);
+		creg::ChunkedInputStreamBuf isb(&ss);
+		std::istream is(&isb);
+
+		REQUIRE(isb.IsValid());
+		CHECK(isb.GetRawSize() == data.size());
+
+		std::vector<char> read(data.size());
+		is.read(read.data(), read.size());
+
+		CHECK(is.gcount() == std::streamsize(data.size()));
+		CHECK(read == data);
+
+		is.seekg(1000);
+		is.read(read.data(), 10);
+		CHECK(std::memcmp(read.data(), data.data() + 1000, 10) == 0);
+	}
+
+	// the index offset is the first field of the trailer
+	std::uint64_t indexOffset = 0;
+	std::memcpy(&indexOffset, file.data() + file.size() - 16, sizeof(indexOffset));
+	REQUIRE(indexOffset < file.size());
+
+	{
+		INFO("huge chunk count");
+		std::string bad = file;
+		std::memset(&bad[indexOffset], 0xFF, 8);
+		bad[indexOffset + 8] = 0x7F;
+
+		std::stringstream ss(bad, std::ios::in | std::ios::binary);
+		creg::ChunkedInputStreamBuf isb(&ss);
+		CHECK(!isb.IsValid());
+	}
+	{
+		INFO("truncated file");
+		const std::string bad = file.substr(0, file.size() / 2) + file.substr(file.size() - 16);
+
+		std::stringstream ss(bad, std::ios::in | std::ios::binary);
+		creg::ChunkedInputStreamBuf isb(&ss);
+		CHECK(!isb.IsValid());
+	}
+
+	ThreadPool::SetThreadCount(0);
+}